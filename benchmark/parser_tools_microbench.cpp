@@ -0,0 +1,417 @@
+// parser_tools_microbench: times the stages behind the parser_tools SQL functions in isolation.
+//
+// Every stage runs over the same corpus (built in, or one query per line from a file) and reports
+// the time and number of heap allocations per query:
+//
+//   parse                  Parser::ParseQuery
+//   walk_*                 an extractor's AST walk over already parsed statements
+//   expression_to_string   ParsedExpression::ToString on every WHERE / HAVING clause, the bulk of
+//                          parse_where's cost
+//   scalar_*               a scalar function end to end, executed on a chunk of queries
+//   write_*                a scalar's result writer alone, on already extracted results
+//
+// usage: parser_tools_microbench [--iterations N] [--csv] [corpus_file]
+
+#include "parser_tools_extension.hpp"
+#include "parse_tables.hpp"
+#include "parse_functions.hpp"
+#include "parse_where.hpp"
+#include "duckdb.hpp"
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/catalog/catalog_entry/scalar_function_catalog_entry.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/parser/parser.hpp"
+#include "duckdb/parser/query_node/select_node.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckdb/planner/expression/bound_reference_expression.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+// Allocation hook
+// ---------------------------------------------------
+// Allocations are counted per thread. On glibc malloc itself is interposed, which also covers
+// libpg_query and DuckDB's own allocators; elsewhere only operator new is counted.
+
+static thread_local uint64_t allocation_count = 0;
+
+static inline void CountAllocation() {
+    allocation_count++;
+}
+
+#if defined(__GLIBC__) && !defined(PARSER_TOOLS_MICROBENCH_NO_MALLOC_HOOK)
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+
+void *malloc(size_t size) {
+    CountAllocation();
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    CountAllocation();
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size) {
+    CountAllocation();
+    return __libc_realloc(pointer, size);
+}
+}
+#else
+void *operator new(size_t size) {
+    CountAllocation();
+    if (auto pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, size_t) noexcept {
+    std::free(pointer);
+}
+#endif
+
+namespace duckdb {
+
+// Corpus
+// ---------------------------------------------------
+
+static const char *BUILTIN_CORPUS[] = {
+    "SELECT * FROM orders",
+    "SELECT id, upper(name) FROM customers WHERE created_at > '2024-01-01' AND status = 'active'",
+    "SELECT c.name, sum(o.total) FROM customers c JOIN orders o ON c.id = o.customer_id "
+    "WHERE o.total BETWEEN 10 AND 100 GROUP BY c.name HAVING sum(o.total) > 1000 ORDER BY 2 DESC",
+    "WITH recent AS (SELECT * FROM events WHERE ts > now() - INTERVAL 1 DAY) "
+    "SELECT kind, count(*) FROM recent GROUP BY kind",
+    "SELECT * FROM (SELECT id, row_number() OVER (PARTITION BY user_id ORDER BY ts) AS rn FROM sessions) s "
+    "WHERE rn = 1",
+    "SELECT a.x, b.y, c.z FROM a JOIN b ON a.id = b.a_id LEFT JOIN c ON b.id = c.b_id "
+    "WHERE a.flag AND coalesce(c.z, 0) < 5",
+    "SELECT lower(email) FROM users WHERE email LIKE '%@example.com' OR email IS NULL",
+    "SELECT date_trunc('month', ts), avg(latency), quantile_cont(latency, 0.99) FROM requests "
+    "WHERE service IN ('api', 'web', 'worker') GROUP BY 1 ORDER BY 1",
+    "SELECT * FROM analytics.page_views pv WHERE pv.url = 'https://example.com' AND pv.ts >= '2024-06-01'",
+    "SELECT CASE WHEN score > 90 THEN 'a' WHEN score > 80 THEN 'b' ELSE 'c' END FROM grades "
+    "WHERE student_id = 42",
+};
+
+static std::vector<std::string> LoadCorpus(const char *path) {
+    std::vector<std::string> corpus;
+    if (!path) {
+        for (auto query : BUILTIN_CORPUS) {
+            corpus.emplace_back(query);
+        }
+        return corpus;
+    }
+    std::ifstream file(path);
+    if (!file) {
+        throw IOException("could not open corpus file %s", std::string(path));
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty()) {
+            corpus.push_back(line);
+        }
+    }
+    return corpus;
+}
+
+// Measurement
+// ---------------------------------------------------
+
+struct StageResult {
+    std::string name;
+    double ns_per_query;
+    double allocations_per_query;
+};
+
+// Runs body (which processes the whole corpus once) for the given number of iterations
+static StageResult Measure(const std::string &name, idx_t iterations, idx_t corpus_size,
+                           const std::function<void()> &body) {
+    // warm up caches and lazily initialized state
+    body();
+
+    auto allocations_before = allocation_count;
+    auto start = std::chrono::steady_clock::now();
+    for (idx_t i = 0; i < iterations; i++) {
+        body();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    auto allocations = allocation_count - allocations_before;
+
+    double queries = (double)iterations * (double)corpus_size;
+    auto ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    return StageResult {name, ns / queries, (double)allocations / queries};
+}
+
+// Parsed corpus, so the walks can be timed without the parser
+struct ParsedCorpus {
+    std::vector<unique_ptr<Parser>> parsers;
+
+    template <class CALLBACK>
+    void ForEachSelectNode(CALLBACK &&callback) const {
+        for (auto &parser : parsers) {
+            for (auto &statement : parser->statements) {
+                if (statement->type != StatementType::SELECT_STATEMENT) {
+                    continue;
+                }
+                auto &select = (SelectStatement &)*statement;
+                if (select.node) {
+                    callback(*select.node);
+                }
+            }
+        }
+    }
+};
+
+// Executes a registered scalar function the way a projection would, on chunks of corpus queries
+class ScalarRunner {
+public:
+    ScalarRunner(ClientContext &context, const std::string &function_name, const std::vector<std::string> &corpus)
+        : context(context) {
+        auto &entry = Catalog::GetEntry<ScalarFunctionCatalogEntry>(context, SYSTEM_CATALOG, DEFAULT_SCHEMA,
+                                                                    function_name);
+        auto function = entry.functions.GetFunctionByArguments(context, {LogicalType::VARCHAR});
+
+        vector<unique_ptr<Expression>> children;
+        children.push_back(make_uniq<BoundReferenceExpression>(LogicalType::VARCHAR, 0));
+        unique_ptr<FunctionData> bind_info;
+        if (function.bind) {
+            bind_info = function.bind(context, function, children);
+        }
+        expression = make_uniq<BoundFunctionExpression>(function.return_type, function, std::move(children),
+                                                        std::move(bind_info));
+        cache = make_uniq<VectorCache>(Allocator::DefaultAllocator(), function.return_type);
+
+        // one chunk per STANDARD_VECTOR_SIZE queries
+        for (idx_t offset = 0; offset < corpus.size(); offset += STANDARD_VECTOR_SIZE) {
+            auto chunk = make_uniq<DataChunk>();
+            chunk->Initialize(Allocator::DefaultAllocator(), {LogicalType::VARCHAR});
+            auto count = MinValue<idx_t>(STANDARD_VECTOR_SIZE, corpus.size() - offset);
+            auto data = FlatVector::GetData<string_t>(chunk->data[0]);
+            for (idx_t i = 0; i < count; i++) {
+                data[i] = StringVector::AddString(chunk->data[0], corpus[offset + i]);
+            }
+            chunk->SetCardinality(count);
+            chunks.push_back(std::move(chunk));
+        }
+    }
+
+    void Run() {
+        ExpressionExecutor executor(context, *expression);
+        Vector result(*cache);
+        for (auto &chunk : chunks) {
+            result.ResetFromCache(*cache);
+            executor.ExecuteExpression(*chunk, result);
+        }
+    }
+
+private:
+    ClientContext &context;
+    unique_ptr<Expression> expression;
+    unique_ptr<VectorCache> cache;
+    std::vector<unique_ptr<DataChunk>> chunks;
+};
+
+// Times a result writer on already extracted results, one result vector per STANDARD_VECTOR_SIZE queries
+template <class RESULT>
+static StageResult MeasureWriter(const std::string &name, idx_t iterations, const LogicalType &type,
+                                 const std::vector<std::vector<RESULT>> &extracted,
+                                 list_entry_t (*write)(Vector &, const std::vector<RESULT> &)) {
+    VectorCache cache(Allocator::DefaultAllocator(), type);
+    Vector result(cache);
+    return Measure(name, iterations, extracted.size(), [&]() {
+        for (idx_t offset = 0; offset < extracted.size(); offset += STANDARD_VECTOR_SIZE) {
+            result.ResetFromCache(cache);
+            auto entries = FlatVector::GetData<list_entry_t>(result);
+            auto count = MinValue<idx_t>(STANDARD_VECTOR_SIZE, extracted.size() - offset);
+            for (idx_t row = 0; row < count; row++) {
+                entries[row] = write(result, extracted[offset + row]);
+            }
+        }
+    });
+}
+
+static LogicalType VarcharStructList(const std::vector<std::string> &names) {
+    child_list_t<LogicalType> children;
+    for (auto &name : names) {
+        children.emplace_back(name, LogicalType::VARCHAR);
+    }
+    return LogicalType::LIST(LogicalType::STRUCT(std::move(children)));
+}
+
+static void PrintResults(const std::vector<StageResult> &results, bool csv) {
+    if (csv) {
+        std::printf("stage,ns_per_query,allocations_per_query\n");
+        for (auto &result : results) {
+            std::printf("%s,%.1f,%.2f\n", result.name.c_str(), result.ns_per_query, result.allocations_per_query);
+        }
+        return;
+    }
+    std::printf("%-32s %14s %14s\n", "stage", "ns/query", "allocs/query");
+    for (auto &result : results) {
+        std::printf("%-32s %14.1f %14.2f\n", result.name.c_str(), result.ns_per_query, result.allocations_per_query);
+    }
+}
+
+static int RunMicrobench(int argc, char **argv) {
+    idx_t iterations = 1000;
+    bool csv = false;
+    const char *corpus_path = nullptr;
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        if (argument == "--iterations" && i + 1 < argc) {
+            iterations = std::stoull(argv[++i]);
+        } else if (argument == "--csv") {
+            csv = true;
+        } else if (argument.rfind("--", 0) == 0) {
+            std::cerr << "usage: parser_tools_microbench [--iterations N] [--csv] [corpus_file]" << std::endl;
+            return 1;
+        } else {
+            corpus_path = argv[i];
+        }
+    }
+
+    auto corpus = LoadCorpus(corpus_path);
+    if (corpus.empty()) {
+        std::cerr << "empty corpus" << std::endl;
+        return 1;
+    }
+    auto n = corpus.size();
+    std::vector<StageResult> results;
+
+    // parsing
+    results.push_back(Measure("parse", iterations, n, [&]() {
+        for (auto &query : corpus) {
+            Parser parser;
+            parser.ParseQuery(query);
+        }
+    }));
+
+    ParsedCorpus parsed;
+    for (auto &query : corpus) {
+        auto parser = make_uniq<Parser>();
+        parser->ParseQuery(query);
+        parsed.parsers.push_back(std::move(parser));
+    }
+
+    // AST walks
+    results.push_back(Measure("walk_tables", iterations, n, [&]() {
+        parsed.ForEachSelectNode([](const QueryNode &node) {
+            std::vector<TableRefResult> tables;
+            ExtractTablesFromQueryNode(node, tables);
+        });
+    }));
+    results.push_back(Measure("walk_functions", iterations, n, [&]() {
+        parsed.ForEachSelectNode([](const QueryNode &node) {
+            std::vector<FunctionResult> functions;
+            ExtractFunctionsFromQueryNode(node, functions);
+        });
+    }));
+    results.push_back(Measure("walk_where", iterations, n, [&]() {
+        parsed.ForEachSelectNode([](const QueryNode &node) {
+            std::vector<WhereConditionResult> conditions;
+            ExtractWhereConditionsFromQueryNode(node, conditions);
+        });
+    }));
+    results.push_back(Measure("walk_where_detailed", iterations, n, [&]() {
+        parsed.ForEachSelectNode([](const QueryNode &node) {
+            std::vector<DetailedWhereConditionResult> conditions;
+            ExtractDetailedWhereConditionsFromQueryNode(node, conditions);
+        });
+    }));
+    results.push_back(Measure("expression_to_string", iterations, n, [&]() {
+        parsed.ForEachSelectNode([](const QueryNode &node) {
+            if (node.type != QueryNodeType::SELECT_NODE) {
+                return;
+            }
+            auto &select = (SelectNode &)node;
+            if (select.where_clause) {
+                select.where_clause->ToString();
+            }
+            if (select.having) {
+                select.having->ToString();
+            }
+        });
+    }));
+
+    // result writers alone, on results extracted up front
+    std::vector<std::vector<TableRefResult>> extracted_tables(n);
+    std::vector<std::vector<FunctionResult>> extracted_functions(n);
+    std::vector<std::vector<WhereConditionResult>> extracted_conditions(n);
+    for (idx_t i = 0; i < n; i++) {
+        ExtractTablesFromSQL(corpus[i], extracted_tables[i]);
+        ExtractFunctionsFromSQL(corpus[i], extracted_functions[i]);
+        ExtractWhereConditionsFromSQL(corpus[i], extracted_conditions[i]);
+    }
+    results.push_back(MeasureWriter("write_parse_table_names", iterations, LogicalType::LIST(LogicalType::VARCHAR),
+                                    extracted_tables, WriteTableNameList));
+    results.push_back(MeasureWriter("write_parse_tables", iterations,
+                                    VarcharStructList({"schema", "table", "context"}), extracted_tables,
+                                    WriteTableStructList));
+    results.push_back(MeasureWriter("write_parse_function_names", iterations,
+                                    LogicalType::LIST(LogicalType::VARCHAR), extracted_functions,
+                                    WriteFunctionNameList));
+    results.push_back(MeasureWriter("write_parse_functions", iterations,
+                                    VarcharStructList({"function_name", "schema", "context"}), extracted_functions,
+                                    WriteFunctionStructList));
+    results.push_back(MeasureWriter("write_parse_where", iterations,
+                                    VarcharStructList({"condition", "table_name", "context"}), extracted_conditions,
+                                    WriteWhereConditionList));
+
+    // scalar functions end to end
+    DuckDB db(nullptr);
+    db.LoadStaticExtension<ParserToolsExtension>();
+    Connection con(db);
+    con.BeginTransaction();
+
+    const char *scalars[] = {"parse_table_names", "parse_tables", "parse_function_names", "parse_functions",
+                             "parse_where"};
+    for (auto function_name : scalars) {
+        ScalarRunner runner(*con.context, function_name, corpus);
+        results.push_back(
+            Measure(std::string("scalar_") + function_name, iterations, n, [&]() { runner.Run(); }));
+    }
+    con.Rollback();
+
+    PrintResults(results, csv);
+    return 0;
+}
+
+} // namespace duckdb
+
+int main(int argc, char **argv) {
+    try {
+        return duckdb::RunMicrobench(argc, argv);
+    } catch (std::exception &ex) {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+}
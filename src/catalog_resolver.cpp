@@ -0,0 +1,120 @@
+#include "catalog_resolver.hpp"
+#include "duckdb.hpp"
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/catalog/catalog_entry.hpp"
+#include "duckdb/catalog/catalog_entry/schema_catalog_entry.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/planner/binder.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+
+namespace duckdb {
+
+static const char *ObjectTypeName(CatalogType type) {
+    switch (type) {
+        case CatalogType::TABLE_ENTRY: return "table";
+        case CatalogType::VIEW_ENTRY: return "view";
+        case CatalogType::SCALAR_FUNCTION_ENTRY: return "scalar_function";
+        case CatalogType::AGGREGATE_FUNCTION_ENTRY: return "aggregate_function";
+        case CatalogType::MACRO_ENTRY: return "macro";
+        case CatalogType::TABLE_FUNCTION_ENTRY: return "table_function";
+        case CatalogType::TABLE_MACRO_ENTRY: return "table_macro";
+        default: return "unknown";
+    }
+}
+
+static optional_ptr<CatalogEntry> LookupEntry(ClientContext &context, CatalogType type, const std::string &catalog,
+                                              const std::string &schema, const std::string &name) {
+    try {
+        return Catalog::GetEntry(context, type, catalog, schema, name, OnEntryNotFound::RETURN_NULL);
+    } catch (const CatalogException &ex) {
+        // unknown catalog or schema
+        return nullptr;
+    } catch (const BinderException &ex) {
+        return nullptr;
+    }
+}
+
+static optional_ptr<CatalogEntry> LookupName(ClientContext &context, ResolveKind kind, std::string catalog,
+                                             std::string schema, const std::string &name) {
+    // "a.b" may be schema.name or catalog.name, the same way the binder decides it
+    Binder::BindSchemaOrCatalog(context, catalog, schema);
+
+    if (kind == ResolveKind::Table) {
+        // tables and views share a catalog set, a table lookup finds both
+        return LookupEntry(context, CatalogType::TABLE_ENTRY, catalog, schema, name);
+    }
+    if (kind == ResolveKind::TableFunction) {
+        return LookupEntry(context, CatalogType::TABLE_FUNCTION_ENTRY, catalog, schema, name);
+    }
+    // scalar functions, aggregates and macros share a catalog set, as do table functions and table macros
+    auto entry = LookupEntry(context, CatalogType::SCALAR_FUNCTION_ENTRY, catalog, schema, name);
+    if (!entry) {
+        entry = LookupEntry(context, CatalogType::TABLE_FUNCTION_ENTRY, catalog, schema, name);
+    }
+    return entry;
+}
+
+const ResolvedName &CatalogResolver::Resolve(ClientContext &context, ResolveKind kind, const std::string &catalog,
+                                             const std::string &schema, const std::string &name) {
+    std::string key;
+    key.reserve(catalog.size() + schema.size() + name.size() + 4);
+    key += (char)('0' + (int)kind);
+    key += catalog;
+    key += '\0';
+    key += schema;
+    key += '\0';
+    key += name;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto cached = cache.find(key);
+        if (cached != cache.end()) {
+            return cached->second;
+        }
+    }
+
+    // probe outside of the lock, two threads racing on the same name both get the same answer
+    ResolvedName resolved;
+    auto entry = LookupName(context, kind, catalog, schema, name);
+    if (entry) {
+        resolved.found = true;
+        resolved.catalog = entry->ParentCatalog().GetName();
+        resolved.schema = entry->ParentSchema().name;
+        resolved.name = entry->name;
+        resolved.object_type = ObjectTypeName(entry->type);
+    } else {
+        resolved.found = false;
+        resolved.schema = schema.empty() ? "main" : schema;
+        resolved.name = name;
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+    return cache.emplace(std::move(key), std::move(resolved)).first->second;
+}
+
+unique_ptr<FunctionData> CatalogResolverBindData::Copy() const {
+    auto copy = make_uniq<CatalogResolverBindData>();
+    copy->resolver = resolver;
+    return std::move(copy);
+}
+
+bool CatalogResolverBindData::Equals(const FunctionData &other) const {
+    return true;
+}
+
+unique_ptr<FunctionData> CatalogResolverBind(ClientContext &context, ScalarFunction &bound_function,
+                                             vector<unique_ptr<Expression>> &arguments) {
+    auto result = make_uniq<CatalogResolverBindData>();
+    result->resolver = make_shared_ptr<CatalogResolver>();
+    return std::move(result);
+}
+
+CatalogResolver &GetCatalogResolver(ExpressionState &state) {
+    auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+    auto &bind_data = func_expr.bind_info->Cast<CatalogResolverBindData>();
+    return *bind_data.resolver;
+}
+
+} // namespace duckdb
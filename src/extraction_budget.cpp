@@ -0,0 +1,129 @@
+#include "parser_tools_limits.hpp"
+#include "sql_scanner.hpp"
+#include "duckdb.hpp"
+#include "duckdb/common/string_util.hpp"
+
+namespace duckdb {
+
+thread_local ExtractionBudget *ExtractionBudget::current = nullptr;
+
+// the clock is only read every DEADLINE_CHECK_INTERVAL nodes to keep Tick() cheap
+static constexpr idx_t DEADLINE_CHECK_INTERVAL = 256;
+
+// A generous bound on the tokens behind one AST node (keywords, punctuation, qualified names), so
+// that the pre-parse check never turns away a query the node limit itself would accept
+static constexpr idx_t MAX_TOKENS_PER_AST_NODE = 8;
+
+ExtractionBudget::ExtractionBudget(const ParserToolsLimits &limits) : limits(limits), previous(current) {
+    if (limits.max_parse_ms > 0) {
+        start = std::chrono::steady_clock::now();
+    }
+    current = this;
+}
+
+ExtractionBudget::~ExtractionBudget() {
+    current = previous;
+}
+
+bool ExtractionBudget::Exceed(std::string exceeded_reason) {
+    if (!exceeded) {
+        exceeded = true;
+        reason = std::move(exceeded_reason);
+    }
+    return false;
+}
+
+bool ExtractionBudget::DeadlineReached() {
+    if (limits.max_parse_ms == 0) {
+        return false;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    return (idx_t)elapsed.count() > limits.max_parse_ms;
+}
+
+bool ExtractionBudget::AllowInputSize(idx_t sql_bytes) {
+    auto budget = current;
+    if (!budget || budget->limits.max_sql_bytes == 0 || sql_bytes <= budget->limits.max_sql_bytes) {
+        return true;
+    }
+    return budget->Exceed(StringUtil::Format("SQL input of %llu bytes exceeds parser_tools_max_sql_bytes (%llu)",
+                                             sql_bytes, budget->limits.max_sql_bytes));
+}
+
+bool ExtractionBudget::AllowInput(const std::string &sql) {
+    if (!AllowInputSize(sql.size())) {
+        return false;
+    }
+    auto budget = current;
+    if (!budget) {
+        return true;
+    }
+    auto &limits = budget->limits;
+    if (limits.max_ast_nodes > 0) {
+        // the parser cannot be interrupted, so inputs that cannot stay under the node limit are
+        // turned away before it runs. The scan stops as soon as the token bound is passed.
+        auto max_tokens = limits.max_ast_nodes * MAX_TOKENS_PER_AST_NODE;
+        SqlScanner scanner(sql);
+        SqlToken token;
+        idx_t tokens = 0;
+        while (scanner.Next(token)) {
+            if (++tokens > max_tokens) {
+                return budget->Exceed(StringUtil::Format(
+                    "query of more than %llu tokens exceeds parser_tools_max_ast_nodes (%llu)", max_tokens,
+                    limits.max_ast_nodes));
+            }
+        }
+    }
+    return true;
+}
+
+bool ExtractionBudget::Tick() {
+    auto budget = current;
+    if (!budget) {
+        return true;
+    }
+    if (budget->exceeded) {
+        return false;
+    }
+    budget->nodes++;
+    if (budget->limits.max_ast_nodes > 0 && budget->nodes > budget->limits.max_ast_nodes) {
+        return budget->Exceed(StringUtil::Format("query exceeds parser_tools_max_ast_nodes (%llu)",
+                                                 budget->limits.max_ast_nodes));
+    }
+    if (budget->nodes % DEADLINE_CHECK_INTERVAL == 0 && budget->DeadlineReached()) {
+        return budget->Exceed(StringUtil::Format("query exceeds parser_tools_max_parse_ms (%llu)",
+                                                 budget->limits.max_parse_ms));
+    }
+    return true;
+}
+
+bool ExtractionBudget::CheckDeadline() {
+    auto budget = current;
+    if (!budget) {
+        return true;
+    }
+    if (budget->exceeded) {
+        return false;
+    }
+    if (budget->DeadlineReached()) {
+        return budget->Exceed(StringUtil::Format("query exceeds parser_tools_max_parse_ms (%llu)",
+                                                 budget->limits.max_parse_ms));
+    }
+    return true;
+}
+
+bool ExtractionBudget::KeepResult(const char *function_name) const {
+    if (!exceeded) {
+        return true;
+    }
+    switch (limits.on_limit) {
+        case LimitBehavior::Error:
+            throw InvalidInputException("%s: %s", std::string(function_name), reason);
+        case LimitBehavior::Truncate:
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // namespace duckdb
@@ -0,0 +1,349 @@
+#include "from_scope.hpp"
+#include "parser_tools_limits.hpp"
+#include "duckdb.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/parser/parsed_expression_iterator.hpp"
+#include "duckdb/parser/result_modifier.hpp"
+#include "duckdb/parser/expression/star_expression.hpp"
+#include "duckdb/parser/expression/subquery_expression.hpp"
+#include "duckdb/parser/query_node/set_operation_node.hpp"
+#include "duckdb/parser/query_node/recursive_cte_node.hpp"
+#include "duckdb/parser/query_node/cte_node.hpp"
+#include "duckdb/parser/tableref/basetableref.hpp"
+#include "duckdb/parser/tableref/joinref.hpp"
+#include "duckdb/parser/tableref/subqueryref.hpp"
+#include "duckdb/parser/tableref/table_function_ref.hpp"
+#include <algorithm>
+
+namespace duckdb {
+
+// Derived tables and CTEs are followed through their select lists at most this deep
+static constexpr idx_t MAX_SCOPE_DEPTH = 16;
+
+FromScope::FromScope(const SelectNode &node, std::vector<const CommonTableExpressionMap *> outer_ctes)
+    : ctes(std::move(outer_ctes)) {
+    ctes.push_back(&node.cte_map);
+    if (node.from_table) {
+        AddBindings(*node.from_table);
+    }
+}
+
+std::string FromScope::ResolveColumn(const std::string &qualifier, const std::string &column, idx_t depth) const {
+    const FromBinding *binding = nullptr;
+    if (!qualifier.empty()) {
+        for (auto &candidate : bindings) {
+            if (StringUtil::CIEquals(candidate.name, qualifier)) {
+                binding = &candidate;
+                break;
+            }
+        }
+    } else if (bindings.size() == 1) {
+        binding = &bindings[0];
+    }
+    if (!binding) {
+        return "";
+    }
+    if (!binding->query) {
+        return binding->table;
+    }
+    return ResolveOutputColumn(*binding->query, column, depth + 1);
+}
+
+std::string FromScope::ResolveColumn(const ColumnRefExpression &column_ref) const {
+    return ResolveColumn(column_ref.IsQualified() ? column_ref.GetTableName() : "", column_ref.GetColumnName());
+}
+
+static const ColumnRefExpression *FindFirstColumn(const ParsedExpression &expr) {
+    if (expr.GetExpressionClass() == ExpressionClass::COLUMN_REF) {
+        return &(const ColumnRefExpression &)expr;
+    }
+    if (expr.GetExpressionClass() == ExpressionClass::SUBQUERY) {
+        // columns inside a subquery belong to its own FROM clause
+        auto &subquery = (SubqueryExpression &)expr;
+        return subquery.child ? FindFirstColumn(*subquery.child) : nullptr;
+    }
+    const ColumnRefExpression *result = nullptr;
+    ParsedExpressionIterator::EnumerateChildren(expr, [&](const ParsedExpression &child) {
+        if (!result) {
+            result = FindFirstColumn(child);
+        }
+    });
+    return result;
+}
+
+std::string FromScope::Attribute(const ParsedExpression &expr) const {
+    auto column_ref = FindFirstColumn(expr);
+    if (column_ref) {
+        return ResolveColumn(*column_ref);
+    }
+    if (bindings.size() == 1 && !bindings[0].query) {
+        return bindings[0].table;
+    }
+    return "";
+}
+
+static void SourceTablesOfQuery(const QueryNode &node, const std::vector<const CommonTableExpressionMap *> &ctes,
+                                std::vector<std::string> &tables, idx_t depth) {
+    if (depth > MAX_SCOPE_DEPTH) {
+        return;
+    }
+    if (node.type == QueryNodeType::SELECT_NODE) {
+        FromScope inner((SelectNode &)node, ctes);
+        inner.SourceTables(tables, depth);
+        return;
+    }
+    auto inner_ctes = ctes;
+    inner_ctes.push_back(&node.cte_map);
+    switch (node.type) {
+        case QueryNodeType::SET_OPERATION_NODE: {
+            auto &setop_node = (SetOperationNode &)node;
+            SourceTablesOfQuery(*setop_node.left, inner_ctes, tables, depth + 1);
+            SourceTablesOfQuery(*setop_node.right, inner_ctes, tables, depth + 1);
+            break;
+        }
+        case QueryNodeType::RECURSIVE_CTE_NODE: {
+            auto &cte_node = (RecursiveCTENode &)node;
+            SourceTablesOfQuery(*cte_node.left, inner_ctes, tables, depth + 1);
+            SourceTablesOfQuery(*cte_node.right, inner_ctes, tables, depth + 1);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void FromScope::SourceTables(std::vector<std::string> &tables, idx_t depth) const {
+    for (auto &binding : bindings) {
+        if (binding.query) {
+            SourceTablesOfQuery(*binding.query, ctes, tables, depth + 1);
+        } else if (!binding.table.empty() &&
+                   std::find(tables.begin(), tables.end(), binding.table) == tables.end()) {
+            tables.push_back(binding.table);
+        }
+    }
+}
+
+void QueryNodeSourceTables(const QueryNode &node, const std::vector<const CommonTableExpressionMap *> &ctes,
+                           std::vector<std::string> &tables) {
+    SourceTablesOfQuery(node, ctes, tables, 0);
+}
+
+void FromScope::AddBindings(const TableRef &ref) {
+    switch (ref.type) {
+        case TableReferenceType::BASE_TABLE: {
+            auto &base = (BaseTableRef &)ref;
+            auto name = base.alias.empty() ? base.table_name : base.alias;
+            auto cte = base.schema_name.empty() && base.catalog_name.empty() ? FindCTE(base.table_name) : nullptr;
+            if (cte && cte->query && cte->query->node) {
+                bindings.push_back(FromBinding{name, "", cte->query->node.get()});
+            } else {
+                bindings.push_back(FromBinding{name, base.table_name, nullptr});
+            }
+            break;
+        }
+        case TableReferenceType::JOIN: {
+            auto &join = (JoinRef &)ref;
+            AddBindings(*join.left);
+            AddBindings(*join.right);
+            break;
+        }
+        case TableReferenceType::SUBQUERY: {
+            auto &subquery = (SubqueryRef &)ref;
+            if (subquery.subquery && subquery.subquery->node) {
+                bindings.push_back(FromBinding{subquery.alias, "", subquery.subquery->node.get()});
+            }
+            break;
+        }
+        case TableReferenceType::TABLE_FUNCTION:
+            // its columns exist, but do not belong to any table
+            bindings.push_back(FromBinding{ref.alias, "", nullptr});
+            break;
+        default:
+            break;
+    }
+}
+
+const CommonTableExpressionInfo *FromScope::FindCTE(const std::string &name) const {
+    for (auto it = ctes.rbegin(); it != ctes.rend(); ++it) {
+        auto entry = (*it)->map.find(name);
+        if (entry != (*it)->map.end()) {
+            return entry->second.get();
+        }
+    }
+    return nullptr;
+}
+
+std::string FromScope::ResolveOutputColumn(const QueryNode &node, const std::string &column, idx_t depth) const {
+    // set operations combine several inputs, recursive CTEs reference themselves
+    if (depth > MAX_SCOPE_DEPTH || node.type != QueryNodeType::SELECT_NODE) {
+        return "";
+    }
+    auto &select_node = (SelectNode &)node;
+    FromScope inner(select_node, ctes);
+
+    for (auto &expr : select_node.select_list) {
+        auto expression_class = expr->GetExpressionClass();
+        if (!expr->alias.empty()) {
+            if (!StringUtil::CIEquals(expr->alias, column)) {
+                continue;
+            }
+            if (expression_class != ExpressionClass::COLUMN_REF) {
+                return "";
+            }
+            auto &column_ref = (ColumnRefExpression &)*expr;
+            return inner.ResolveColumn(column_ref.IsQualified() ? column_ref.GetTableName() : "",
+                                       column_ref.GetColumnName(), depth);
+        }
+        if (expression_class == ExpressionClass::COLUMN_REF) {
+            auto &column_ref = (ColumnRefExpression &)*expr;
+            if (StringUtil::CIEquals(column_ref.GetColumnName(), column)) {
+                return inner.ResolveColumn(column_ref.IsQualified() ? column_ref.GetTableName() : "",
+                                           column_ref.GetColumnName(), depth);
+            }
+        } else if (expression_class == ExpressionClass::STAR) {
+            auto &star = (StarExpression &)*expr;
+            auto table = inner.ResolveColumn(star.relation_name, column, depth);
+            if (!table.empty()) {
+                return table;
+            }
+        }
+    }
+    return "";
+}
+
+// Query node enumeration
+// ---------------------------------------------------
+
+static void EnumerateQueryNodesInExpression(const ParsedExpression &expr, const QueryNodeCallback &callback,
+                                            const std::vector<const CommonTableExpressionMap *> &ctes) {
+    if (!ExtractionBudget::Tick()) {
+        return;
+    }
+    if (expr.GetExpressionClass() == ExpressionClass::SUBQUERY) {
+        auto &subquery = (SubqueryExpression &)expr;
+        if (subquery.subquery && subquery.subquery->node) {
+            EnumerateQueryNodes(*subquery.subquery->node, callback, ctes);
+        }
+    }
+    ParsedExpressionIterator::EnumerateChildren(expr, [&](const ParsedExpression &child) {
+        EnumerateQueryNodesInExpression(child, callback, ctes);
+    });
+}
+
+static void EnumerateQueryNodesInExpression(const unique_ptr<ParsedExpression> &expr,
+                                            const QueryNodeCallback &callback,
+                                            const std::vector<const CommonTableExpressionMap *> &ctes) {
+    if (expr) {
+        EnumerateQueryNodesInExpression(*expr, callback, ctes);
+    }
+}
+
+static void EnumerateQueryNodesInTableRef(const TableRef &ref, const QueryNodeCallback &callback,
+                                          const std::vector<const CommonTableExpressionMap *> &ctes) {
+    switch (ref.type) {
+        case TableReferenceType::JOIN: {
+            auto &join = (JoinRef &)ref;
+            EnumerateQueryNodesInTableRef(*join.left, callback, ctes);
+            EnumerateQueryNodesInTableRef(*join.right, callback, ctes);
+            EnumerateQueryNodesInExpression(join.condition, callback, ctes);
+            break;
+        }
+        case TableReferenceType::SUBQUERY: {
+            auto &subquery = (SubqueryRef &)ref;
+            if (subquery.subquery && subquery.subquery->node) {
+                EnumerateQueryNodes(*subquery.subquery->node, callback, ctes);
+            }
+            break;
+        }
+        case TableReferenceType::TABLE_FUNCTION: {
+            auto &table_function = (TableFunctionRef &)ref;
+            EnumerateQueryNodesInExpression(table_function.function, callback, ctes);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void EnumerateQueryNodes(const QueryNode &node, const QueryNodeCallback &callback,
+                         std::vector<const CommonTableExpressionMap *> ctes) {
+    if (!ExtractionBudget::Tick()) {
+        return;
+    }
+    // the node itself is given the outer CTEs only, FromScope adds its own
+    auto outer_ctes = ctes;
+    ctes.push_back(&node.cte_map);
+
+    // CTEs first, they are evaluated before the node that defines them
+    for (auto &cte : node.cte_map.map) {
+        if (cte.second && cte.second->query && cte.second->query->node) {
+            EnumerateQueryNodes(*cte.second->query->node, callback, ctes);
+        }
+    }
+
+    callback(node, outer_ctes);
+
+    switch (node.type) {
+        case QueryNodeType::SELECT_NODE: {
+            auto &select_node = (SelectNode &)node;
+            if (select_node.from_table) {
+                EnumerateQueryNodesInTableRef(*select_node.from_table, callback, ctes);
+            }
+            for (auto &expr : select_node.select_list) {
+                EnumerateQueryNodesInExpression(expr, callback, ctes);
+            }
+            EnumerateQueryNodesInExpression(select_node.where_clause, callback, ctes);
+            for (auto &expr : select_node.groups.group_expressions) {
+                EnumerateQueryNodesInExpression(expr, callback, ctes);
+            }
+            EnumerateQueryNodesInExpression(select_node.having, callback, ctes);
+            EnumerateQueryNodesInExpression(select_node.qualify, callback, ctes);
+            break;
+        }
+        case QueryNodeType::SET_OPERATION_NODE: {
+            auto &setop_node = (SetOperationNode &)node;
+            EnumerateQueryNodes(*setop_node.left, callback, ctes);
+            EnumerateQueryNodes(*setop_node.right, callback, ctes);
+            break;
+        }
+        case QueryNodeType::RECURSIVE_CTE_NODE: {
+            auto &cte_node = (RecursiveCTENode &)node;
+            EnumerateQueryNodes(*cte_node.left, callback, ctes);
+            EnumerateQueryNodes(*cte_node.right, callback, ctes);
+            break;
+        }
+        case QueryNodeType::CTE_NODE: {
+            // the definition is also in the cte_map of the node
+            auto &cte_node = (CTENode &)node;
+            if (cte_node.child) {
+                EnumerateQueryNodes(*cte_node.child, callback, ctes);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    for (auto &modifier : node.modifiers) {
+        if (modifier->type == ResultModifierType::ORDER_MODIFIER) {
+            auto &order_modifier = (OrderModifier &)*modifier;
+            for (auto &order : order_modifier.orders) {
+                EnumerateQueryNodesInExpression(order.expression, callback, ctes);
+            }
+        }
+    }
+}
+
+void EnumerateSelectNodes(const QueryNode &node, const SelectNodeCallback &callback,
+                          std::vector<const CommonTableExpressionMap *> ctes) {
+    EnumerateQueryNodes(
+        node,
+        [&](const QueryNode &query_node, const std::vector<const CommonTableExpressionMap *> &outer_ctes) {
+            if (query_node.type == QueryNodeType::SELECT_NODE) {
+                callback((SelectNode &)query_node, outer_ctes);
+            }
+        },
+        std::move(ctes));
+}
+
+} // namespace duckdb
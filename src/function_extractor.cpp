@@ -0,0 +1,216 @@
+#include "parse_functions.hpp"
+#include "parser_tools_limits.hpp"
+#include "sql_scanner.hpp"
+#include "duckdb.hpp"
+#include "duckdb/parser/parser.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+#include "duckdb/parser/query_node/select_node.hpp"
+#include "duckdb/parser/expression/function_expression.hpp"
+#include "duckdb/parser/expression/window_expression.hpp"
+#include "duckdb/parser/parsed_expression_iterator.hpp"
+#include "duckdb/parser/result_modifier.hpp"
+
+namespace duckdb {
+
+enum class FunctionContext {
+	Select,
+	Where,
+	Having,
+	OrderBy,
+	GroupBy,
+	Join,
+	WindowFunction,
+	Nested
+};
+
+inline const char *ToString(FunctionContext context) {
+	switch (context) {
+		case FunctionContext::Select: return "select";
+		case FunctionContext::Where: return "where";
+		case FunctionContext::Having: return "having";
+		case FunctionContext::OrderBy: return "order_by";
+		case FunctionContext::GroupBy: return "group_by";
+		case FunctionContext::Join: return "join";
+		case FunctionContext::WindowFunction: return "window";
+		case FunctionContext::Nested: return "nested";
+		default: return "unknown";
+	}
+}
+
+class FunctionExtractor {
+public:
+	static void ExtractFromExpression(const ParsedExpression &expr, 
+																					std::vector<FunctionResult> &results,
+																					FunctionContext context = FunctionContext::Select) {
+		if (!ExtractionBudget::Tick()) {
+			return;
+		}
+
+		if (expr.expression_class == ExpressionClass::FUNCTION) {
+			auto &func = (FunctionExpression &)expr;
+			results.push_back(FunctionResult{
+				func.function_name,
+				func.schema.empty() ? "main" : func.schema,
+				ToString(context),
+				func.catalog,
+				func.schema
+			});
+			
+			// For nested function calls within this function, mark as nested
+			ParsedExpressionIterator::EnumerateChildren(expr, [&](const ParsedExpression &child) {
+				ExtractFromExpression(child, results, FunctionContext::Nested);
+			});
+		} else if (expr.expression_class == ExpressionClass::WINDOW) {
+			auto &window_expr = (WindowExpression &)expr;
+			results.push_back(FunctionResult{
+				window_expr.function_name,
+				window_expr.schema.empty() ? "main" : window_expr.schema,
+				ToString(context),
+				window_expr.catalog,
+				window_expr.schema
+			});
+			
+			// Extract functions from window function arguments
+			for (const auto &child : window_expr.children) {
+				if (child) {
+					ExtractFromExpression(*child, results, FunctionContext::Nested);
+				}
+			}
+			
+			// Extract functions from PARTITION BY expressions
+			for (const auto &partition : window_expr.partitions) {
+				if (partition) {
+					ExtractFromExpression(*partition, results, FunctionContext::Nested);
+				}
+			}
+			
+			// Extract functions from ORDER BY expressions
+			for (const auto &order : window_expr.orders) {
+				if (order.expression) {
+					ExtractFromExpression(*order.expression, results, FunctionContext::Nested);
+				}
+			}
+			
+			// Extract functions from argument ordering expressions
+			for (const auto &arg_order : window_expr.arg_orders) {
+				if (arg_order.expression) {
+					ExtractFromExpression(*arg_order.expression, results, FunctionContext::Nested);
+				}
+			}
+			
+			// Extract functions from frame expressions
+			if (window_expr.start_expr) {
+				ExtractFromExpression(*window_expr.start_expr, results, FunctionContext::Nested);
+			}
+			if (window_expr.end_expr) {
+				ExtractFromExpression(*window_expr.end_expr, results, FunctionContext::Nested);
+			}
+			if (window_expr.offset_expr) {
+				ExtractFromExpression(*window_expr.offset_expr, results, FunctionContext::Nested);
+			}
+			if (window_expr.default_expr) {
+				ExtractFromExpression(*window_expr.default_expr, results, FunctionContext::Nested);
+			}
+			
+			// Extract functions from filter expression
+			if (window_expr.filter_expr) {
+				ExtractFromExpression(*window_expr.filter_expr, results, FunctionContext::Nested);
+			}
+		} else {
+			// For non-function expressions, preserve the current context
+			ParsedExpressionIterator::EnumerateChildren(expr, [&](const ParsedExpression &child) {
+				ExtractFromExpression(child, results, context);
+			});
+		}
+	}
+
+	static void ExtractFromExpressionList(const vector<unique_ptr<ParsedExpression>> &expressions,
+																								std::vector<FunctionResult> &results,
+																								FunctionContext context) {
+		for (const auto &expr : expressions) {
+			if (expr) {
+				ExtractFromExpression(*expr, results, context);
+			}
+		}
+	}
+};
+
+
+void ExtractFunctionsFromQueryNode(const QueryNode &node, std::vector<FunctionResult> &results) {
+	if (!ExtractionBudget::Tick()) {
+		return;
+	}
+
+	if (node.type == QueryNodeType::SELECT_NODE) {
+		auto &select_node = (SelectNode &)node;
+
+		// Extract from CTEs first (to match expected order in tests)
+		for (const auto &cte : select_node.cte_map.map) {
+			if (cte.second && cte.second->query && cte.second->query->node) {
+				ExtractFunctionsFromQueryNode(*cte.second->query->node, results);
+			}
+		}
+
+		// Extract from SELECT list
+		FunctionExtractor::ExtractFromExpressionList(select_node.select_list, results, FunctionContext::Select);
+
+		// Extract from WHERE clause
+		if (select_node.where_clause) {
+			FunctionExtractor::ExtractFromExpression(*select_node.where_clause, results, FunctionContext::Where);
+		}
+
+		// Extract from GROUP BY clause
+		FunctionExtractor::ExtractFromExpressionList(select_node.groups.group_expressions, results, FunctionContext::GroupBy);
+
+		// Extract from HAVING clause
+		if (select_node.having) {
+			FunctionExtractor::ExtractFromExpression(*select_node.having, results, FunctionContext::Having);
+		}
+
+		// Extract from ORDER BY clause
+		for (const auto &modifier : select_node.modifiers) {
+			if (modifier->type == ResultModifierType::ORDER_MODIFIER) {
+				auto &order_modifier = (OrderModifier &)*modifier;
+				for (const auto &order : order_modifier.orders) {
+					if (order.expression) {
+						FunctionExtractor::ExtractFromExpression(*order.expression, results, FunctionContext::OrderBy);
+					}
+				}
+			}
+		}
+	}
+}
+
+void ExtractFunctionsFromSQL(const std::string &sql, std::vector<FunctionResult> &results) {
+	if (!ExtractionBudget::AllowInput(sql)) {
+		return;
+	}
+
+	// bulk INSERT ... VALUES and long IN lists are compacted first, their literals reference nothing
+	std::string compacted;
+	bool use_compacted = sql.size() >= LITERAL_FAST_PATH_MIN_BYTES && CompactLiteralLists(sql, compacted);
+
+	Parser parser;
+
+	try {
+		parser.ParseQuery(use_compacted ? compacted : sql);
+	} catch (const ParserException &ex) {
+		// swallow parser exceptions to make this function more robust. is_parsable can be used if needed
+		return;
+	}
+
+	if (!ExtractionBudget::CheckDeadline()) {
+		return;
+	}
+
+	for (auto &stmt : parser.statements) {
+		if (stmt->type == StatementType::SELECT_STATEMENT) {
+			auto &select_stmt = (SelectStatement &)*stmt;
+			if (select_stmt.node) {
+				ExtractFunctionsFromQueryNode(*select_stmt.node, results);
+			}
+		}
+	}
+}
+
+} // namespace duckdb
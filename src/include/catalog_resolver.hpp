@@ -0,0 +1,78 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/function/scalar_function.hpp"
+#include "parse_tables.hpp"
+#include "parse_functions.hpp"
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace duckdb {
+
+// Forward declarations
+class ClientContext;
+
+/**
+ * What kind of catalog object a name refers to.
+ */
+enum class ResolveKind {
+    Table,        // tables and views
+    Function,     // scalar, aggregate and table functions, and macros
+    TableFunction // table functions and table macros only
+};
+
+/**
+ * A name as it was found in the catalog. found is false if no entry matched, in which case only
+ * the written schema (or "main") is known.
+ */
+struct ResolvedName {
+    bool found;
+    std::string catalog;
+    std::string schema;
+    std::string name;
+    std::string object_type; // table, view, scalar_function, aggregate_function, macro, table_function, table_macro
+};
+
+/**
+ * Resolves names against the catalog and search path of a client context.
+ *
+ * Lookups are memoized for the lifetime of the resolver, so a resolver shared across all rows of a
+ * scan probes the catalog once per distinct name. Safe to share between threads.
+ */
+class CatalogResolver {
+public:
+    // catalog and schema are as written in the query, empty if the name is unqualified
+    const ResolvedName &Resolve(ClientContext &context, ResolveKind kind, const std::string &catalog,
+                                const std::string &schema, const std::string &name);
+
+private:
+    std::mutex lock;
+    // entries are never removed, so references handed out stay valid
+    std::unordered_map<std::string, ResolvedName> cache;
+};
+
+// Resolves every extracted name, CTE references are reported with object type "cte"
+void ResolveTableRefs(ClientContext &context, CatalogResolver &resolver, const std::vector<TableRefResult> &tables,
+                      std::vector<ResolvedName> &resolved);
+void ResolveFunctions(ClientContext &context, CatalogResolver &resolver, const std::vector<FunctionResult> &functions,
+                      std::vector<ResolvedName> &resolved);
+
+/**
+ * Bind data for scalar functions that resolve names: the resolver is created once per bound
+ * expression, so its cache is shared by every row and thread of the scan.
+ */
+struct CatalogResolverBindData : public FunctionData {
+    shared_ptr<CatalogResolver> resolver;
+
+    unique_ptr<FunctionData> Copy() const override;
+    bool Equals(const FunctionData &other) const override;
+};
+
+unique_ptr<FunctionData> CatalogResolverBind(ClientContext &context, ScalarFunction &bound_function,
+                                             vector<unique_ptr<Expression>> &arguments);
+
+// The resolver of the scalar function being executed
+CatalogResolver &GetCatalogResolver(ExpressionState &state);
+
+} // namespace duckdb
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/parser/query_node/select_node.hpp"
+#include "duckdb/parser/expression/columnref_expression.hpp"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+struct FromBinding {
+    std::string name;       // the alias, or the table name if there is none
+    std::string table;      // the base table, empty for derived tables, CTEs and table functions
+    const QueryNode *query; // the derived table or CTE, nullptr otherwise
+};
+
+/**
+ * The relations visible in the FROM clause of a SELECT node. Maps column references, qualified
+ * with an alias or not, back to the base table they are read from, following derived tables and
+ * CTEs through their select lists.
+ */
+class FromScope {
+public:
+    // outer_ctes are the CTE maps of the enclosing query nodes, innermost last
+    FromScope(const SelectNode &node, std::vector<const CommonTableExpressionMap *> outer_ctes);
+
+    // The base table a column reference resolves to, empty if it cannot be determined. Unqualified
+    // columns are only resolved when there is a single relation.
+    std::string ResolveColumn(const std::string &qualifier, const std::string &column, idx_t depth = 0) const;
+    std::string ResolveColumn(const ColumnRefExpression &column_ref) const;
+
+    // The table of the first column an expression references, or the only table in scope if the
+    // expression references no column at all
+    std::string Attribute(const ParsedExpression &expr) const;
+
+    // The base tables the FROM clause reads, through derived tables and CTEs, without duplicates
+    void SourceTables(std::vector<std::string> &tables, idx_t depth = 0) const;
+
+private:
+    void AddBindings(const TableRef &ref);
+    const CommonTableExpressionInfo *FindCTE(const std::string &name) const;
+    // Resolves a column of a derived table or CTE through the select list that produces it
+    std::string ResolveOutputColumn(const QueryNode &node, const std::string &column, idx_t depth) const;
+
+    std::vector<const CommonTableExpressionMap *> ctes;
+    std::vector<FromBinding> bindings;
+};
+
+// The base tables a query node reads, through set operations, derived tables and CTEs
+void QueryNodeSourceTables(const QueryNode &node, const std::vector<const CommonTableExpressionMap *> &ctes,
+                           std::vector<std::string> &tables);
+
+using QueryNodeCallback =
+    std::function<void(const QueryNode &, const std::vector<const CommonTableExpressionMap *> &)>;
+using SelectNodeCallback =
+    std::function<void(const SelectNode &, const std::vector<const CommonTableExpressionMap *> &)>;
+
+// Calls callback for every query node of a query, including CTEs, derived tables, subquery
+// expressions and the branches of set operations, with the CTE maps of the enclosing nodes
+void EnumerateQueryNodes(const QueryNode &node, const QueryNodeCallback &callback,
+                         std::vector<const CommonTableExpressionMap *> ctes = {});
+// Same as EnumerateQueryNodes, for SELECT nodes only
+void EnumerateSelectNodes(const QueryNode &node, const SelectNodeCallback &callback,
+                          std::vector<const CommonTableExpressionMap *> ctes = {});
+
+} // namespace duckdb
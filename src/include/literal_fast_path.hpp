@@ -0,0 +1,13 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "sql_scanner.hpp"
+
+namespace duckdb {
+
+// Forward declarations
+class DatabaseInstance;
+
+void RegisterParseInsertValuesFunction(DatabaseInstance &db);
+
+} // namespace duckdb
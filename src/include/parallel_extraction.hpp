@@ -0,0 +1,60 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "parser_tools_limits.hpp"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+// Forward declarations
+class ClientContext;
+
+/**
+ * Chunks whose SQL values add up to at least this many bytes are extracted on several threads.
+ * Below it, scheduling tasks costs more than parsing the chunk on the calling thread.
+ */
+static constexpr idx_t PARALLEL_CHUNK_MIN_BYTES = 1048576;
+
+/**
+ * Calls extract(row) for every row in [0, count). When the rows' SQL adds up to
+ * PARALLEL_CHUNK_MIN_BYTES or more, the rows are handed out one at a time to tasks on the database's
+ * TaskScheduler, and the calling thread works along until all are done; otherwise they run on the
+ * calling thread. extract must only write to state of its own row. An exception thrown for any row
+ * is rethrown on the calling thread.
+ */
+void ExtractRows(ClientContext &context, idx_t count, idx_t input_bytes, const std::function<void(idx_t row)> &extract);
+
+// Total size of the non-NULL strings among the first count rows of a VARCHAR vector
+idx_t InputBytes(Vector &input, idx_t count);
+
+/**
+ * Runs the extraction of every row of a scalar function's chunk up front, in parallel for large
+ * chunks, so that the results can afterwards be written to the result vector in row order.
+ * extract(sql, row, extraction) is called for every non-NULL row the executors will visit (only
+ * row 0 when all arguments are constant). EXTRACTION must have a bool keep member: it is set to
+ * whether the row's result is kept under the resource limits, and stays false for NULL inputs.
+ */
+template <class EXTRACTION, class EXTRACT>
+void ExtractChunk(ClientContext &context, DataChunk &args, const char *function_name,
+                  std::vector<EXTRACTION> &extractions, const EXTRACT &extract) {
+    auto limits = ParserToolsLimits::Get(context);
+    auto count = args.AllConstant() ? 1 : args.size();
+    UnifiedVectorFormat input_data;
+    args.data[0].ToUnifiedFormat(count, input_data);
+    auto queries = UnifiedVectorFormat::GetData<string_t>(input_data);
+
+    extractions.resize(count);
+    ExtractRows(context, count, InputBytes(args.data[0], count), [&](idx_t row) {
+        auto idx = input_data.sel->get_index(row);
+        if (!input_data.validity.RowIsValid(idx)) {
+            return;
+        }
+        ExtractionBudget budget(limits);
+        extract(queries[idx].GetString(), row, extractions[row]);
+        extractions[row].keep = budget.KeepResult(function_name);
+    });
+}
+
+} // namespace duckdb
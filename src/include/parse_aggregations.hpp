@@ -0,0 +1,43 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/parser/expression/function_expression.hpp"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+// Forward declarations
+class DatabaseInstance;
+
+struct AggregateCallResult {
+    std::string function_name;
+    std::vector<std::string> arguments; // the arguments as written
+    std::vector<std::string> columns;   // columns read by the arguments, as table.column where resolvable
+    std::string filter;                 // the FILTER condition, empty if there is none
+    bool is_distinct;
+};
+
+/**
+ * The grouping of a single SELECT node. ROLLUP and CUBE are reported as the grouping sets they
+ * expand to, positional keys (GROUP BY 1) and GROUP BY ALL as the select list items they refer to.
+ */
+struct AggregationResult {
+    std::vector<std::string> tables; // base tables read by the FROM clause, through derived tables and CTEs
+    std::vector<std::string> group_keys;
+    std::vector<std::vector<std::string>> grouping_sets;
+    bool group_by_all;
+    std::vector<AggregateCallResult> aggregates;
+};
+
+// The parser cannot tell aggregates from scalar functions, is_aggregate decides for calls that are
+// not evidently aggregates (DISTINCT, FILTER or ORDER BY in the call)
+using AggregateFunctionFilter = std::function<bool(const FunctionExpression &)>;
+
+void ExtractAggregationsFromSQL(const std::string &sql, std::vector<AggregationResult> &results,
+                                const AggregateFunctionFilter &is_aggregate);
+
+void RegisterParseAggregationsFunction(DatabaseInstance &db);
+
+} // namespace duckdb
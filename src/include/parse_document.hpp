@@ -0,0 +1,52 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "parse_tables.hpp"
+#include "parse_functions.hpp"
+#include "parser_tools_limits.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+// Forward declarations
+class DatabaseInstance;
+
+// What was extracted from a single statement of a document; shared between versions of the document
+struct DocumentStatementResult {
+    bool parsed = false; // the statement parses on its own
+    bool kept = true;    // false if the resource limits made the result NULL
+    std::vector<TableRefResult> tables;
+    std::vector<FunctionResult> functions;
+};
+
+struct DocumentStatement {
+    idx_t start; // byte offset of the first token
+    idx_t end;   // byte offset just past the last token, before the semicolon
+    idx_t next;  // byte offset just past the semicolon, or the end of the document
+    bool reparsed;
+    std::shared_ptr<const DocumentStatementResult> result;
+};
+
+/**
+ * A document being edited, split into statements with the result of each. Update only re-parses
+ * the statements overlapping the bytes that differ from the previous text; the statements before
+ * them are kept as they are, and those after them are kept with their offsets shifted.
+ */
+class IncrementalDocument {
+public:
+    void Update(const std::string &new_text, const ParserToolsLimits &limits);
+
+    const std::vector<DocumentStatement> &Statements() const {
+        return statements;
+    }
+
+private:
+    std::string text;
+    std::vector<DocumentStatement> statements;
+};
+
+void RegisterParseDocumentFunctions(DatabaseInstance &db);
+
+} // namespace duckdb
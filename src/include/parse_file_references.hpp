@@ -0,0 +1,32 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+// Forward declarations
+class DatabaseInstance;
+
+struct FileArgumentResult {
+    std::string name;  // empty for positional arguments
+    std::string value; // the constant as text, strings without quotes
+};
+
+/**
+ * A place where a query reads files: a table function call, a file path used as a table name
+ * (a replacement scan) or a COPY ... FROM.
+ */
+struct FileReferenceResult {
+    std::string source;        // table_function, replacement_scan or copy_from
+    std::string function_name; // the table function, or the format of a COPY; empty for replacement scans
+    std::vector<FileArgumentResult> arguments; // the constant arguments, non-constant ones are left out
+    std::vector<std::string> files;            // the paths and glob patterns read, as written
+};
+
+void ExtractFileReferencesFromSQL(const std::string &sql, std::vector<FileReferenceResult> &results);
+
+void RegisterParseFileReferencesFunction(DatabaseInstance &db);
+
+} // namespace duckdb
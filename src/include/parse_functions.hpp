@@ -13,8 +13,18 @@ struct FunctionResult {
 	std::string function_name;
 	std::string schema;
 	std::string context;     // The context where this function appears (SELECT, WHERE, etc.)
+	// catalog and schema exactly as written in the query, empty if not qualified
+	std::string catalog_name;
+	std::string schema_name;
 };
 
+void ExtractFunctionsFromSQL(const std::string &sql, std::vector<FunctionResult> &results);
+void ExtractFunctionsFromQueryNode(const QueryNode &node, std::vector<FunctionResult> &results);
+
+// Append the functions of one row to a LIST(VARCHAR) / LIST(STRUCT(function_name, schema, context)) result
+list_entry_t WriteFunctionNameList(Vector &result, const std::vector<FunctionResult> &parsed_functions);
+list_entry_t WriteFunctionStructList(Vector &result, const std::vector<FunctionResult> &parsed_functions);
+
 void RegisterParseFunctionsFunction(DatabaseInstance &db);
 void RegisterParseFunctionScalarFunction(DatabaseInstance &db);
 
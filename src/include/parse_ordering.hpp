@@ -0,0 +1,44 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+// Forward declarations
+class DatabaseInstance;
+
+struct OrderKeyResult {
+    std::string expression;
+    std::string column;     // table.column if the key is a column whose table can be determined
+    std::string direction;  // ASC or DESC, empty if the session default applies
+    std::string null_order; // NULLS FIRST or NULLS LAST, empty if the session default applies
+};
+
+struct WindowSpecResult {
+    std::string function_name;
+    std::vector<std::string> partition_by;
+    std::vector<OrderKeyResult> order_by;
+    std::vector<std::string> tables; // tables of the partition and order columns
+};
+
+/**
+ * The ordering of a single query node: its ORDER BY, LIMIT and OFFSET, and the window
+ * specifications of its select list.
+ */
+struct OrderingResult {
+    std::string node_type;           // select, set_operation or recursive_cte
+    std::vector<std::string> tables; // base tables read by the node, through derived tables and CTEs
+    std::vector<OrderKeyResult> order_by;
+    std::string limit;               // empty if there is no LIMIT
+    std::string offset;              // empty if there is no OFFSET
+    bool limit_percent;
+    std::vector<WindowSpecResult> windows;
+};
+
+void ExtractOrderingFromSQL(const std::string &sql, std::vector<OrderingResult> &results);
+
+void RegisterParseOrderingFunction(DatabaseInstance &db);
+
+} // namespace duckdb
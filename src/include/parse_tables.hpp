@@ -23,16 +23,23 @@ struct TableRefResult {
     std::string schema;
     std::string table;
     TableContext context;
+    // catalog and schema exactly as written in the query, empty if not qualified
+    std::string catalog_name;
+    std::string schema_name;
 };
 
-static void ExtractTablesFromSQL(const std::string &sql, std::vector<TableRefResult> &results);
-static void ExtractTablesFromQueryNode(
+void ExtractTablesFromSQL(const std::string &sql, std::vector<TableRefResult> &results);
+void ExtractTablesFromQueryNode(
     const duckdb::QueryNode &node,
     std::vector<TableRefResult> &results,
     const TableContext context = TableContext::From,
     const duckdb::CommonTableExpressionMap *cte_map = nullptr
 );
 
+// Append the tables of one row to a LIST(VARCHAR) / LIST(STRUCT(schema, table, context)) result
+list_entry_t WriteTableNameList(Vector &result, const std::vector<TableRefResult> &parsed_tables);
+list_entry_t WriteTableStructList(Vector &result, const std::vector<TableRefResult> &parsed_tables);
+
 void RegisterParseTablesFunction(duckdb::DatabaseInstance &db);
 void RegisterParseTableScalarFunction(DatabaseInstance &db);
 
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "catalog_resolver.hpp"
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace duckdb {
+
+// Forward declarations
+class ClientContext;
+class DatabaseInstance;
+
+/**
+ * One edge of the dependency DAG of a query: object is referenced by parent (empty for the query
+ * itself) and sits depth levels below the query.
+ */
+struct DependencyResult {
+    ResolvedName object;
+    std::string parent;
+    idx_t depth;
+};
+
+/**
+ * Memoized dependencies of views and table macros. Each definition is walked once, the first time
+ * it is reached, and the result is shared by every later query that references the same object.
+ * Safe to share between threads.
+ */
+class DependencyGraph {
+public:
+    // The objects directly referenced by a view or table macro, empty for anything else
+    const std::vector<ResolvedName> &Dependencies(ClientContext &context, const ResolvedName &object);
+
+    // Breadth-first expansion of the objects referenced by a query
+    void Expand(ClientContext &context, const std::vector<ResolvedName> &roots, std::vector<DependencyResult> &results);
+
+    CatalogResolver resolver;
+
+private:
+    std::mutex lock;
+    // entries are never removed, so references handed out stay valid
+    std::unordered_map<std::string, std::vector<ResolvedName>> dependencies;
+};
+
+// The tables, views and table functions referenced by a query node. Unqualified names are looked up
+// in scope (the catalog and schema of the view being expanded) first when it is given.
+void CollectDependencies(ClientContext &context, CatalogResolver &resolver, const QueryNode &node,
+                         const ResolvedName *scope, std::vector<ResolvedName> &results);
+
+std::string QualifiedObjectName(const ResolvedName &object);
+
+void RegisterParseTablesRecursiveFunction(DatabaseInstance &db);
+
+} // namespace duckdb
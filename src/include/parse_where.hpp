@@ -11,7 +11,7 @@ class DatabaseInstance;
 
 struct WhereConditionResult {
     std::string condition;
-    std::string table_name;  // The table this condition applies to (if determinable)
+    std::string table_name;  // The table this condition applies to, empty if not determinable
     std::string context;     // The context where this condition appears (WHERE, HAVING, etc.)
 };
 
@@ -19,10 +19,19 @@ struct DetailedWhereConditionResult {
     std::string column_name;     // The column being compared
     std::string operator_type;   // The comparison operator (>, <, =, etc.)
     std::string value;          // The value being compared against
-    std::string table_name;     // The table this condition applies to (if determinable)
+    std::string table_name;     // The table this condition applies to, empty if not determinable
     std::string context;        // The context where this condition appears (WHERE, HAVING, etc.)
+    bool is_constant = false;   // The value is a literal rather than an expression
 };
 
+void ExtractWhereConditionsFromSQL(const std::string &sql, std::vector<WhereConditionResult> &results);
+void ExtractWhereConditionsFromQueryNode(const QueryNode &node, std::vector<WhereConditionResult> &results);
+void ExtractDetailedWhereConditionsFromSQL(const std::string &sql, std::vector<DetailedWhereConditionResult> &results);
+void ExtractDetailedWhereConditionsFromQueryNode(const QueryNode &node, std::vector<DetailedWhereConditionResult> &results);
+
+// Appends the conditions of one row to a LIST(STRUCT(condition, table_name, context)) result
+list_entry_t WriteWhereConditionList(Vector &result, const std::vector<WhereConditionResult> &conditions);
+
 void RegisterParseWhereFunction(DatabaseInstance &db);
 void RegisterParseWhereScalarFunction(DatabaseInstance &db);
 void RegisterParseWhereDetailedFunction(DatabaseInstance &db);
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * Public API of the parser_tools_core library.
+ *
+ * These are the extractors behind the parse_tables, parse_functions and parse_where_detailed SQL
+ * functions, callable from any process linking DuckDB without opening a database: only DuckDB's
+ * parser is used. All functions are thread-safe, and SQL that fails to parse yields an empty result.
+ */
+namespace parser_tools {
+
+struct TableReference {
+    std::string schema;  // "main" if not qualified, empty for CTE definitions
+    std::string table;
+    std::string context; // from, join_left, join_right, from_cte, cte, subquery
+};
+
+struct FunctionReference {
+    std::string function_name;
+    std::string schema;  // "main" if not qualified
+    std::string context; // select, where, having, order_by, group_by, join, window, nested
+};
+
+struct PredicateReference {
+    std::string column_name;
+    std::string operator_type;
+    std::string value;
+    std::string table_name; // empty if the column cannot be attributed to a single table
+    std::string context;    // WHERE, HAVING
+};
+
+std::vector<TableReference> ExtractTables(const std::string &sql);
+std::vector<FunctionReference> ExtractFunctions(const std::string &sql);
+std::vector<PredicateReference> ExtractPredicates(const std::string &sql);
+
+} // namespace parser_tools
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include <chrono>
+#include <string>
+
+namespace duckdb {
+
+// Forward declarations
+class ClientContext;
+class DatabaseInstance;
+
+/**
+ * What to do with a row whose SQL exceeds one of the parser_tools limits.
+ */
+enum class LimitBehavior {
+    ReturnNull, // the row's result is NULL (table functions return no rows)
+    Error,      // the query fails with an InvalidInputException
+    Truncate    // whatever was extracted before the limit was hit is returned
+};
+
+/**
+ * Per-row resource limits, read from the parser_tools_* settings. A value of 0 disables the limit.
+ */
+struct ParserToolsLimits {
+    idx_t max_sql_bytes = 0;
+    idx_t max_ast_nodes = 0;
+    idx_t max_parse_ms = 0;
+    LimitBehavior on_limit = LimitBehavior::ReturnNull;
+
+    bool Enabled() const {
+        return max_sql_bytes > 0 || max_ast_nodes > 0 || max_parse_ms > 0;
+    }
+
+    static ParserToolsLimits Get(ClientContext &context);
+};
+
+/**
+ * Tracks the resources used while extracting from a single SQL value.
+ *
+ * A budget installs itself for the current thread on construction, so the extractors only need to
+ * call the static AllowInput / Tick functions; those are a thread-local load and a branch when no
+ * budget is active.
+ */
+class ExtractionBudget {
+public:
+    explicit ExtractionBudget(const ParserToolsLimits &limits);
+    ~ExtractionBudget();
+
+    // Returns false if the SQL is too large to be parsed at all, by size or by token count
+    static bool AllowInput(const std::string &sql);
+    // Only the size check, for inputs that are split into statements before they are parsed
+    static bool AllowInputSize(idx_t sql_bytes);
+    // Counts one visited AST node, returns false once the node or time budget is exhausted
+    static bool Tick();
+    // Checks the time budget, used right after parsing
+    static bool CheckDeadline();
+
+    bool Exceeded() const {
+        return exceeded;
+    }
+
+    // Applies the on-limit behavior: returns whether the (possibly truncated) result should be kept,
+    // false if the row should be NULL. Throws if the behavior is to error.
+    bool KeepResult(const char *function_name) const;
+
+private:
+    bool Exceed(std::string reason);
+    bool DeadlineReached();
+
+    const ParserToolsLimits &limits;
+    idx_t nodes = 0;
+    std::chrono::steady_clock::time_point start;
+    bool exceeded = false;
+    std::string reason;
+    ExtractionBudget *previous;
+
+    static thread_local ExtractionBudget *current;
+};
+
+void RegisterParserToolsSettings(DatabaseInstance &db);
+
+} // namespace duckdb
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "parse_where.hpp"
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace duckdb {
+
+// Forward declarations
+class DatabaseInstance;
+
+/**
+ * HyperLogLog with 2^10 one-byte registers (about 3% standard error). The registers are only
+ * allocated once the first value is added.
+ */
+class DistinctSketch {
+public:
+    void Add(uint64_t hash);
+    void Merge(const DistinctSketch &other);
+    double Estimate() const;
+
+    std::vector<uint8_t> registers;
+};
+
+/**
+ * KLL-style quantile sketch: level h holds values of weight 2^h. A full level is sorted and every
+ * other value is promoted to the next level, alternating between the odd and the even ones.
+ * The exact minimum and maximum are kept on the side.
+ */
+class QuantileSketch {
+public:
+    void Add(double value);
+    void Merge(const QuantileSketch &other);
+    // The value below which a fraction q of the added values lies
+    double Quantile(double q) const;
+
+    uint64_t count = 0;
+    double min = 0;
+    double max = 0;
+    uint64_t compactions = 0;
+    std::vector<std::vector<double>> levels;
+
+private:
+    idx_t Capacity(idx_t level) const;
+    void Compress();
+};
+
+/**
+ * Misra-Gries frequent values summary. Counts are lower bounds, off by at most
+ * (values added) / (HEAVY_HITTER_COUNTERS + 1); merging two summaries keeps that bound.
+ */
+class HeavyHitters {
+public:
+    void Add(const std::string &value, uint64_t count = 1);
+    void Merge(const HeavyHitters &other);
+    // The values with their counts, the most frequent first
+    std::vector<std::pair<std::string, uint64_t>> Top() const;
+
+    std::map<std::string, uint64_t> counters;
+
+private:
+    void Prune();
+};
+
+// The sketches of the literals compared against one column with one operator
+struct PredicateColumnSketch {
+    uint64_t predicates = 0; // comparisons seen
+    uint64_t literals = 0;   // comparisons against a literal, the ones the sketches below see
+    DistinctSketch distinct;
+    QuantileSketch numeric;  // literals that are numbers
+    QuantileSketch temporal; // literals that are dates or timestamps, in microseconds since the epoch
+    HeavyHitters frequent;
+};
+
+using PredicateSketchKey = std::tuple<std::string, std::string, std::string>; // table, column, operator
+
+/**
+ * The state of predicate_sketch: one PredicateColumnSketch per (table, column, operator).
+ * Serialize and Deserialize convert it to and from the BLOB the aggregate returns.
+ */
+class PredicateSketch {
+public:
+    void Add(const DetailedWhereConditionResult &condition);
+    void Merge(const PredicateSketch &other);
+
+    void Serialize(std::string &target) const;
+    static void Deserialize(const char *data, idx_t size, PredicateSketch &result);
+
+    std::map<PredicateSketchKey, PredicateColumnSketch> columns;
+};
+
+void RegisterPredicateSketchFunctions(DatabaseInstance &db);
+
+} // namespace duckdb
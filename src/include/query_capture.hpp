@@ -0,0 +1,71 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/common/enums/statement_type.hpp"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+// Forward declarations
+class DatabaseInstance;
+
+struct CapturedQuery {
+    uint64_t sequence; // assigned by the buffer, increasing in recording order
+    timestamp_t captured_at;
+    idx_t connection_id;
+    StatementType statement_type;
+    uint64_t fingerprint;
+    std::vector<std::string> tables;    // schema.table, CTE references excluded
+    std::vector<std::string> functions;
+};
+
+// Size of one ring slot in 8 byte words, the table and function names share what is left after the
+// fixed fields
+static constexpr idx_t QUERY_CAPTURE_SLOT_WORDS = 64;
+
+/**
+ * A bounded ring of the most recently executed queries, shared by all connections of a database.
+ *
+ * The slots are preallocated and hold the entry inline, so recording does not allocate. Each slot
+ * is a seqlock: a writer claims a sequence with one atomic increment, marks its slot as being
+ * written, stores the entry and publishes it with the final version. Readers never block writers,
+ * they copy a slot and drop the copy if its version changed meanwhile. A writer only waits when
+ * the ring wrapped around while an older writer was still storing into the same slot. Once the
+ * ring is full the oldest entries are overwritten. Names that do not fit into a slot are left out.
+ */
+class QueryCaptureBuffer {
+public:
+    explicit QueryCaptureBuffer(idx_t capacity);
+
+    void Record(const CapturedQuery &entry);
+
+    // The entries not drained yet, oldest first, up to the first one that is claimed but not yet
+    // published. With drain, they are not returned again.
+    void Snapshot(std::vector<CapturedQuery> &entries, bool drain);
+
+private:
+    struct Slot {
+        // 0 while empty, 2 * sequence + 1 while being written, 2 * sequence + 2 once published
+        std::atomic<uint64_t> version;
+        std::atomic<uint64_t> words[QUERY_CAPTURE_SLOT_WORDS];
+    };
+
+    idx_t capacity;
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<uint64_t> next_sequence;
+    std::atomic<uint64_t> drained_until;
+};
+
+/**
+ * Hashes the token stream of a statement with literals and parameters replaced by a placeholder and
+ * unquoted identifiers lower cased, so queries that only differ in their constants, whitespace or
+ * comments share a fingerprint. Does not parse and does not allocate.
+ */
+uint64_t FingerprintSQL(const std::string &sql, idx_t start = 0, idx_t length = 0);
+
+void RegisterQueryCaptureFunctions(DatabaseInstance &db);
+
+} // namespace duckdb
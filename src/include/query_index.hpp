@@ -0,0 +1,25 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+// Forward declarations
+class DatabaseInstance;
+
+/**
+ * A single object referenced by a query, used as a key of the inverted index.
+ */
+struct IndexTermResult {
+    std::string kind;      // table, column or function
+    std::string qualifier; // schema for tables and functions, table qualifier for columns
+    std::string name;
+};
+
+void ExtractIndexTermsFromSQL(const std::string &sql, std::vector<IndexTermResult> &results);
+
+void RegisterQueryIndexFunctions(DatabaseInstance &db);
+
+} // namespace duckdb
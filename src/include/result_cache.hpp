@@ -0,0 +1,14 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+// Forward declarations
+class DatabaseInstance;
+
+void RegisterResultCacheFunctions(DatabaseInstance &db);
+
+} // namespace duckdb
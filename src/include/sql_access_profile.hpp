@@ -0,0 +1,44 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+// Forward declarations
+class DatabaseInstance;
+
+/**
+ * A catalog object written by a statement, with its name as written in the query: catalog and
+ * schema are empty if they were left out. is_schema marks a whole schema, in which case name is empty.
+ */
+struct SqlWrittenObject {
+    std::string catalog;
+    std::string schema;
+    std::string name;
+    bool is_schema = false;
+};
+
+/**
+ * What a statement or script reads and writes. Objects are qualified as [catalog.]schema.name,
+ * files read by COPY FROM and written by COPY TO are listed as written in the query.
+ */
+struct SqlAccessProfile {
+    bool read_only = true;                       // no statement modifies the database, a file or a sequence
+    bool deterministic = true;                   // read-only, and no volatile function or external source
+    std::vector<std::string> statement_types;    // one entry per statement, e.g. select, insert, create
+    std::vector<std::string> reads;
+    std::vector<std::string> writes;
+    std::vector<SqlWrittenObject> written_objects; // the catalog objects among writes, for name resolution
+    std::vector<std::string> volatile_functions; // random, now, nextval, read_csv, ...
+};
+
+// Returns false if the SQL does not parse
+bool ProfileSqlAccess(const std::string &sql, SqlAccessProfile &profile);
+// Adds what an already parsed statement reads and writes to profile
+void ProfileStatementAccess(SQLStatement &stmt, SqlAccessProfile &profile);
+
+void RegisterSqlAccessProfileFunction(DatabaseInstance &db);
+
+} // namespace duckdb
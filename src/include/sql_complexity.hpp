@@ -0,0 +1,31 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include <string>
+
+namespace duckdb {
+
+// Forward declarations
+class DatabaseInstance;
+
+/**
+ * Structural metrics of a query, all collected in a single walk of its AST. Multiple statements
+ * are summed, except max_depth which is the deepest of them.
+ */
+struct SqlComplexityResult {
+    idx_t node_count = 0;      // query nodes, table references and expressions
+    idx_t max_depth = 0;       // query nesting, 1 for a query without subqueries or CTEs
+    idx_t join_count = 0;      // joins, including comma separated FROM lists
+    idx_t subquery_count = 0;  // derived tables and subquery expressions (scalar, EXISTS, IN, ANY)
+    idx_t cte_count = 0;
+    idx_t window_count = 0;
+    idx_t table_count = 0;     // distinct base tables and views, CTE references excluded
+    idx_t predicate_count = 0; // atoms of WHERE, HAVING, QUALIFY and join conditions
+};
+
+// Returns false if the SQL does not parse
+bool ComputeSqlComplexity(const std::string &sql, SqlComplexityResult &result);
+
+void RegisterSqlComplexityFunction(DatabaseInstance &db);
+
+} // namespace duckdb
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include <set>
+#include <string>
+
+namespace duckdb {
+
+// Forward declarations
+class DatabaseInstance;
+
+/**
+ * Collects the structural features of a query that are used for similarity:
+ *   t:<schema>.<table>       referenced tables (CTE references excluded)
+ *   f:<function>             function calls
+ *   p:<column> <operator>    predicate shapes (literal values are ignored)
+ *   j:<table.col>=<table.col> equi-join edges
+ */
+void ExtractQueryFeatures(const std::string &sql, std::set<std::string> &features);
+
+void RegisterSqlMinhashFunctions(DatabaseInstance &db);
+
+} // namespace duckdb
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+// Forward declarations
+class DatabaseInstance;
+
+// Literals of one query have different types and the result is a single LIST, so each value is
+// returned as its type name plus its text rendering instead of a typed value.
+struct ParameterizedValue {
+    std::string type;   // The logical type of the extracted literal (INTEGER, VARCHAR, etc.)
+    std::string value;  // The literal rendered as a string
+};
+
+struct ParameterizedSQLResult {
+    std::string sql;                            // The SQL with every literal replaced by $n
+    std::vector<ParameterizedValue> parameters; // The extracted literals, in $n order
+};
+
+bool ParameterizeSQL(const std::string &sql, ParameterizedSQLResult &result);
+
+void RegisterSqlParameterizeFunction(DatabaseInstance &db);
+
+} // namespace duckdb
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/parser/qualified_name.hpp"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace duckdb {
+
+// Forward declarations
+class BaseTableRef;
+class DatabaseInstance;
+
+/**
+ * Redirects table references to other tables. Names are matched case-insensitively; the parts a
+ * source name leaves out match anything, so "orders" matches every table called orders and
+ * "sales.orders" only the one in schema sales. Unqualified references are in schema main. The most
+ * specific matching source wins.
+ */
+class TableRewriteMap {
+public:
+    // Both names are [[catalog.]schema.]table, throws InvalidInputException if either does not parse
+    void Add(const std::string &from, const std::string &to);
+
+    // The rewrite to apply to a reference, nullptr if it is not mapped
+    const QualifiedName *Find(const BaseTableRef &ref) const;
+
+    // Cheap pre-check on the tokens of the SQL: false if no mapped table name occurs at all
+    bool MayMatch(const std::string &sql) const;
+
+    bool Empty() const {
+        return by_name.empty();
+    }
+
+private:
+    struct Entry {
+        QualifiedName from;
+        QualifiedName to;
+    };
+    // keyed on the lower case table name
+    std::unordered_map<std::string, std::vector<Entry>> by_name;
+};
+
+// Rewrites the table references of sql, CTE names shadow mapped tables the same way they do when
+// the query is bound. Returns false (and leaves result untouched) if nothing was rewritten or the
+// SQL does not parse.
+bool RewriteTablesInSQL(const std::string &sql, const TableRewriteMap &map, std::string &result);
+
+void RegisterSqlRewriteTablesFunction(DatabaseInstance &db);
+
+} // namespace duckdb
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+/**
+ * Inputs smaller than this are parsed as-is: scanning them for literal lists costs more than it saves.
+ */
+static constexpr idx_t LITERAL_FAST_PATH_MIN_BYTES = 16384;
+
+/**
+ * The table functions extract inputs at least this large one statement at a time while scanning,
+ * instead of all at once while binding, so memory stays proportional to the largest statement.
+ */
+static constexpr idx_t STATEMENT_AT_A_TIME_MIN_BYTES = 1048576;
+
+enum class SqlTokenType {
+    Identifier,       // keywords are reported as identifiers
+    QuotedIdentifier, // "name"
+    String,           // 'text', E'text', $$text$$
+    Number,
+    Parameter,        // $1, ?
+    LeftParen,
+    RightParen,
+    Comma,
+    Semicolon,
+    Operator
+};
+
+struct SqlToken {
+    SqlTokenType type;
+    idx_t start;
+    idx_t length;
+};
+
+/**
+ * A minimal, allocation-free SQL tokenizer. It only understands enough of the grammar to skip over
+ * comments, string literals and quoted identifiers, which is all that is needed to find literal
+ * lists without building an AST.
+ */
+class SqlScanner {
+public:
+    explicit SqlScanner(const std::string &sql) : sql(sql) {
+    }
+
+    // Reads the next token, returns false at the end of the input
+    bool Next(SqlToken &token);
+
+    // Case-insensitive comparison of an identifier token against a lower case keyword
+    bool IsKeyword(const SqlToken &token, const char *keyword) const;
+
+    // Whether the token is the single character operator symbol
+    bool IsSymbol(const SqlToken &token, char symbol) const;
+
+    // The identifier with quotes removed
+    std::string IdentifierName(const SqlToken &token) const;
+
+    idx_t Position() const {
+        return position;
+    }
+
+    void Reset(idx_t new_position) {
+        position = new_position;
+    }
+
+private:
+    void SkipWhitespaceAndComments();
+    void ScanQuoted(char quote, bool backslash_escapes);
+
+    const std::string &sql;
+    idx_t position = 0;
+};
+
+/**
+ * Hands out the statements of a script one at a time, split at the semicolons outside of literals
+ * and comments. Statements made of whitespace and comments only are skipped.
+ */
+class StatementCursor {
+public:
+    // start must be the beginning of the script or just after one of its top-level semicolons
+    explicit StatementCursor(const std::string &sql, idx_t start = 0) : sql(sql), scanner(sql) {
+        scanner.Reset(start);
+    }
+
+    // Reads the text of the next statement, returns false at the end of the script
+    bool Next(std::string &statement);
+
+    // Reads the byte range of the next statement, from its first token to the end of its last one,
+    // returns false at the end of the script
+    bool Next(idx_t &start, idx_t &end);
+
+    // Just after the semicolon ending the last statement read, or the end of the script
+    idx_t Position() const {
+        return scanner.Position();
+    }
+
+private:
+    const std::string &sql;
+    SqlScanner scanner;
+};
+
+struct InsertValuesResult {
+    std::string schema;
+    std::string table;
+    std::vector<std::string> columns;
+    idx_t row_count = 0;
+    idx_t literal_count = 0;
+};
+
+/**
+ * Summarizes INSERT ... VALUES statements from the token stream only, without parsing the rows.
+ */
+void ExtractInsertValuesFromSQL(const std::string &sql, std::vector<InsertValuesResult> &results);
+
+/**
+ * Rewrites VALUES lists and IN lists made of literals only down to their first row / element.
+ * The tables and functions referenced by the statement are unchanged, but the AST built from the
+ * compacted text no longer holds one ConstantExpression per literal.
+ * Returns false (and leaves compacted untouched) if there was nothing to compact.
+ */
+bool CompactLiteralLists(const std::string &sql, std::string &compacted);
+
+} // namespace duckdb
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "parse_tables.hpp"
+#include "parse_functions.hpp"
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+/**
+ * Best-effort extraction from SQL that does not parse, e.g. statements truncated by a logger.
+ *
+ * The input is parsed as a whole first, so valid SQL costs a single parse and gives the same
+ * results as the regular extractors. Otherwise every statement is parsed on its own; a statement
+ * that still fails is cut back to its longest parsable prefix at a clause boundary, and the rest of
+ * it is scanned token by token for FROM / JOIN targets or function calls. exact[i] is true if
+ * results[i] comes from a statement that parsed completely.
+ */
+void ExtractTablesFromSQLTolerant(const std::string &sql, std::vector<TableRefResult> &results,
+                                  std::vector<bool> &exact);
+void ExtractFunctionsFromSQLTolerant(const std::string &sql, std::vector<FunctionResult> &results,
+                                     std::vector<bool> &exact);
+
+} // namespace duckdb
@@ -0,0 +1,88 @@
+#include "literal_fast_path.hpp"
+#include "duckdb.hpp"
+#include "duckdb/main/extension_util.hpp"
+
+namespace duckdb {
+
+static list_entry_t WriteInsertValuesList(Vector &result, const std::vector<InsertValuesResult> &inserts) {
+    auto current_size = ListVector::GetListSize(result);
+    auto number_of_inserts = inserts.size();
+    auto new_size = current_size + number_of_inserts;
+
+    // Grow list vector if needed
+    if (ListVector::GetListCapacity(result) < new_size) {
+        ListVector::Reserve(result, new_size);
+    }
+
+    // Get the struct child vector of the list
+    auto &struct_vector = ListVector::GetEntry(result);
+
+    // Ensure list size is updated
+    ListVector::SetListSize(result, new_size);
+
+    // Get the fields in the STRUCT
+    auto &entries = StructVector::GetEntries(struct_vector);
+    auto &schema_entry = *entries[0];        // "schema" field
+    auto &table_entry = *entries[1];         // "table" field
+    auto &columns_entry = *entries[2];       // "columns" field
+    auto &row_count_entry = *entries[3];     // "row_count" field
+    auto &literal_count_entry = *entries[4]; // "literal_count" field
+
+    auto schema_data = FlatVector::GetData<string_t>(schema_entry);
+    auto table_data = FlatVector::GetData<string_t>(table_entry);
+    auto columns_data = FlatVector::GetData<list_entry_t>(columns_entry);
+    auto row_count_data = FlatVector::GetData<int64_t>(row_count_entry);
+    auto literal_count_data = FlatVector::GetData<int64_t>(literal_count_entry);
+
+    for (size_t i = 0; i < number_of_inserts; i++) {
+        const auto &insert = inserts[i];
+        auto idx = current_size + i;
+
+        schema_data[idx] = StringVector::AddStringOrBlob(schema_entry, insert.schema);
+        table_data[idx] = StringVector::AddStringOrBlob(table_entry, insert.table);
+        row_count_data[idx] = (int64_t)insert.row_count;
+        literal_count_data[idx] = (int64_t)insert.literal_count;
+
+        auto column_offset = ListVector::GetListSize(columns_entry);
+        auto number_of_columns = insert.columns.size();
+        if (ListVector::GetListCapacity(columns_entry) < column_offset + number_of_columns) {
+            ListVector::Reserve(columns_entry, column_offset + number_of_columns);
+        }
+        auto &column_vector = ListVector::GetEntry(columns_entry);
+        auto column_data = FlatVector::GetData<string_t>(column_vector);
+        for (size_t c = 0; c < number_of_columns; c++) {
+            column_data[column_offset + c] = StringVector::AddStringOrBlob(column_vector, insert.columns[c]);
+        }
+        ListVector::SetListSize(columns_entry, column_offset + number_of_columns);
+        columns_data[idx] = list_entry_t(column_offset, number_of_columns);
+    }
+
+    return list_entry_t(current_size, number_of_inserts);
+}
+
+static void ParseInsertValuesScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    UnaryExecutor::Execute<string_t, list_entry_t>(args.data[0], result, args.size(),
+    [&result](string_t query) -> list_entry_t {
+        std::vector<InsertValuesResult> inserts;
+        ExtractInsertValuesFromSQL(query.GetString(), inserts);
+        return WriteInsertValuesList(result, inserts);
+    });
+}
+
+// Extension scaffolding
+// ---------------------------------------------------
+
+void RegisterParseInsertValuesFunction(DatabaseInstance &db) {
+    // parse_insert_values summarizes INSERT ... VALUES statements without building an AST for the rows
+    auto return_type = LogicalType::LIST(LogicalType::STRUCT({
+        {"schema", LogicalType::VARCHAR},
+        {"table", LogicalType::VARCHAR},
+        {"columns", LogicalType::LIST(LogicalType::VARCHAR)},
+        {"row_count", LogicalType::BIGINT},
+        {"literal_count", LogicalType::BIGINT}
+    }));
+    ScalarFunction sf("parse_insert_values", {LogicalType::VARCHAR}, return_type, ParseInsertValuesScalarFunction);
+    ExtensionUtil::RegisterFunction(db, sf);
+}
+
+} // namespace duckdb
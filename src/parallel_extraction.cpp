@@ -0,0 +1,62 @@
+#include "parallel_extraction.hpp"
+#include "duckdb.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/parallel/task_executor.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
+#include <atomic>
+
+namespace duckdb {
+
+class ExtractRowsTask : public BaseExecutorTask {
+public:
+    ExtractRowsTask(TaskExecutor &executor, std::atomic<idx_t> &next_row, idx_t count,
+                    const std::function<void(idx_t row)> &extract)
+        : BaseExecutorTask(executor), next_row(next_row), count(count), extract(extract) {
+    }
+
+    void ExecuteTask() override {
+        // rows are claimed one at a time, so a few huge rows do not end up on the same task
+        for (auto row = next_row.fetch_add(1); row < count; row = next_row.fetch_add(1)) {
+            extract(row);
+        }
+    }
+
+private:
+    std::atomic<idx_t> &next_row;
+    idx_t count;
+    const std::function<void(idx_t row)> &extract;
+};
+
+void ExtractRows(ClientContext &context, idx_t count, idx_t input_bytes, const std::function<void(idx_t row)> &extract) {
+    auto threads = (idx_t)TaskScheduler::GetScheduler(context).NumberOfThreads();
+    if (count < 2 || threads < 2 || input_bytes < PARALLEL_CHUNK_MIN_BYTES) {
+        for (idx_t row = 0; row < count; row++) {
+            extract(row);
+        }
+        return;
+    }
+
+    std::atomic<idx_t> next_row(0);
+    TaskExecutor executor(context);
+    for (idx_t i = 0; i < MinValue(threads, count); i++) {
+        executor.ScheduleTask(make_uniq<ExtractRowsTask>(executor, next_row, count, extract));
+    }
+    // the calling thread works on the tasks as well, and only returns (or throws) once all are done
+    executor.WorkOnTasks();
+}
+
+idx_t InputBytes(Vector &input, idx_t count) {
+    UnifiedVectorFormat input_data;
+    input.ToUnifiedFormat(count, input_data);
+    auto strings = UnifiedVectorFormat::GetData<string_t>(input_data);
+    idx_t bytes = 0;
+    for (idx_t row = 0; row < count; row++) {
+        auto idx = input_data.sel->get_index(row);
+        if (input_data.validity.RowIsValid(idx)) {
+            bytes += strings[idx].GetSize();
+        }
+    }
+    return bytes;
+}
+
+} // namespace duckdb
@@ -0,0 +1,369 @@
+#include "parse_aggregations.hpp"
+#include "from_scope.hpp"
+#include "catalog_resolver.hpp"
+#include "parser_tools_limits.hpp"
+#include "duckdb.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include "duckdb/parser/parser.hpp"
+#include "duckdb/parser/parsed_expression_iterator.hpp"
+#include "duckdb/parser/result_modifier.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+#include "duckdb/parser/query_node/select_node.hpp"
+#include "duckdb/parser/expression/columnref_expression.hpp"
+#include "duckdb/parser/expression/constant_expression.hpp"
+#include <algorithm>
+
+namespace duckdb {
+
+static bool IsAggregateCall(const FunctionExpression &func, const AggregateFunctionFilter &is_aggregate) {
+    if (func.distinct || func.filter || (func.order_bys && !func.order_bys->orders.empty())) {
+        return true;
+    }
+    return is_aggregate(func);
+}
+
+// Aggregates are not searched inside subqueries, which are SELECT nodes of their own, nor inside
+// other aggregates, where they are not allowed
+static void FindAggregates(const ParsedExpression &expr, const AggregateFunctionFilter &is_aggregate,
+                           std::vector<const FunctionExpression *> &aggregates) {
+    if (!ExtractionBudget::Tick()) {
+        return;
+    }
+    if (expr.GetExpressionClass() == ExpressionClass::SUBQUERY) {
+        return;
+    }
+    if (expr.GetExpressionClass() == ExpressionClass::FUNCTION) {
+        auto &func = (FunctionExpression &)expr;
+        if (IsAggregateCall(func, is_aggregate)) {
+            aggregates.push_back(&func);
+            return;
+        }
+    }
+    ParsedExpressionIterator::EnumerateChildren(expr, [&](const ParsedExpression &child) {
+        FindAggregates(child, is_aggregate, aggregates);
+    });
+}
+
+static void FindColumns(const ParsedExpression &expr, std::vector<const ColumnRefExpression *> &columns) {
+    if (expr.GetExpressionClass() == ExpressionClass::SUBQUERY) {
+        return;
+    }
+    if (expr.GetExpressionClass() == ExpressionClass::COLUMN_REF) {
+        columns.push_back(&(const ColumnRefExpression &)expr);
+        return;
+    }
+    ParsedExpressionIterator::EnumerateChildren(expr, [&](const ParsedExpression &child) {
+        FindColumns(child, columns);
+    });
+}
+
+// Positional keys refer to the select list, e.g. GROUP BY 1
+static std::string GroupKeyToString(const SelectNode &node, const ParsedExpression &key) {
+    if (key.GetExpressionClass() == ExpressionClass::CONSTANT) {
+        auto &constant = (ConstantExpression &)key;
+        if (!constant.value.IsNull() && constant.value.type().IsIntegral()) {
+            auto position = constant.value.GetValue<int64_t>();
+            if (position >= 1 && idx_t(position) <= node.select_list.size()) {
+                return node.select_list[position - 1]->ToString();
+            }
+        }
+    }
+    return key.ToString();
+}
+
+static AggregateCallResult DescribeAggregate(const FunctionExpression &func, const FromScope &scope) {
+    AggregateCallResult result;
+    result.function_name = func.function_name;
+    result.is_distinct = func.distinct;
+    if (func.filter) {
+        result.filter = func.filter->ToString();
+    }
+
+    std::vector<const ColumnRefExpression *> column_refs;
+    for (auto &child : func.children) {
+        result.arguments.push_back(child->ToString());
+        FindColumns(*child, column_refs);
+    }
+    for (auto column_ref : column_refs) {
+        auto table = scope.ResolveColumn(*column_ref);
+        auto column = table.empty() ? column_ref->ToString() : table + "." + column_ref->GetColumnName();
+        if (std::find(result.columns.begin(), result.columns.end(), column) == result.columns.end()) {
+            result.columns.push_back(column);
+        }
+    }
+    return result;
+}
+
+static void ExtractAggregationsFromSelectNode(const SelectNode &node,
+                                              const std::vector<const CommonTableExpressionMap *> &ctes,
+                                              std::vector<AggregationResult> &results,
+                                              const AggregateFunctionFilter &is_aggregate) {
+    std::vector<const FunctionExpression *> aggregates;
+    for (auto &expr : node.select_list) {
+        FindAggregates(*expr, is_aggregate, aggregates);
+    }
+    if (node.having) {
+        FindAggregates(*node.having, is_aggregate, aggregates);
+    }
+    if (node.qualify) {
+        FindAggregates(*node.qualify, is_aggregate, aggregates);
+    }
+    for (auto &modifier : node.modifiers) {
+        if (modifier->type == ResultModifierType::ORDER_MODIFIER) {
+            auto &order_modifier = (OrderModifier &)*modifier;
+            for (auto &order : order_modifier.orders) {
+                FindAggregates(*order.expression, is_aggregate, aggregates);
+            }
+        }
+    }
+
+    bool group_by_all = node.aggregate_handling == AggregateHandling::FORCE_AGGREGATES;
+    if (node.groups.group_expressions.empty() && !group_by_all && aggregates.empty()) {
+        return;
+    }
+
+    FromScope scope(node, ctes);
+    AggregationResult result;
+    result.group_by_all = group_by_all;
+    scope.SourceTables(result.tables);
+
+    if (group_by_all) {
+        // the binder groups by every select list item that is not an aggregate
+        for (auto &expr : node.select_list) {
+            std::vector<const FunctionExpression *> item_aggregates;
+            FindAggregates(*expr, is_aggregate, item_aggregates);
+            if (item_aggregates.empty()) {
+                result.group_keys.push_back(expr->ToString());
+            }
+        }
+    } else {
+        for (auto &key : node.groups.group_expressions) {
+            result.group_keys.push_back(GroupKeyToString(node, *key));
+        }
+        for (auto &grouping_set : node.groups.grouping_sets) {
+            std::vector<std::string> keys;
+            for (auto index : grouping_set) {
+                if (index < result.group_keys.size()) {
+                    keys.push_back(result.group_keys[index]);
+                }
+            }
+            result.grouping_sets.push_back(std::move(keys));
+        }
+    }
+
+    for (auto func : aggregates) {
+        result.aggregates.push_back(DescribeAggregate(*func, scope));
+    }
+    results.push_back(std::move(result));
+}
+
+void ExtractAggregationsFromSQL(const std::string &sql, std::vector<AggregationResult> &results,
+                                const AggregateFunctionFilter &is_aggregate) {
+    if (!ExtractionBudget::AllowInput(sql)) {
+        return;
+    }
+
+    Parser parser;
+
+    try {
+        parser.ParseQuery(sql);
+    } catch (const ParserException &ex) {
+        return;
+    }
+
+    if (!ExtractionBudget::CheckDeadline()) {
+        return;
+    }
+
+    for (auto &stmt : parser.statements) {
+        if (stmt->type == StatementType::SELECT_STATEMENT) {
+            auto &select_stmt = (SelectStatement &)*stmt;
+            if (select_stmt.node) {
+                EnumerateSelectNodes(*select_stmt.node,
+                    [&](const SelectNode &node, const std::vector<const CommonTableExpressionMap *> &ctes) {
+                        ExtractAggregationsFromSelectNode(node, ctes, results, is_aggregate);
+                    });
+            }
+        }
+    }
+}
+
+// Appends the strings to the child of a LIST(VARCHAR) vector and returns the entry of the row
+static list_entry_t WriteStringList(Vector &list_vector, const std::vector<std::string> &strings) {
+    auto current_size = ListVector::GetListSize(list_vector);
+    auto new_size = current_size + strings.size();
+
+    // Grow list vector if needed
+    if (ListVector::GetListCapacity(list_vector) < new_size) {
+        ListVector::Reserve(list_vector, new_size);
+    }
+
+    auto &child = ListVector::GetEntry(list_vector);
+    auto child_data = FlatVector::GetData<string_t>(child);
+    for (size_t i = 0; i < strings.size(); i++) {
+        child_data[current_size + i] = StringVector::AddStringOrBlob(child, strings[i]);
+    }
+    ListVector::SetListSize(list_vector, new_size);
+    return list_entry_t(current_size, strings.size());
+}
+
+static list_entry_t WriteGroupingSetList(Vector &list_vector, const std::vector<std::vector<std::string>> &sets) {
+    auto current_size = ListVector::GetListSize(list_vector);
+    auto new_size = current_size + sets.size();
+
+    // Grow list vector if needed
+    if (ListVector::GetListCapacity(list_vector) < new_size) {
+        ListVector::Reserve(list_vector, new_size);
+    }
+    ListVector::SetListSize(list_vector, new_size);
+
+    auto &set_vector = ListVector::GetEntry(list_vector);
+    auto set_data = FlatVector::GetData<list_entry_t>(set_vector);
+    for (size_t i = 0; i < sets.size(); i++) {
+        set_data[current_size + i] = WriteStringList(set_vector, sets[i]);
+    }
+    return list_entry_t(current_size, sets.size());
+}
+
+static list_entry_t WriteAggregateCallList(Vector &list_vector, const std::vector<AggregateCallResult> &aggregates) {
+    auto current_size = ListVector::GetListSize(list_vector);
+    auto number_of_aggregates = aggregates.size();
+    auto new_size = current_size + number_of_aggregates;
+
+    // Grow list vector if needed
+    if (ListVector::GetListCapacity(list_vector) < new_size) {
+        ListVector::Reserve(list_vector, new_size);
+    }
+
+    // Get the struct child vector of the list
+    auto &struct_vector = ListVector::GetEntry(list_vector);
+
+    // Ensure list size is updated
+    ListVector::SetListSize(list_vector, new_size);
+
+    // Get the fields in the STRUCT
+    auto &entries = StructVector::GetEntries(struct_vector);
+    auto &function_name_entry = *entries[0]; // "function_name" field
+    auto &arguments_entry = *entries[1];     // "arguments" field
+    auto &columns_entry = *entries[2];       // "columns" field
+    auto &filter_entry = *entries[3];        // "filter" field
+    auto &is_distinct_entry = *entries[4];   // "is_distinct" field
+
+    auto function_name_data = FlatVector::GetData<string_t>(function_name_entry);
+    auto arguments_data = FlatVector::GetData<list_entry_t>(arguments_entry);
+    auto columns_data = FlatVector::GetData<list_entry_t>(columns_entry);
+    auto filter_data = FlatVector::GetData<string_t>(filter_entry);
+    auto is_distinct_data = FlatVector::GetData<bool>(is_distinct_entry);
+
+    for (size_t i = 0; i < number_of_aggregates; i++) {
+        const auto &aggregate = aggregates[i];
+        auto idx = current_size + i;
+
+        function_name_data[idx] = StringVector::AddStringOrBlob(function_name_entry, aggregate.function_name);
+        arguments_data[idx] = WriteStringList(arguments_entry, aggregate.arguments);
+        columns_data[idx] = WriteStringList(columns_entry, aggregate.columns);
+        if (aggregate.filter.empty()) {
+            FlatVector::SetNull(filter_entry, idx, true);
+        } else {
+            filter_data[idx] = StringVector::AddStringOrBlob(filter_entry, aggregate.filter);
+        }
+        is_distinct_data[idx] = aggregate.is_distinct;
+    }
+
+    return list_entry_t(current_size, number_of_aggregates);
+}
+
+static list_entry_t WriteAggregationList(Vector &result, const std::vector<AggregationResult> &aggregations) {
+    auto current_size = ListVector::GetListSize(result);
+    auto number_of_aggregations = aggregations.size();
+    auto new_size = current_size + number_of_aggregations;
+
+    // Grow list vector if needed
+    if (ListVector::GetListCapacity(result) < new_size) {
+        ListVector::Reserve(result, new_size);
+    }
+
+    // Get the struct child vector of the list
+    auto &struct_vector = ListVector::GetEntry(result);
+
+    // Ensure list size is updated
+    ListVector::SetListSize(result, new_size);
+
+    // Get the fields in the STRUCT
+    auto &entries = StructVector::GetEntries(struct_vector);
+    auto &tables_entry = *entries[0];        // "tables" field
+    auto &group_keys_entry = *entries[1];    // "group_keys" field
+    auto &grouping_sets_entry = *entries[2]; // "grouping_sets" field
+    auto &group_by_all_entry = *entries[3];  // "group_by_all" field
+    auto &aggregates_entry = *entries[4];    // "aggregates" field
+
+    auto tables_data = FlatVector::GetData<list_entry_t>(tables_entry);
+    auto group_keys_data = FlatVector::GetData<list_entry_t>(group_keys_entry);
+    auto grouping_sets_data = FlatVector::GetData<list_entry_t>(grouping_sets_entry);
+    auto group_by_all_data = FlatVector::GetData<bool>(group_by_all_entry);
+    auto aggregates_data = FlatVector::GetData<list_entry_t>(aggregates_entry);
+
+    for (size_t i = 0; i < number_of_aggregations; i++) {
+        const auto &aggregation = aggregations[i];
+        auto idx = current_size + i;
+
+        tables_data[idx] = WriteStringList(tables_entry, aggregation.tables);
+        group_keys_data[idx] = WriteStringList(group_keys_entry, aggregation.group_keys);
+        grouping_sets_data[idx] = WriteGroupingSetList(grouping_sets_entry, aggregation.grouping_sets);
+        group_by_all_data[idx] = aggregation.group_by_all;
+        aggregates_data[idx] = WriteAggregateCallList(aggregates_entry, aggregation.aggregates);
+    }
+
+    return list_entry_t(current_size, number_of_aggregations);
+}
+
+static void ParseAggregationsScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    auto &context = state.GetContext();
+    auto &resolver = GetCatalogResolver(state);
+    auto limits = ParserToolsLimits::Get(context);
+
+    AggregateFunctionFilter is_aggregate = [&](const FunctionExpression &func) {
+        auto &name = resolver.Resolve(context, ResolveKind::Function, func.catalog, func.schema, func.function_name);
+        return name.found && name.object_type == "aggregate_function";
+    };
+
+    UnaryExecutor::ExecuteWithNulls<string_t, list_entry_t>(args.data[0], result, args.size(),
+    [&](string_t query, ValidityMask &mask, idx_t row) -> list_entry_t {
+        std::vector<AggregationResult> aggregations;
+        ExtractionBudget budget(limits);
+        ExtractAggregationsFromSQL(query.GetString(), aggregations, is_aggregate);
+        if (!budget.KeepResult("parse_aggregations")) {
+            mask.SetInvalid(row);
+            return list_entry_t();
+        }
+        return WriteAggregationList(result, aggregations);
+    });
+}
+
+// Extension scaffolding
+// ---------------------------------------------------
+
+void RegisterParseAggregationsFunction(DatabaseInstance &db) {
+    // parse_aggregations describes the grouping of every SELECT node, e.g. to suggest rollups
+    auto aggregate_type = LogicalType::STRUCT({
+        {"function_name", LogicalType::VARCHAR},
+        {"arguments", LogicalType::LIST(LogicalType::VARCHAR)},
+        {"columns", LogicalType::LIST(LogicalType::VARCHAR)},
+        {"filter", LogicalType::VARCHAR},
+        {"is_distinct", LogicalType::BOOLEAN}
+    });
+    auto return_type = LogicalType::LIST(LogicalType::STRUCT({
+        {"tables", LogicalType::LIST(LogicalType::VARCHAR)},
+        {"group_keys", LogicalType::LIST(LogicalType::VARCHAR)},
+        {"grouping_sets", LogicalType::LIST(LogicalType::LIST(LogicalType::VARCHAR))},
+        {"group_by_all", LogicalType::BOOLEAN},
+        {"aggregates", LogicalType::LIST(aggregate_type)}
+    }));
+    ScalarFunction sf("parse_aggregations", {LogicalType::VARCHAR}, return_type, ParseAggregationsScalarFunction,
+                      CatalogResolverBind);
+    // aggregates are told apart from scalar functions through the catalog
+    sf.stability = FunctionStability::CONSISTENT_WITHIN_QUERY;
+    ExtensionUtil::RegisterFunction(db, sf);
+}
+
+} // namespace duckdb
@@ -0,0 +1,265 @@
+#include "parse_document.hpp"
+#include "sql_scanner.hpp"
+#include "duckdb.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/client_context_state.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include "duckdb/parser/parser.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+namespace duckdb {
+
+static const char *DOCUMENT_STATE_KEY = "parser_tools_documents";
+
+// ---------------------------------------------------
+// Incremental re-parse
+// ---------------------------------------------------
+
+static std::shared_ptr<const DocumentStatementResult> ParseStatement(const std::string &sql,
+                                                                     const ParserToolsLimits &limits) {
+    auto result = std::make_shared<DocumentStatementResult>();
+    ExtractionBudget budget(limits);
+    if (ExtractionBudget::AllowInput(sql)) {
+        std::string compacted;
+        bool use_compacted = sql.size() >= LITERAL_FAST_PATH_MIN_BYTES && CompactLiteralLists(sql, compacted);
+
+        Parser parser;
+        try {
+            parser.ParseQuery(use_compacted ? compacted : sql);
+            result->parsed = true;
+        } catch (const ParserException &ex) {
+            // reported as a statement that does not parse, the editor shows it as an error
+        }
+
+        if (result->parsed && ExtractionBudget::CheckDeadline()) {
+            for (auto &stmt : parser.statements) {
+                if (stmt->type == StatementType::SELECT_STATEMENT) {
+                    auto &select_stmt = (SelectStatement &)*stmt;
+                    if (select_stmt.node) {
+                        ExtractTablesFromQueryNode(*select_stmt.node, result->tables);
+                        ExtractFunctionsFromQueryNode(*select_stmt.node, result->functions);
+                    }
+                }
+            }
+        }
+    }
+    result->kept = budget.KeepResult("parse_document");
+    return std::move(result);
+}
+
+void IncrementalDocument::Update(const std::string &new_text, const ParserToolsLimits &limits) {
+    auto old_size = text.size();
+    auto new_size = new_text.size();
+    auto common = MinValue(old_size, new_size);
+
+    idx_t prefix = 0;
+    while (prefix < common && text[prefix] == new_text[prefix]) {
+        prefix++;
+    }
+    if (prefix == old_size && prefix == new_size) {
+        for (auto &statement : statements) {
+            statement.reparsed = false;
+        }
+        return;
+    }
+    idx_t suffix = 0;
+    while (suffix < common - prefix && text[old_size - 1 - suffix] == new_text[new_size - 1 - suffix]) {
+        suffix++;
+    }
+
+    std::vector<DocumentStatement> updated;
+    updated.reserve(statements.size() + 1);
+
+    // statements ended by a semicolon before the first changed byte are kept; scanning restarts
+    // just after the last of those semicolons, where the scanner is outside of any literal or comment
+    idx_t kept = 0;
+    while (kept < statements.size() && statements[kept].next <= prefix && statements[kept].next < old_size) {
+        updated.push_back(std::move(statements[kept]));
+        updated.back().reparsed = false;
+        kept++;
+    }
+    idx_t restart = updated.empty() ? 0 : updated.back().next;
+
+    // re-parse until a semicolon past the last changed byte that also ended a statement of the
+    // previous text: from there on both texts are the same, and so are their statements
+    idx_t reuse_from = statements.size();
+    StatementCursor cursor(new_text, restart);
+    idx_t start, end;
+    while (cursor.Next(start, end)) {
+        auto next = cursor.Position();
+        updated.push_back(
+            DocumentStatement{start, end, next, true, ParseStatement(new_text.substr(start, end - start), limits)});
+        if (next < new_size - suffix || next >= new_size) {
+            continue;
+        }
+        auto old_next = next + old_size - new_size;
+        auto match = std::lower_bound(statements.begin() + kept, statements.end(), old_next,
+                                      [](const DocumentStatement &statement, idx_t position) {
+                                          return statement.next < position;
+                                      });
+        if (match != statements.end() && match->next == old_next) {
+            reuse_from = idx_t(match - statements.begin()) + 1;
+            break;
+        }
+    }
+
+    for (idx_t i = reuse_from; i < statements.size(); i++) {
+        auto &statement = statements[i];
+        // unsigned arithmetic, the shifted offsets are never negative
+        statement.start = statement.start + new_size - old_size;
+        statement.end = statement.end + new_size - old_size;
+        statement.next = statement.next + new_size - old_size;
+        statement.reparsed = false;
+        updated.push_back(std::move(statement));
+    }
+
+    text = new_text;
+    statements = std::move(updated);
+}
+
+// The documents of a connection, by the name the editor gave them
+class DocumentSessionState : public ClientContextState {
+public:
+    std::mutex lock;
+    std::unordered_map<std::string, IncrementalDocument> documents;
+};
+
+// ---------------------------------------------------
+// parse_document
+// ---------------------------------------------------
+
+struct ParseDocumentBindData : public TableFunctionData {
+    std::string document;
+    std::string sql;
+};
+
+struct ParseDocumentState : public GlobalTableFunctionState {
+    std::vector<DocumentStatement> statements;
+    idx_t row = 0;
+};
+
+static LogicalType DocumentTableType() {
+    return LogicalType::STRUCT({
+        {"schema", LogicalType::VARCHAR},
+        {"table", LogicalType::VARCHAR},
+        {"context", LogicalType::VARCHAR}
+    });
+}
+
+static LogicalType DocumentFunctionType() {
+    return LogicalType::STRUCT({
+        {"function_name", LogicalType::VARCHAR},
+        {"schema", LogicalType::VARCHAR},
+        {"context", LogicalType::VARCHAR}
+    });
+}
+
+static unique_ptr<FunctionData> ParseDocumentBind(ClientContext &context, TableFunctionBindInput &input,
+                                                  vector<LogicalType> &return_types, vector<string> &names) {
+    if (input.inputs[0].IsNull() || input.inputs[1].IsNull()) {
+        throw BinderException("parse_document: document and sql must not be NULL");
+    }
+    auto result = make_uniq<ParseDocumentBindData>();
+    result->document = StringValue::Get(input.inputs[0]);
+    result->sql = StringValue::Get(input.inputs[1]);
+
+    return_types = {LogicalType::UBIGINT, LogicalType::UBIGINT, LogicalType::UBIGINT, LogicalType::BOOLEAN,
+                    LogicalType::BOOLEAN, LogicalType::LIST(DocumentTableType()),
+                    LogicalType::LIST(DocumentFunctionType())};
+    names = {"statement_index", "start_offset", "end_offset", "parsed", "reparsed", "tables", "functions"};
+    return std::move(result);
+}
+
+// The document is updated once per execution, not at bind time, which may happen more than once
+static unique_ptr<GlobalTableFunctionState> ParseDocumentInit(ClientContext &context, TableFunctionInitInput &input) {
+    auto &bind_data = (const ParseDocumentBindData &)*input.bind_data;
+    auto result = make_uniq<ParseDocumentState>();
+    auto limits = ParserToolsLimits::Get(context);
+
+    auto session = context.registered_state->GetOrCreate<DocumentSessionState>(DOCUMENT_STATE_KEY);
+    std::lock_guard<std::mutex> guard(session->lock);
+    auto &document = session->documents[bind_data.document];
+    document.Update(bind_data.sql, limits);
+    result->statements = document.Statements();
+    return std::move(result);
+}
+
+static Value TablesToValue(const DocumentStatementResult &result, const LogicalType &table_type) {
+    if (!result.kept) {
+        return Value(LogicalType::LIST(table_type));
+    }
+    vector<Value> tables;
+    for (auto &table : result.tables) {
+        child_list_t<Value> fields;
+        fields.emplace_back("schema", Value(table.schema));
+        fields.emplace_back("table", Value(table.table));
+        fields.emplace_back("context", Value(ToString(table.context)));
+        tables.push_back(Value::STRUCT(std::move(fields)));
+    }
+    return Value::LIST(table_type, std::move(tables));
+}
+
+static Value FunctionsToValue(const DocumentStatementResult &result, const LogicalType &function_type) {
+    if (!result.kept) {
+        return Value(LogicalType::LIST(function_type));
+    }
+    vector<Value> functions;
+    for (auto &function : result.functions) {
+        child_list_t<Value> fields;
+        fields.emplace_back("function_name", Value(function.function_name));
+        fields.emplace_back("schema", Value(function.schema));
+        fields.emplace_back("context", Value(function.context));
+        functions.push_back(Value::STRUCT(std::move(fields)));
+    }
+    return Value::LIST(function_type, std::move(functions));
+}
+
+static void ParseDocumentFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+    auto &state = (ParseDocumentState &)*data.global_state;
+    auto table_type = DocumentTableType();
+    auto function_type = DocumentFunctionType();
+
+    idx_t count = 0;
+    while (state.row < state.statements.size() && count < STANDARD_VECTOR_SIZE) {
+        auto &statement = state.statements[state.row];
+        output.SetValue(0, count, Value::UBIGINT(state.row));
+        output.SetValue(1, count, Value::UBIGINT(statement.start));
+        output.SetValue(2, count, Value::UBIGINT(statement.end));
+        output.SetValue(3, count, Value::BOOLEAN(statement.result->parsed));
+        output.SetValue(4, count, Value::BOOLEAN(statement.reparsed));
+        output.SetValue(5, count, TablesToValue(*statement.result, table_type));
+        output.SetValue(6, count, FunctionsToValue(*statement.result, function_type));
+
+        state.row++;
+        count++;
+    }
+    output.SetCardinality(count);
+}
+
+static void ParseDocumentCloseScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    auto session = state.GetContext().registered_state->GetOrCreate<DocumentSessionState>(DOCUMENT_STATE_KEY);
+    UnaryExecutor::Execute<string_t, bool>(args.data[0], result, args.size(), [&](string_t document) {
+        std::lock_guard<std::mutex> guard(session->lock);
+        return session->documents.erase(document.GetString()) > 0;
+    });
+}
+
+// Extension scaffolding
+// ---------------------------------------------------
+
+void RegisterParseDocumentFunctions(DatabaseInstance &db) {
+    // parse_document keeps the statements of a document between calls and only re-parses edited ones
+    TableFunction parse_document("parse_document", {LogicalType::VARCHAR, LogicalType::VARCHAR}, ParseDocumentFunction,
+                                 ParseDocumentBind, ParseDocumentInit);
+    ExtensionUtil::RegisterFunction(db, parse_document);
+
+    ScalarFunction close("parse_document_close", {LogicalType::VARCHAR}, LogicalType::BOOLEAN,
+                         ParseDocumentCloseScalarFunction);
+    close.stability = FunctionStability::VOLATILE;
+    ExtensionUtil::RegisterFunction(db, close);
+}
+
+} // namespace duckdb
@@ -0,0 +1,417 @@
+#include "parse_file_references.hpp"
+#include "from_scope.hpp"
+#include "parser_tools_limits.hpp"
+#include "duckdb.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include "duckdb/parser/parser.hpp"
+#include "duckdb/parser/expression/columnref_expression.hpp"
+#include "duckdb/parser/expression/comparison_expression.hpp"
+#include "duckdb/parser/expression/constant_expression.hpp"
+#include "duckdb/parser/expression/function_expression.hpp"
+#include "duckdb/parser/parsed_data/copy_info.hpp"
+#include "duckdb/parser/parsed_data/create_table_info.hpp"
+#include "duckdb/parser/statement/copy_statement.hpp"
+#include "duckdb/parser/statement/create_statement.hpp"
+#include "duckdb/parser/statement/explain_statement.hpp"
+#include "duckdb/parser/statement/insert_statement.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+#include "duckdb/parser/tableref/basetableref.hpp"
+#include "duckdb/parser/tableref/joinref.hpp"
+#include "duckdb/parser/tableref/table_function_ref.hpp"
+#include <cstring>
+
+namespace duckdb {
+
+// Table functions whose first argument is the file, list of files or glob pattern they read
+static const char *FILE_READING_FUNCTIONS[] = {
+    "read_csv", "read_csv_auto", "sniff_csv", "read_parquet", "parquet_scan", "parquet_metadata",
+    "parquet_schema", "parquet_file_metadata", "parquet_kv_metadata", "read_json", "read_json_auto",
+    "read_json_objects", "read_json_objects_auto", "read_ndjson", "read_ndjson_auto", "read_ndjson_objects",
+    "read_text", "read_blob", "glob", "iceberg_scan", "iceberg_metadata", "iceberg_snapshots", "delta_scan",
+    "read_xlsx", "read_avro", "st_read", "st_read_meta"
+};
+
+// Extensions DuckDB's replacement scans recognise, possibly followed by a compression suffix
+static const char *FILE_EXTENSIONS[] = {".csv", ".tsv", ".tbl", ".parquet", ".json", ".jsonl", ".ndjson", ".avro", ".xlsx"};
+static const char *COMPRESSION_SUFFIXES[] = {".gz", ".zst", ".bz2", ".lz4", ".xz"};
+
+static bool IsFileReadingFunction(const std::string &name) {
+    for (auto function : FILE_READING_FUNCTIONS) {
+        if (name == function) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool LooksLikeFilePath(const std::string &name) {
+    if (name.find("://") != std::string::npos) {
+        return true;
+    }
+    auto lower = StringUtil::Lower(name);
+    for (auto suffix : COMPRESSION_SUFFIXES) {
+        if (StringUtil::EndsWith(lower, suffix)) {
+            lower = lower.substr(0, lower.size() - strlen(suffix));
+            break;
+        }
+    }
+    for (auto extension : FILE_EXTENSIONS) {
+        if (StringUtil::EndsWith(lower, extension)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// A constant, or a list of constants, as a Value; false for anything that needs evaluating
+static bool ConstantArgument(const ParsedExpression &expr, Value &value) {
+    if (expr.GetExpressionClass() == ExpressionClass::CONSTANT) {
+        value = ((ConstantExpression &)expr).value;
+        return true;
+    }
+    if (expr.GetExpressionClass() == ExpressionClass::FUNCTION) {
+        auto &function = (FunctionExpression &)expr;
+        if (function.function_name != "list_value") {
+            return false;
+        }
+        vector<Value> elements;
+        for (auto &child : function.children) {
+            Value element;
+            if (!ConstantArgument(*child, element)) {
+                return false;
+            }
+            elements.push_back(std::move(element));
+        }
+        if (elements.empty()) {
+            return false;
+        }
+        value = Value::LIST(elements[0].type(), std::move(elements));
+        return true;
+    }
+    return false;
+}
+
+// The strings of a VARCHAR constant or a list of them
+static void AddFiles(const Value &value, std::vector<std::string> &files) {
+    if (value.IsNull()) {
+        return;
+    }
+    if (value.type().id() == LogicalTypeId::VARCHAR) {
+        files.push_back(StringValue::Get(value));
+    } else if (value.type().id() == LogicalTypeId::LIST) {
+        for (auto &element : ListValue::GetChildren(value)) {
+            AddFiles(element, files);
+        }
+    }
+}
+
+static void DescribeTableFunction(const TableFunctionRef &ref, std::vector<FileReferenceResult> &results) {
+    if (!ref.function || ref.function->GetExpressionClass() != ExpressionClass::FUNCTION) {
+        return;
+    }
+    auto &function = (FunctionExpression &)*ref.function;
+    FileReferenceResult result;
+    result.source = "table_function";
+    result.function_name = StringUtil::Lower(function.function_name);
+
+    bool first_positional = true;
+    Value first_value;
+    bool first_is_constant = false;
+    for (auto &child : function.children) {
+        // named parameters are written either as name := value or as name = value
+        std::string name = child->alias;
+        const ParsedExpression *argument = child.get();
+        if (name.empty() && child->GetExpressionClass() == ExpressionClass::COMPARISON &&
+            child->type == ExpressionType::COMPARE_EQUAL) {
+            auto &comparison = (ComparisonExpression &)*child;
+            if (comparison.left->GetExpressionClass() == ExpressionClass::COLUMN_REF) {
+                auto &column_ref = (ColumnRefExpression &)*comparison.left;
+                if (!column_ref.IsQualified()) {
+                    name = column_ref.GetColumnName();
+                    argument = comparison.right.get();
+                }
+            }
+        }
+
+        Value value;
+        bool is_constant = ConstantArgument(*argument, value);
+        if (name.empty() && first_positional) {
+            first_positional = false;
+            first_is_constant = is_constant;
+            first_value = value;
+        }
+        if (is_constant) {
+            result.arguments.push_back(FileArgumentResult{name, value.IsNull() ? "NULL" : value.ToString()});
+        }
+    }
+
+    // other table functions, e.g. of extensions, count as readers when their first argument is a path
+    if (first_is_constant) {
+        std::vector<std::string> files;
+        AddFiles(first_value, files);
+        bool reads_files = IsFileReadingFunction(result.function_name);
+        for (auto &file : files) {
+            reads_files = reads_files || LooksLikeFilePath(file);
+        }
+        if (reads_files) {
+            result.files = std::move(files);
+        }
+    }
+    results.push_back(std::move(result));
+}
+
+// Subqueries in the FROM clause are SELECT nodes of their own, only joins are followed here
+static void ExtractFileReferencesFromRef(const TableRef &ref, std::vector<FileReferenceResult> &results) {
+    if (!ExtractionBudget::Tick()) {
+        return;
+    }
+    switch (ref.type) {
+        case TableReferenceType::BASE_TABLE: {
+            auto &base = (BaseTableRef &)ref;
+            if (base.catalog_name.empty() && base.schema_name.empty() && LooksLikeFilePath(base.table_name)) {
+                FileReferenceResult result;
+                result.source = "replacement_scan";
+                result.files.push_back(base.table_name);
+                results.push_back(std::move(result));
+            }
+            break;
+        }
+        case TableReferenceType::JOIN: {
+            auto &join = (JoinRef &)ref;
+            ExtractFileReferencesFromRef(*join.left, results);
+            ExtractFileReferencesFromRef(*join.right, results);
+            break;
+        }
+        case TableReferenceType::TABLE_FUNCTION:
+            DescribeTableFunction((TableFunctionRef &)ref, results);
+            break;
+        default:
+            break;
+    }
+}
+
+static void ExtractFileReferencesFromQueryNode(const QueryNode &node, std::vector<FileReferenceResult> &results) {
+    EnumerateSelectNodes(node, [&](const SelectNode &select_node, const std::vector<const CommonTableExpressionMap *> &) {
+        if (select_node.from_table) {
+            ExtractFileReferencesFromRef(*select_node.from_table, results);
+        }
+    });
+}
+
+static void ExtractFileReferencesFromStatement(const SQLStatement &stmt, std::vector<FileReferenceResult> &results) {
+    switch (stmt.type) {
+        case StatementType::SELECT_STATEMENT: {
+            auto &select_stmt = (SelectStatement &)stmt;
+            if (select_stmt.node) {
+                ExtractFileReferencesFromQueryNode(*select_stmt.node, results);
+            }
+            break;
+        }
+        case StatementType::INSERT_STATEMENT: {
+            auto &insert = (InsertStatement &)stmt;
+            if (insert.select_statement && insert.select_statement->node) {
+                ExtractFileReferencesFromQueryNode(*insert.select_statement->node, results);
+            }
+            break;
+        }
+        case StatementType::CREATE_STATEMENT: {
+            auto &create = (CreateStatement &)stmt;
+            if (create.info->type == CatalogType::TABLE_ENTRY) {
+                auto &table_info = (CreateTableInfo &)*create.info;
+                if (table_info.query && table_info.query->node) {
+                    ExtractFileReferencesFromQueryNode(*table_info.query->node, results);
+                }
+            }
+            break;
+        }
+        case StatementType::COPY_STATEMENT: {
+            auto &copy = (CopyStatement &)stmt;
+            auto &info = *copy.info;
+            if (info.is_from) {
+                FileReferenceResult result;
+                result.source = "copy_from";
+                result.function_name = StringUtil::Lower(info.format);
+                result.files.push_back(info.file_path);
+                results.push_back(std::move(result));
+            } else if (info.select_statement) {
+                ExtractFileReferencesFromQueryNode(*info.select_statement, results);
+            }
+            break;
+        }
+        case StatementType::EXPLAIN_STATEMENT: {
+            auto &explain = (ExplainStatement &)stmt;
+            if (explain.stmt) {
+                ExtractFileReferencesFromStatement(*explain.stmt, results);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void ExtractFileReferencesFromSQL(const std::string &sql, std::vector<FileReferenceResult> &results) {
+    if (!ExtractionBudget::AllowInput(sql)) {
+        return;
+    }
+
+    Parser parser;
+
+    try {
+        parser.ParseQuery(sql);
+    } catch (const ParserException &ex) {
+        return;
+    }
+
+    if (!ExtractionBudget::CheckDeadline()) {
+        return;
+    }
+
+    for (auto &stmt : parser.statements) {
+        ExtractFileReferencesFromStatement(*stmt, results);
+    }
+}
+
+static LogicalType FileArgumentType() {
+    return LogicalType::STRUCT({
+        {"name", LogicalType::VARCHAR},
+        {"value", LogicalType::VARCHAR}
+    });
+}
+
+// Writes the string, or NULL if it is empty
+static void WriteStringOrNull(Vector &vector, string_t *data, idx_t idx, const std::string &str) {
+    if (str.empty()) {
+        FlatVector::SetNull(vector, idx, true);
+    } else {
+        data[idx] = StringVector::AddStringOrBlob(vector, str);
+    }
+}
+
+static list_entry_t WriteFileList(Vector &list_vector, const std::vector<std::string> &files) {
+    auto current_size = ListVector::GetListSize(list_vector);
+    auto new_size = current_size + files.size();
+
+    // Grow list vector if needed
+    if (ListVector::GetListCapacity(list_vector) < new_size) {
+        ListVector::Reserve(list_vector, new_size);
+    }
+
+    auto &child = ListVector::GetEntry(list_vector);
+    auto child_data = FlatVector::GetData<string_t>(child);
+    for (size_t i = 0; i < files.size(); i++) {
+        child_data[current_size + i] = StringVector::AddStringOrBlob(child, files[i]);
+    }
+    ListVector::SetListSize(list_vector, new_size);
+    return list_entry_t(current_size, files.size());
+}
+
+static list_entry_t WriteArgumentList(Vector &list_vector, const std::vector<FileArgumentResult> &arguments) {
+    auto current_size = ListVector::GetListSize(list_vector);
+    auto number_of_arguments = arguments.size();
+    auto new_size = current_size + number_of_arguments;
+
+    // Grow list vector if needed
+    if (ListVector::GetListCapacity(list_vector) < new_size) {
+        ListVector::Reserve(list_vector, new_size);
+    }
+
+    // Get the struct child vector of the list
+    auto &struct_vector = ListVector::GetEntry(list_vector);
+
+    // Ensure list size is updated
+    ListVector::SetListSize(list_vector, new_size);
+
+    // Get the fields in the STRUCT
+    auto &entries = StructVector::GetEntries(struct_vector);
+    auto &name_entry = *entries[0];  // "name" field
+    auto &value_entry = *entries[1]; // "value" field
+
+    auto name_data = FlatVector::GetData<string_t>(name_entry);
+    auto value_data = FlatVector::GetData<string_t>(value_entry);
+
+    for (size_t i = 0; i < number_of_arguments; i++) {
+        const auto &argument = arguments[i];
+        auto idx = current_size + i;
+
+        WriteStringOrNull(name_entry, name_data, idx, argument.name);
+        value_data[idx] = StringVector::AddStringOrBlob(value_entry, argument.value);
+    }
+
+    return list_entry_t(current_size, number_of_arguments);
+}
+
+static list_entry_t WriteFileReferenceList(Vector &result, const std::vector<FileReferenceResult> &references) {
+    auto current_size = ListVector::GetListSize(result);
+    auto number_of_references = references.size();
+    auto new_size = current_size + number_of_references;
+
+    // Grow list vector if needed
+    if (ListVector::GetListCapacity(result) < new_size) {
+        ListVector::Reserve(result, new_size);
+    }
+
+    // Get the struct child vector of the list
+    auto &struct_vector = ListVector::GetEntry(result);
+
+    // Ensure list size is updated
+    ListVector::SetListSize(result, new_size);
+
+    // Get the fields in the STRUCT
+    auto &entries = StructVector::GetEntries(struct_vector);
+    auto &source_entry = *entries[0];        // "source" field
+    auto &function_name_entry = *entries[1]; // "function_name" field
+    auto &arguments_entry = *entries[2];     // "arguments" field
+    auto &files_entry = *entries[3];         // "files" field
+
+    auto source_data = FlatVector::GetData<string_t>(source_entry);
+    auto function_name_data = FlatVector::GetData<string_t>(function_name_entry);
+    auto arguments_data = FlatVector::GetData<list_entry_t>(arguments_entry);
+    auto files_data = FlatVector::GetData<list_entry_t>(files_entry);
+
+    for (size_t i = 0; i < number_of_references; i++) {
+        const auto &reference = references[i];
+        auto idx = current_size + i;
+
+        source_data[idx] = StringVector::AddStringOrBlob(source_entry, reference.source);
+        WriteStringOrNull(function_name_entry, function_name_data, idx, reference.function_name);
+        arguments_data[idx] = WriteArgumentList(arguments_entry, reference.arguments);
+        files_data[idx] = WriteFileList(files_entry, reference.files);
+    }
+
+    return list_entry_t(current_size, number_of_references);
+}
+
+static void ParseFileReferencesScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    auto limits = ParserToolsLimits::Get(state.GetContext());
+
+    UnaryExecutor::ExecuteWithNulls<string_t, list_entry_t>(args.data[0], result, args.size(),
+    [&](string_t query, ValidityMask &mask, idx_t row) -> list_entry_t {
+        std::vector<FileReferenceResult> references;
+        ExtractionBudget budget(limits);
+        ExtractFileReferencesFromSQL(query.GetString(), references);
+        if (!budget.KeepResult("parse_file_references")) {
+            mask.SetInvalid(row);
+            return list_entry_t();
+        }
+        return WriteFileReferenceList(result, references);
+    });
+}
+
+// Extension scaffolding
+// ---------------------------------------------------
+
+void RegisterParseFileReferencesFunction(DatabaseInstance &db) {
+    // parse_file_references lists the files a query would read, e.g. to warm a cache before it runs
+    auto return_type = LogicalType::LIST(LogicalType::STRUCT({
+        {"source", LogicalType::VARCHAR},
+        {"function_name", LogicalType::VARCHAR},
+        {"arguments", LogicalType::LIST(FileArgumentType())},
+        {"files", LogicalType::LIST(LogicalType::VARCHAR)}
+    }));
+    ScalarFunction sf("parse_file_references", {LogicalType::VARCHAR}, return_type, ParseFileReferencesScalarFunction);
+    ExtensionUtil::RegisterFunction(db, sf);
+}
+
+} // namespace duckdb
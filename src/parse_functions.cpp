@@ -1,50 +1,40 @@
 #include "parse_functions.hpp"
+#include "parser_tools_limits.hpp"
+#include "catalog_resolver.hpp"
+#include "tolerant_extractor.hpp"
+#include "sql_scanner.hpp"
+#include "parallel_extraction.hpp"
 #include "duckdb.hpp"
-#include "duckdb/parser/parser.hpp"
-#include "duckdb/parser/statement/select_statement.hpp"
-#include "duckdb/parser/query_node/select_node.hpp"
-#include "duckdb/parser/expression/function_expression.hpp"
-#include "duckdb/parser/expression/window_expression.hpp"
-#include "duckdb/parser/parsed_expression_iterator.hpp"
-#include "duckdb/parser/result_modifier.hpp"
 #include "duckdb/main/extension_util.hpp"
+#include "duckdb/storage/statistics/node_statistics.hpp"
 #include "duckdb/function/scalar/nested_functions.hpp"
 
 
 namespace duckdb {
 
-enum class FunctionContext {
-	Select,
-	Where,
-	Having,
-	OrderBy,
-	GroupBy,
-	Join,
-	WindowFunction,
-	Nested
+struct ParseFunctionsBindData : public TableFunctionData {
+	string sql;
+	// extracted once at bind time, shared by every scan of the (prepared) statement
+	vector<FunctionResult> results;
+	// large inputs are instead extracted by the scan, one statement at a time
+	bool statement_at_a_time = false;
+	// resolve := true, resolved[i] is the catalog entry of results[i]
+	bool resolve = false;
+	vector<ResolvedName> resolved;
+	// tolerant := true, exact[i] is false if results[i] was recovered from SQL that does not parse
+	bool tolerant = false;
+	vector<bool> exact;
 };
 
-inline const char *ToString(FunctionContext context) {
-	switch (context) {
-		case FunctionContext::Select: return "select";
-		case FunctionContext::Where: return "where";
-		case FunctionContext::Having: return "having";
-		case FunctionContext::OrderBy: return "order_by";
-		case FunctionContext::GroupBy: return "group_by";
-		case FunctionContext::Join: return "join";
-		case FunctionContext::WindowFunction: return "window";
-		case FunctionContext::Nested: return "nested";
-		default: return "unknown";
-	}
-}
-
 struct ParseFunctionsState : public GlobalTableFunctionState {
 	idx_t row = 0;
+	// statement at a time: the results of the current statement only
+	unique_ptr<StatementCursor> cursor;
+	ParserToolsLimits limits;
 	vector<FunctionResult> results;
-};
-
-struct ParseFunctionsBindData : public TableFunctionData {
-	string sql;
+	vector<ResolvedName> resolved;
+	vector<bool> exact;
+	CatalogResolver resolver;
 };
 
 // BIND function: runs during query planning to decide output schema
@@ -55,237 +45,346 @@ static unique_ptr<FunctionData> ParseFunctionsBind(ClientContext &context,
 
 	string sql_input = StringValue::Get(input.inputs[0]);
 
-	// always return the same columns:
-	return_types = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR};
-	// function name, schema name, usage context
-	names = {"function_name", "schema", "context"};
-
 	// create a bind data object to hold the SQL input
 	auto result = make_uniq<ParseFunctionsBindData>();
 	result->sql = sql_input;
 
+	auto resolve = input.named_parameters.find("resolve");
+	if (resolve != input.named_parameters.end() && !resolve->second.IsNull()) {
+		result->resolve = BooleanValue::Get(resolve->second);
+	}
+	auto tolerant = input.named_parameters.find("tolerant");
+	if (tolerant != input.named_parameters.end() && !tolerant->second.IsNull()) {
+		result->tolerant = BooleanValue::Get(tolerant->second);
+	}
+
+	if (result->resolve) {
+		return_types = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR,
+		                LogicalType::VARCHAR};
+		// function name, catalog and schema of the catalog entry, entry type, usage context
+		names = {"function_name", "catalog", "schema", "object_type", "context"};
+	} else {
+		return_types = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR};
+		// function name, schema name, usage context
+		names = {"function_name", "schema", "context"};
+	}
+	if (result->tolerant) {
+		return_types.push_back(LogicalType::BOOLEAN);
+		names.push_back("exact");
+	}
+
+	// parse during binding so the optimizer knows the exact cardinality
+	auto limits = ParserToolsLimits::Get(context);
+	ExtractionBudget budget(limits);
+	if (result->sql.size() >= STATEMENT_AT_A_TIME_MIN_BYTES && ExtractionBudget::AllowInputSize(result->sql.size())) {
+		result->statement_at_a_time = true;
+	} else if (result->tolerant) {
+		ExtractFunctionsFromSQLTolerant(result->sql, result->results, result->exact);
+	} else {
+		ExtractFunctionsFromSQL(result->sql, result->results);
+	}
+	if (!budget.KeepResult("parse_functions")) {
+		result->results.clear();
+		result->exact.clear();
+	}
+
+	if (result->resolve) {
+		CatalogResolver resolver;
+		ResolveFunctions(context, resolver, result->results, result->resolved);
+	}
+
 	return std::move(result);
 }
 
+static unique_ptr<NodeStatistics> ParseFunctionsCardinality(ClientContext &context, const FunctionData *bind_data_p) {
+	auto &bind_data = (const ParseFunctionsBindData &)*bind_data_p;
+	if (bind_data.statement_at_a_time) {
+		return make_uniq<NodeStatistics>();
+	}
+	return make_uniq<NodeStatistics>(bind_data.results.size(), bind_data.results.size());
+}
+
 // INIT function: runs before table function execution
 static unique_ptr<GlobalTableFunctionState> ParseFunctionsInit(ClientContext &context,
 																														TableFunctionInitInput &input) {
-	return make_uniq<ParseFunctionsState>();
+	auto &bind_data = (const ParseFunctionsBindData &)*input.bind_data;
+	auto result = make_uniq<ParseFunctionsState>();
+	if (bind_data.statement_at_a_time) {
+		result->cursor = make_uniq<StatementCursor>(bind_data.sql);
+		result->limits = ParserToolsLimits::Get(context);
+	}
+	return std::move(result);
 }
 
-class FunctionExtractor {
-public:
-	static void ExtractFromExpression(const ParsedExpression &expr, 
-																					std::vector<FunctionResult> &results,
-																					FunctionContext context = FunctionContext::Select) {
-		if (expr.expression_class == ExpressionClass::FUNCTION) {
-			auto &func = (FunctionExpression &)expr;
-			results.push_back(FunctionResult{
-				func.function_name,
-				func.schema.empty() ? "main" : func.schema,
-				ToString(context)
-			});
-			
-			// For nested function calls within this function, mark as nested
-			ParsedExpressionIterator::EnumerateChildren(expr, [&](const ParsedExpression &child) {
-				ExtractFromExpression(child, results, FunctionContext::Nested);
-			});
-		} else if (expr.expression_class == ExpressionClass::WINDOW) {
-			auto &window_expr = (WindowExpression &)expr;
-			results.push_back(FunctionResult{
-				window_expr.function_name,
-				window_expr.schema.empty() ? "main" : window_expr.schema,
-				ToString(context)
-			});
-			
-			// Extract functions from window function arguments
-			for (const auto &child : window_expr.children) {
-				if (child) {
-					ExtractFromExpression(*child, results, FunctionContext::Nested);
-				}
-			}
-			
-			// Extract functions from PARTITION BY expressions
-			for (const auto &partition : window_expr.partitions) {
-				if (partition) {
-					ExtractFromExpression(*partition, results, FunctionContext::Nested);
-				}
-			}
-			
-			// Extract functions from ORDER BY expressions
-			for (const auto &order : window_expr.orders) {
-				if (order.expression) {
-					ExtractFromExpression(*order.expression, results, FunctionContext::Nested);
-				}
-			}
-			
-			// Extract functions from argument ordering expressions
-			for (const auto &arg_order : window_expr.arg_orders) {
-				if (arg_order.expression) {
-					ExtractFromExpression(*arg_order.expression, results, FunctionContext::Nested);
-				}
-			}
-			
-			// Extract functions from frame expressions
-			if (window_expr.start_expr) {
-				ExtractFromExpression(*window_expr.start_expr, results, FunctionContext::Nested);
-			}
-			if (window_expr.end_expr) {
-				ExtractFromExpression(*window_expr.end_expr, results, FunctionContext::Nested);
-			}
-			if (window_expr.offset_expr) {
-				ExtractFromExpression(*window_expr.offset_expr, results, FunctionContext::Nested);
-			}
-			if (window_expr.default_expr) {
-				ExtractFromExpression(*window_expr.default_expr, results, FunctionContext::Nested);
-			}
-			
-			// Extract functions from filter expression
-			if (window_expr.filter_expr) {
-				ExtractFromExpression(*window_expr.filter_expr, results, FunctionContext::Nested);
-			}
+// Replaces the scan's results with those of the next statement that has any, returns false at the
+// end of the input. The resource limits apply to each statement on its own.
+static bool ExtractNextStatement(ClientContext &context, const ParseFunctionsBindData &bind_data,
+                                 ParseFunctionsState &state) {
+	state.results.clear();
+	state.resolved.clear();
+	state.exact.clear();
+	state.row = 0;
+	std::string statement;
+	while (state.results.empty() && state.cursor->Next(statement)) {
+		ExtractionBudget budget(state.limits);
+		if (bind_data.tolerant) {
+			ExtractFunctionsFromSQLTolerant(statement, state.results, state.exact);
 		} else {
-			// For non-function expressions, preserve the current context
-			ParsedExpressionIterator::EnumerateChildren(expr, [&](const ParsedExpression &child) {
-				ExtractFromExpression(child, results, context);
-			});
+			ExtractFunctionsFromSQL(statement, state.results);
 		}
-	}
-
-	static void ExtractFromExpressionList(const vector<unique_ptr<ParsedExpression>> &expressions,
-																								std::vector<FunctionResult> &results,
-																								FunctionContext context) {
-		for (const auto &expr : expressions) {
-			if (expr) {
-				ExtractFromExpression(*expr, results, context);
-			}
+		if (!budget.KeepResult("parse_functions")) {
+			state.results.clear();
+			state.exact.clear();
 		}
 	}
-};
-
-
-static void ExtractFunctionsFromQueryNode(const QueryNode &node, std::vector<FunctionResult> &results) {
-	if (node.type == QueryNodeType::SELECT_NODE) {
-		auto &select_node = (SelectNode &)node;
+	if (bind_data.resolve) {
+		ResolveFunctions(context, state.resolver, state.results, state.resolved);
+	}
+	return !state.results.empty();
+}
 
-		// Extract from CTEs first (to match expected order in tests)
-		for (const auto &cte : select_node.cte_map.map) {
-			if (cte.second && cte.second->query && cte.second->query->node) {
-				ExtractFunctionsFromQueryNode(*cte.second->query->node, results);
+static void ParseFunctionsFunction(ClientContext &context,
+																				TableFunctionInput &data,
+																				DataChunk &output) {
+	auto &state = (ParseFunctionsState &)*data.global_state;
+	auto &bind_data = (ParseFunctionsBindData &)*data.bind_data;
+	auto &results = bind_data.statement_at_a_time ? state.results : bind_data.results;
+	auto &resolved_names = bind_data.statement_at_a_time ? state.resolved : bind_data.resolved;
+	auto &exact = bind_data.statement_at_a_time ? state.exact : bind_data.exact;
+
+	idx_t count = 0;
+	while (count < STANDARD_VECTOR_SIZE) {
+		if (state.row >= results.size()) {
+			if (bind_data.statement_at_a_time && ExtractNextStatement(context, bind_data, state)) {
+				continue;
 			}
+			break;
 		}
-
-		// Extract from SELECT list
-		FunctionExtractor::ExtractFromExpressionList(select_node.select_list, results, FunctionContext::Select);
-
-		// Extract from WHERE clause
-		if (select_node.where_clause) {
-			FunctionExtractor::ExtractFromExpression(*select_node.where_clause, results, FunctionContext::Where);
+		auto &func = results[state.row];
+		if (bind_data.resolve) {
+			auto &resolved = resolved_names[state.row];
+			output.SetValue(0, count, Value(resolved.name));
+			output.SetValue(1, count, resolved.found ? Value(resolved.catalog) : Value());
+			output.SetValue(2, count, Value(resolved.schema));
+			output.SetValue(3, count, resolved.found ? Value(resolved.object_type) : Value());
+			output.SetValue(4, count, Value(func.context));
+		} else {
+			output.SetValue(0, count, Value(func.function_name));
+			output.SetValue(1, count, Value(func.schema));
+			output.SetValue(2, count, Value(func.context));
 		}
-
-		// Extract from GROUP BY clause
-		FunctionExtractor::ExtractFromExpressionList(select_node.groups.group_expressions, results, FunctionContext::GroupBy);
-
-		// Extract from HAVING clause
-		if (select_node.having) {
-			FunctionExtractor::ExtractFromExpression(*select_node.having, results, FunctionContext::Having);
+		if (bind_data.tolerant) {
+			output.SetValue(bind_data.resolve ? 5 : 3, count, Value::BOOLEAN(exact[state.row]));
 		}
 
-		// Extract from ORDER BY clause
-		for (const auto &modifier : select_node.modifiers) {
-			if (modifier->type == ResultModifierType::ORDER_MODIFIER) {
-				auto &order_modifier = (OrderModifier &)*modifier;
-				for (const auto &order : order_modifier.orders) {
-					if (order.expression) {
-						FunctionExtractor::ExtractFromExpression(*order.expression, results, FunctionContext::OrderBy);
-					}
-				}
-			}
-		}
+		state.row++;
+		count++;
 	}
+	output.SetCardinality(count);
 }
 
-static void ExtractFunctionsFromSQL(const std::string &sql, std::vector<FunctionResult> &results) {
-	Parser parser;
+// The functions of one row, extracted before any result of the chunk is written
+struct FunctionExtraction {
+	bool keep = false;
+	std::vector<FunctionResult> functions;
+	std::vector<bool> exact;
+};
+
+list_entry_t WriteFunctionNameList(Vector &result, const std::vector<FunctionResult> &parsed_functions) {
+	auto current_size = ListVector::GetListSize(result);
+	auto number_of_functions = parsed_functions.size();
+	auto new_size = current_size + number_of_functions;
 
-	try {
-		parser.ParseQuery(sql);
-	} catch (const ParserException &ex) {
-		// swallow parser exceptions to make this function more robust. is_parsable can be used if needed
-		return;
+	// grow list if needed
+	if (ListVector::GetListCapacity(result) < new_size) {
+		ListVector::Reserve(result, new_size);
 	}
 
-	for (auto &stmt : parser.statements) {
-		if (stmt->type == StatementType::SELECT_STATEMENT) {
-			auto &select_stmt = (SelectStatement &)*stmt;
-			if (select_stmt.node) {
-				ExtractFunctionsFromQueryNode(*select_stmt.node, results);
-			}
-		}
+	// Write the function names into the child vector
+	auto functions = FlatVector::GetData<string_t>(ListVector::GetEntry(result));
+	for (size_t i = 0; i < parsed_functions.size(); i++) {
+		auto &func = parsed_functions[i];
+		functions[current_size + i] = StringVector::AddStringOrBlob(ListVector::GetEntry(result), func.function_name);
 	}
+
+	// Update size
+	ListVector::SetListSize(result, new_size);
+
+	return list_entry_t(current_size, number_of_functions);
 }
 
-static void ParseFunctionsFunction(ClientContext &context,
-																				TableFunctionInput &data,
-																				DataChunk &output) {
-	auto &state = (ParseFunctionsState &)*data.global_state;
-	auto &bind_data = (ParseFunctionsBindData &)*data.bind_data;
+list_entry_t WriteFunctionStructList(Vector &result, const std::vector<FunctionResult> &parsed_functions) {
+	auto current_size = ListVector::GetListSize(result);
+	auto number_of_functions = parsed_functions.size();
+	auto new_size = current_size + number_of_functions;
 
-	if (state.results.empty() && state.row == 0) {
-		ExtractFunctionsFromSQL(bind_data.sql, state.results);
+	// Grow list vector if needed
+	if (ListVector::GetListCapacity(result) < new_size) {
+		ListVector::Reserve(result, new_size);
 	}
 
-	if (state.row >= state.results.size()) {
-		return;
-	}
+	// Get the struct child vector of the list
+	auto &struct_vector = ListVector::GetEntry(result);
+
+	// Ensure list size is updated
+	ListVector::SetListSize(result, new_size);
+
+	// Get the fields in the STRUCT
+	auto &entries = StructVector::GetEntries(struct_vector);
+	auto &function_name_entry = *entries[0]; // "function_name" field
+	auto &schema_entry = *entries[1];  // "schema" field
+	auto &context_entry = *entries[2]; // "context" field
 
-	auto &func = state.results[state.row];
-	output.SetCardinality(1);
-	output.SetValue(0, 0, Value(func.function_name));
-	output.SetValue(1, 0, Value(func.schema));
-	output.SetValue(2, 0, Value(func.context));
+	auto function_name_data = FlatVector::GetData<string_t>(function_name_entry);
+	auto schema_data = FlatVector::GetData<string_t>(schema_entry);
+	auto context_data = FlatVector::GetData<string_t>(context_entry);
 
-	state.row++;
+	for (size_t i = 0; i < number_of_functions; i++) {
+		const auto &func = parsed_functions[i];
+		auto idx = current_size + i;
+
+		function_name_data[idx] = StringVector::AddStringOrBlob(function_name_entry, func.function_name);
+		schema_data[idx] = StringVector::AddStringOrBlob(schema_entry, func.schema);
+		context_data[idx] = StringVector::AddStringOrBlob(context_entry, func.context);
+	}
+
+	return list_entry_t(current_size, number_of_functions);
 }
 
 static void ParseFunctionNamesScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	UnaryExecutor::Execute<string_t, list_entry_t>(args.data[0], result, args.size(),
-	[&result](string_t query) -> list_entry_t {
-		// Parse the SQL query and extract function names
-		auto query_string = query.GetString();
-		std::vector<FunctionResult> parsed_functions;
-		ExtractFunctionsFromSQL(query_string, parsed_functions);
+	std::vector<FunctionExtraction> extractions;
+	ExtractChunk(state.GetContext(), args, "parse_function_names", extractions,
+	[](const std::string &query_string, idx_t row, FunctionExtraction &extraction) {
+		ExtractFunctionsFromSQL(query_string, extraction.functions);
+	});
+
+	UnaryExecutor::ExecuteWithNulls<string_t, list_entry_t>(args.data[0], result, args.size(),
+	[&result, &extractions](string_t query, ValidityMask &mask, idx_t row) -> list_entry_t {
+		if (!extractions[row].keep) {
+			mask.SetInvalid(row);
+			return list_entry_t();
+		}
+		return WriteFunctionNameList(result, extractions[row].functions);
+	});
+}
+
+static void ParseFunctionsScalarFunction_struct(DataChunk &args, ExpressionState &state, Vector &result) {
+	std::vector<FunctionExtraction> extractions;
+	ExtractChunk(state.GetContext(), args, "parse_functions", extractions,
+	[](const std::string &query_string, idx_t row, FunctionExtraction &extraction) {
+		ExtractFunctionsFromSQL(query_string, extraction.functions);
+	});
+
+	UnaryExecutor::ExecuteWithNulls<string_t, list_entry_t>(args.data[0], result, args.size(),
+	[&result, &extractions](string_t query, ValidityMask &mask, idx_t row) -> list_entry_t {
+		if (!extractions[row].keep) {
+			mask.SetInvalid(row);
+			return list_entry_t();
+		}
+		return WriteFunctionStructList(result, extractions[row].functions);
+	});
+}
+
+static void ParseFunctionsTolerantScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	UnifiedVectorFormat tolerant_data;
+	args.data[1].ToUnifiedFormat(args.size(), tolerant_data);
+	auto tolerant_flags = UnifiedVectorFormat::GetData<bool>(tolerant_data);
+
+	std::vector<FunctionExtraction> extractions;
+	ExtractChunk(state.GetContext(), args, "parse_functions", extractions,
+	[&](const std::string &query_string, idx_t row, FunctionExtraction &extraction) {
+		auto tolerant_idx = tolerant_data.sel->get_index(row);
+		if (!tolerant_data.validity.RowIsValid(tolerant_idx)) {
+			return;
+		}
+		if (tolerant_flags[tolerant_idx]) {
+			ExtractFunctionsFromSQLTolerant(query_string, extraction.functions, extraction.exact);
+		} else {
+			ExtractFunctionsFromSQL(query_string, extraction.functions);
+			extraction.exact.resize(extraction.functions.size(), true);
+		}
+	});
+
+	BinaryExecutor::ExecuteWithNulls<string_t, bool, list_entry_t>(args.data[0], args.data[1], result, args.size(),
+	[&result, &extractions](string_t query, bool tolerant, ValidityMask &mask, idx_t row) -> list_entry_t {
+		if (!extractions[row].keep) {
+			mask.SetInvalid(row);
+			return list_entry_t();
+		}
+		auto &parsed_functions = extractions[row].functions;
+		auto &exact = extractions[row].exact;
 
 		auto current_size = ListVector::GetListSize(result);
 		auto number_of_functions = parsed_functions.size();
 		auto new_size = current_size + number_of_functions;
 
-		// grow list if needed
+		// Grow list vector if needed
 		if (ListVector::GetListCapacity(result) < new_size) {
 			ListVector::Reserve(result, new_size);
 		}
 
-		// Write the function names into the child vector
-		auto functions = FlatVector::GetData<string_t>(ListVector::GetEntry(result));
-		for (size_t i = 0; i < parsed_functions.size(); i++) {
-			auto &func = parsed_functions[i];
-			functions[current_size + i] = StringVector::AddStringOrBlob(ListVector::GetEntry(result), func.function_name);
-		}
+		// Get the struct child vector of the list
+		auto &struct_vector = ListVector::GetEntry(result);
 
-		// Update size
+		// Ensure list size is updated
 		ListVector::SetListSize(result, new_size);
 
+		// Get the fields in the STRUCT
+		auto &entries = StructVector::GetEntries(struct_vector);
+		auto &function_name_entry = *entries[0]; // "function_name" field
+		auto &schema_entry = *entries[1];  // "schema" field
+		auto &context_entry = *entries[2]; // "context" field
+		auto &exact_entry = *entries[3];   // "exact" field
+
+		auto function_name_data = FlatVector::GetData<string_t>(function_name_entry);
+		auto schema_data = FlatVector::GetData<string_t>(schema_entry);
+		auto context_data = FlatVector::GetData<string_t>(context_entry);
+		auto exact_data = FlatVector::GetData<bool>(exact_entry);
+
+		for (size_t i = 0; i < number_of_functions; i++) {
+			const auto &func = parsed_functions[i];
+			auto idx = current_size + i;
+
+			function_name_data[idx] = StringVector::AddStringOrBlob(function_name_entry, func.function_name);
+			schema_data[idx] = StringVector::AddStringOrBlob(schema_entry, func.schema);
+			context_data[idx] = StringVector::AddStringOrBlob(context_entry, func.context);
+			exact_data[idx] = exact[i];
+		}
+
 		return list_entry_t(current_size, number_of_functions);
 	});
 }
 
-static void ParseFunctionsScalarFunction_struct(DataChunk &args, ExpressionState &state, Vector &result) {
-	UnaryExecutor::Execute<string_t, list_entry_t>(args.data[0], result, args.size(),
-	[&result](string_t query) -> list_entry_t {
-		// Parse the SQL query and extract function names
-		auto query_string = query.GetString();
-		std::vector<FunctionResult> parsed_functions;
-		ExtractFunctionsFromSQL(query_string, parsed_functions);
+void ResolveFunctions(ClientContext &context, CatalogResolver &resolver, const std::vector<FunctionResult> &functions,
+                      std::vector<ResolvedName> &resolved) {
+	resolved.reserve(resolved.size() + functions.size());
+	for (auto &func : functions) {
+		resolved.push_back(resolver.Resolve(context, ResolveKind::Function, func.catalog_name, func.schema_name,
+		                                    func.function_name));
+	}
+}
+
+static void ParseFunctionsResolvedScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &context = state.GetContext();
+	auto &resolver = GetCatalogResolver(state);
+
+	std::vector<FunctionExtraction> extractions;
+	ExtractChunk(context, args, "parse_functions_resolved", extractions,
+	[](const std::string &query_string, idx_t row, FunctionExtraction &extraction) {
+		ExtractFunctionsFromSQL(query_string, extraction.functions);
+	});
+
+	// names are resolved while writing, on the calling thread
+	UnaryExecutor::ExecuteWithNulls<string_t, list_entry_t>(args.data[0], result, args.size(),
+	[&](string_t query, ValidityMask &mask, idx_t row) -> list_entry_t {
+		if (!extractions[row].keep) {
+			mask.SetInvalid(row);
+			return list_entry_t();
+		}
+		auto &parsed_functions = extractions[row].functions;
+
+		std::vector<ResolvedName> resolved;
+		ResolveFunctions(context, resolver, parsed_functions, resolved);
 
 		auto current_size = ListVector::GetListSize(result);
 		auto number_of_functions = parsed_functions.size();
@@ -305,20 +404,31 @@ static void ParseFunctionsScalarFunction_struct(DataChunk &args, ExpressionState
 		// Get the fields in the STRUCT
 		auto &entries = StructVector::GetEntries(struct_vector);
 		auto &function_name_entry = *entries[0]; // "function_name" field
-		auto &schema_entry = *entries[1];  // "schema" field
-		auto &context_entry = *entries[2]; // "context" field
+		auto &catalog_entry = *entries[1];       // "catalog" field
+		auto &schema_entry = *entries[2];        // "schema" field
+		auto &object_type_entry = *entries[3];   // "object_type" field
+		auto &context_entry = *entries[4];       // "context" field
 
 		auto function_name_data = FlatVector::GetData<string_t>(function_name_entry);
+		auto catalog_data = FlatVector::GetData<string_t>(catalog_entry);
 		auto schema_data = FlatVector::GetData<string_t>(schema_entry);
+		auto object_type_data = FlatVector::GetData<string_t>(object_type_entry);
 		auto context_data = FlatVector::GetData<string_t>(context_entry);
 
 		for (size_t i = 0; i < number_of_functions; i++) {
-			const auto &func = parsed_functions[i];
+			const auto &name = resolved[i];
 			auto idx = current_size + i;
 
-			function_name_data[idx] = StringVector::AddStringOrBlob(function_name_entry, func.function_name);
-			schema_data[idx] = StringVector::AddStringOrBlob(schema_entry, func.schema);
-			context_data[idx] = StringVector::AddStringOrBlob(context_entry, func.context);
+			function_name_data[idx] = StringVector::AddStringOrBlob(function_name_entry, name.name);
+			if (name.found) {
+				catalog_data[idx] = StringVector::AddStringOrBlob(catalog_entry, name.catalog);
+				object_type_data[idx] = StringVector::AddStringOrBlob(object_type_entry, name.object_type);
+			} else {
+				FlatVector::SetNull(catalog_entry, idx, true);
+				FlatVector::SetNull(object_type_entry, idx, true);
+			}
+			schema_data[idx] = StringVector::AddStringOrBlob(schema_entry, name.schema);
+			context_data[idx] = StringVector::AddStringOrBlob(context_entry, parsed_functions[i].context);
 		}
 
 		return list_entry_t(current_size, number_of_functions);
@@ -330,6 +440,9 @@ static void ParseFunctionsScalarFunction_struct(DataChunk &args, ExpressionState
 
 void RegisterParseFunctionsFunction(DatabaseInstance &db) {
 	TableFunction tf("parse_functions", {LogicalType::VARCHAR}, ParseFunctionsFunction, ParseFunctionsBind, ParseFunctionsInit);
+	tf.named_parameters["resolve"] = LogicalType::BOOLEAN;
+	tf.named_parameters["tolerant"] = LogicalType::BOOLEAN;
+	tf.cardinality = ParseFunctionsCardinality;
 	ExtensionUtil::RegisterFunction(db, tf);
 }
 
@@ -344,8 +457,32 @@ void RegisterParseFunctionScalarFunction(DatabaseInstance &db) {
 		{"schema", LogicalType::VARCHAR},
 		{"context", LogicalType::VARCHAR}
 	}));
-	ScalarFunction sf_struct("parse_functions", {LogicalType::VARCHAR}, return_type, ParseFunctionsScalarFunction_struct);
-	ExtensionUtil::RegisterFunction(db, sf_struct);
+	// parse_functions(sql_query, tolerant) recovers functions from SQL that does not parse, e.g. truncated statements
+	auto tolerant_type = LogicalType::LIST(LogicalType::STRUCT({
+		{"function_name", LogicalType::VARCHAR},
+		{"schema", LogicalType::VARCHAR},
+		{"context", LogicalType::VARCHAR},
+		{"exact", LogicalType::BOOLEAN}
+	}));
+	ScalarFunctionSet functions_set("parse_functions");
+	functions_set.AddFunction(ScalarFunction({LogicalType::VARCHAR}, return_type, ParseFunctionsScalarFunction_struct));
+	functions_set.AddFunction(ScalarFunction({LogicalType::VARCHAR, LogicalType::BOOLEAN}, tolerant_type,
+	                                         ParseFunctionsTolerantScalarFunction));
+	ExtensionUtil::RegisterFunction(db, functions_set);
+
+	// parse_functions_resolved looks each function up in the catalog and search path of the session
+	auto resolved_type = LogicalType::LIST(LogicalType::STRUCT({
+		{"function_name", LogicalType::VARCHAR},
+		{"catalog", LogicalType::VARCHAR},
+		{"schema", LogicalType::VARCHAR},
+		{"object_type", LogicalType::VARCHAR},
+		{"context", LogicalType::VARCHAR}
+	}));
+	ScalarFunction resolved("parse_functions_resolved", {LogicalType::VARCHAR}, resolved_type,
+	                        ParseFunctionsResolvedScalarFunction, CatalogResolverBind);
+	// the result depends on the catalog, it must not be folded into a prepared statement
+	resolved.stability = FunctionStability::CONSISTENT_WITHIN_QUERY;
+	ExtensionUtil::RegisterFunction(db, resolved);
 }
 
 
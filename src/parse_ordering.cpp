@@ -0,0 +1,454 @@
+#include "parse_ordering.hpp"
+#include "from_scope.hpp"
+#include "parser_tools_limits.hpp"
+#include "duckdb.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include "duckdb/parser/parser.hpp"
+#include "duckdb/parser/parsed_expression_iterator.hpp"
+#include "duckdb/parser/result_modifier.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+#include "duckdb/parser/query_node/select_node.hpp"
+#include "duckdb/parser/expression/columnref_expression.hpp"
+#include "duckdb/parser/expression/constant_expression.hpp"
+#include "duckdb/parser/expression/window_expression.hpp"
+#include <algorithm>
+
+namespace duckdb {
+
+static std::string DirectionToString(OrderType type) {
+    switch (type) {
+        case OrderType::ASCENDING:
+            return "ASC";
+        case OrderType::DESCENDING:
+            return "DESC";
+        default:
+            return "";
+    }
+}
+
+static std::string NullOrderToString(OrderByNullType null_order) {
+    switch (null_order) {
+        case OrderByNullType::NULLS_FIRST:
+            return "NULLS FIRST";
+        case OrderByNullType::NULLS_LAST:
+            return "NULLS LAST";
+        default:
+            return "";
+    }
+}
+
+// ORDER BY keys may refer to the select list by position or by alias
+static const ParsedExpression &ResolveSelectListKey(const SelectNode &node, const ParsedExpression &key) {
+    if (key.GetExpressionClass() == ExpressionClass::CONSTANT) {
+        auto &constant = (ConstantExpression &)key;
+        if (!constant.value.IsNull() && constant.value.type().IsIntegral()) {
+            auto position = constant.value.GetValue<int64_t>();
+            if (position >= 1 && idx_t(position) <= node.select_list.size()) {
+                return *node.select_list[position - 1];
+            }
+        }
+    } else if (key.GetExpressionClass() == ExpressionClass::COLUMN_REF) {
+        auto &column_ref = (ColumnRefExpression &)key;
+        if (!column_ref.IsQualified()) {
+            for (auto &expr : node.select_list) {
+                if (!expr->alias.empty() && StringUtil::CIEquals(expr->alias, column_ref.GetColumnName())) {
+                    return *expr;
+                }
+            }
+        }
+    }
+    return key;
+}
+
+static OrderKeyResult DescribeOrderKey(const OrderByNode &order, const ParsedExpression &key, const FromScope *scope) {
+    OrderKeyResult result;
+    result.expression = key.ToString();
+    result.direction = DirectionToString(order.type);
+    result.null_order = NullOrderToString(order.null_order);
+    if (scope && key.GetExpressionClass() == ExpressionClass::COLUMN_REF) {
+        auto &column_ref = (ColumnRefExpression &)key;
+        auto table = scope->ResolveColumn(column_ref);
+        if (!table.empty()) {
+            result.column = table + "." + column_ref.GetColumnName();
+        }
+    }
+    return result;
+}
+
+static void AddColumnTables(const ParsedExpression &expr, const FromScope *scope, std::vector<std::string> &tables) {
+    if (!scope || expr.GetExpressionClass() == ExpressionClass::SUBQUERY) {
+        return;
+    }
+    if (expr.GetExpressionClass() == ExpressionClass::COLUMN_REF) {
+        auto table = scope->ResolveColumn((ColumnRefExpression &)expr);
+        if (!table.empty() && std::find(tables.begin(), tables.end(), table) == tables.end()) {
+            tables.push_back(table);
+        }
+        return;
+    }
+    ParsedExpressionIterator::EnumerateChildren(expr, [&](const ParsedExpression &child) {
+        AddColumnTables(child, scope, tables);
+    });
+}
+
+// Window functions are not searched inside subqueries, which are query nodes of their own
+static void FindWindows(const ParsedExpression &expr, std::vector<const WindowExpression *> &windows) {
+    if (!ExtractionBudget::Tick()) {
+        return;
+    }
+    if (expr.GetExpressionClass() == ExpressionClass::SUBQUERY) {
+        return;
+    }
+    if (expr.GetExpressionClass() == ExpressionClass::WINDOW) {
+        windows.push_back(&(const WindowExpression &)expr);
+    }
+    ParsedExpressionIterator::EnumerateChildren(expr, [&](const ParsedExpression &child) {
+        FindWindows(child, windows);
+    });
+}
+
+// scope is null for set operations, whose windows cannot be attributed to tables
+static WindowSpecResult DescribeWindow(const WindowExpression &window, const FromScope *scope) {
+    WindowSpecResult result;
+    result.function_name = window.function_name;
+    for (auto &partition : window.partitions) {
+        result.partition_by.push_back(partition->ToString());
+        AddColumnTables(*partition, scope, result.tables);
+    }
+    for (auto &order : window.orders) {
+        result.order_by.push_back(DescribeOrderKey(order, *order.expression, scope));
+        AddColumnTables(*order.expression, scope, result.tables);
+    }
+    return result;
+}
+
+static void ExtractOrderingFromQueryNode(const QueryNode &node,
+                                         const std::vector<const CommonTableExpressionMap *> &ctes,
+                                         std::vector<OrderingResult> &results) {
+    OrderingResult result;
+    result.limit_percent = false;
+    switch (node.type) {
+        case QueryNodeType::SELECT_NODE:
+            result.node_type = "select";
+            break;
+        case QueryNodeType::SET_OPERATION_NODE:
+            result.node_type = "set_operation";
+            break;
+        case QueryNodeType::RECURSIVE_CTE_NODE:
+            result.node_type = "recursive_cte";
+            break;
+        default:
+            return;
+    }
+
+    // columns can only be attributed to tables for SELECT nodes, set operations order by their output
+    unique_ptr<FromScope> scope;
+    std::vector<const WindowExpression *> windows;
+    if (node.type == QueryNodeType::SELECT_NODE) {
+        auto &select_node = (SelectNode &)node;
+        scope = make_uniq<FromScope>(select_node, ctes);
+        for (auto &expr : select_node.select_list) {
+            FindWindows(*expr, windows);
+        }
+        if (select_node.qualify) {
+            FindWindows(*select_node.qualify, windows);
+        }
+    }
+
+    for (auto &modifier : node.modifiers) {
+        switch (modifier->type) {
+            case ResultModifierType::ORDER_MODIFIER: {
+                auto &order_modifier = (OrderModifier &)*modifier;
+                for (auto &order : order_modifier.orders) {
+                    auto &key = node.type == QueryNodeType::SELECT_NODE
+                                    ? ResolveSelectListKey((SelectNode &)node, *order.expression)
+                                    : *order.expression;
+                    result.order_by.push_back(DescribeOrderKey(order, key, scope.get()));
+                    FindWindows(*order.expression, windows);
+                }
+                break;
+            }
+            case ResultModifierType::LIMIT_MODIFIER: {
+                auto &limit_modifier = (LimitModifier &)*modifier;
+                if (limit_modifier.limit) {
+                    result.limit = limit_modifier.limit->ToString();
+                }
+                if (limit_modifier.offset) {
+                    result.offset = limit_modifier.offset->ToString();
+                }
+                break;
+            }
+            case ResultModifierType::LIMIT_PERCENT_MODIFIER: {
+                auto &limit_modifier = (LimitPercentModifier &)*modifier;
+                if (limit_modifier.limit) {
+                    result.limit = limit_modifier.limit->ToString();
+                    result.limit_percent = true;
+                }
+                if (limit_modifier.offset) {
+                    result.offset = limit_modifier.offset->ToString();
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    if (result.order_by.empty() && result.limit.empty() && result.offset.empty() && windows.empty()) {
+        return;
+    }
+    for (auto window : windows) {
+        result.windows.push_back(DescribeWindow(*window, scope.get()));
+    }
+    if (scope) {
+        scope->SourceTables(result.tables);
+    } else {
+        QueryNodeSourceTables(node, ctes, result.tables);
+    }
+    results.push_back(std::move(result));
+}
+
+void ExtractOrderingFromSQL(const std::string &sql, std::vector<OrderingResult> &results) {
+    if (!ExtractionBudget::AllowInput(sql)) {
+        return;
+    }
+
+    Parser parser;
+
+    try {
+        parser.ParseQuery(sql);
+    } catch (const ParserException &ex) {
+        return;
+    }
+
+    if (!ExtractionBudget::CheckDeadline()) {
+        return;
+    }
+
+    for (auto &stmt : parser.statements) {
+        if (stmt->type == StatementType::SELECT_STATEMENT) {
+            auto &select_stmt = (SelectStatement &)*stmt;
+            if (select_stmt.node) {
+                EnumerateQueryNodes(*select_stmt.node,
+                    [&](const QueryNode &node, const std::vector<const CommonTableExpressionMap *> &ctes) {
+                        ExtractOrderingFromQueryNode(node, ctes, results);
+                    });
+            }
+        }
+    }
+}
+
+// Writes the string, or NULL if it is empty
+static void WriteStringOrNull(Vector &vector, string_t *data, idx_t idx, const std::string &str) {
+    if (str.empty()) {
+        FlatVector::SetNull(vector, idx, true);
+    } else {
+        data[idx] = StringVector::AddStringOrBlob(vector, str);
+    }
+}
+
+// Appends the strings to the child of a LIST(VARCHAR) vector and returns the entry of the row
+static list_entry_t WriteStringList(Vector &list_vector, const std::vector<std::string> &strings) {
+    auto current_size = ListVector::GetListSize(list_vector);
+    auto new_size = current_size + strings.size();
+
+    // Grow list vector if needed
+    if (ListVector::GetListCapacity(list_vector) < new_size) {
+        ListVector::Reserve(list_vector, new_size);
+    }
+
+    auto &child = ListVector::GetEntry(list_vector);
+    auto child_data = FlatVector::GetData<string_t>(child);
+    for (size_t i = 0; i < strings.size(); i++) {
+        child_data[current_size + i] = StringVector::AddStringOrBlob(child, strings[i]);
+    }
+    ListVector::SetListSize(list_vector, new_size);
+    return list_entry_t(current_size, strings.size());
+}
+
+static list_entry_t WriteOrderKeyList(Vector &list_vector, const std::vector<OrderKeyResult> &keys) {
+    auto current_size = ListVector::GetListSize(list_vector);
+    auto number_of_keys = keys.size();
+    auto new_size = current_size + number_of_keys;
+
+    // Grow list vector if needed
+    if (ListVector::GetListCapacity(list_vector) < new_size) {
+        ListVector::Reserve(list_vector, new_size);
+    }
+
+    // Get the struct child vector of the list
+    auto &struct_vector = ListVector::GetEntry(list_vector);
+
+    // Ensure list size is updated
+    ListVector::SetListSize(list_vector, new_size);
+
+    // Get the fields in the STRUCT
+    auto &entries = StructVector::GetEntries(struct_vector);
+    auto &expression_entry = *entries[0]; // "expression" field
+    auto &column_entry = *entries[1];     // "column" field
+    auto &direction_entry = *entries[2];  // "direction" field
+    auto &null_order_entry = *entries[3]; // "null_order" field
+
+    auto expression_data = FlatVector::GetData<string_t>(expression_entry);
+    auto column_data = FlatVector::GetData<string_t>(column_entry);
+    auto direction_data = FlatVector::GetData<string_t>(direction_entry);
+    auto null_order_data = FlatVector::GetData<string_t>(null_order_entry);
+
+    for (size_t i = 0; i < number_of_keys; i++) {
+        const auto &key = keys[i];
+        auto idx = current_size + i;
+
+        expression_data[idx] = StringVector::AddStringOrBlob(expression_entry, key.expression);
+        WriteStringOrNull(column_entry, column_data, idx, key.column);
+        WriteStringOrNull(direction_entry, direction_data, idx, key.direction);
+        WriteStringOrNull(null_order_entry, null_order_data, idx, key.null_order);
+    }
+
+    return list_entry_t(current_size, number_of_keys);
+}
+
+static list_entry_t WriteWindowSpecList(Vector &list_vector, const std::vector<WindowSpecResult> &windows) {
+    auto current_size = ListVector::GetListSize(list_vector);
+    auto number_of_windows = windows.size();
+    auto new_size = current_size + number_of_windows;
+
+    // Grow list vector if needed
+    if (ListVector::GetListCapacity(list_vector) < new_size) {
+        ListVector::Reserve(list_vector, new_size);
+    }
+
+    // Get the struct child vector of the list
+    auto &struct_vector = ListVector::GetEntry(list_vector);
+
+    // Ensure list size is updated
+    ListVector::SetListSize(list_vector, new_size);
+
+    // Get the fields in the STRUCT
+    auto &entries = StructVector::GetEntries(struct_vector);
+    auto &function_name_entry = *entries[0]; // "function_name" field
+    auto &partition_by_entry = *entries[1];  // "partition_by" field
+    auto &order_by_entry = *entries[2];      // "order_by" field
+    auto &tables_entry = *entries[3];        // "tables" field
+
+    auto function_name_data = FlatVector::GetData<string_t>(function_name_entry);
+    auto partition_by_data = FlatVector::GetData<list_entry_t>(partition_by_entry);
+    auto order_by_data = FlatVector::GetData<list_entry_t>(order_by_entry);
+    auto tables_data = FlatVector::GetData<list_entry_t>(tables_entry);
+
+    for (size_t i = 0; i < number_of_windows; i++) {
+        const auto &window = windows[i];
+        auto idx = current_size + i;
+
+        function_name_data[idx] = StringVector::AddStringOrBlob(function_name_entry, window.function_name);
+        partition_by_data[idx] = WriteStringList(partition_by_entry, window.partition_by);
+        order_by_data[idx] = WriteOrderKeyList(order_by_entry, window.order_by);
+        tables_data[idx] = WriteStringList(tables_entry, window.tables);
+    }
+
+    return list_entry_t(current_size, number_of_windows);
+}
+
+static list_entry_t WriteOrderingList(Vector &result, const std::vector<OrderingResult> &orderings) {
+    auto current_size = ListVector::GetListSize(result);
+    auto number_of_orderings = orderings.size();
+    auto new_size = current_size + number_of_orderings;
+
+    // Grow list vector if needed
+    if (ListVector::GetListCapacity(result) < new_size) {
+        ListVector::Reserve(result, new_size);
+    }
+
+    // Get the struct child vector of the list
+    auto &struct_vector = ListVector::GetEntry(result);
+
+    // Ensure list size is updated
+    ListVector::SetListSize(result, new_size);
+
+    // Get the fields in the STRUCT
+    auto &entries = StructVector::GetEntries(struct_vector);
+    auto &node_type_entry = *entries[0];     // "node_type" field
+    auto &tables_entry = *entries[1];        // "tables" field
+    auto &order_by_entry = *entries[2];      // "order_by" field
+    auto &limit_entry = *entries[3];         // "limit" field
+    auto &offset_entry = *entries[4];        // "offset" field
+    auto &limit_percent_entry = *entries[5]; // "limit_percent" field
+    auto &windows_entry = *entries[6];       // "windows" field
+
+    auto node_type_data = FlatVector::GetData<string_t>(node_type_entry);
+    auto tables_data = FlatVector::GetData<list_entry_t>(tables_entry);
+    auto order_by_data = FlatVector::GetData<list_entry_t>(order_by_entry);
+    auto limit_data = FlatVector::GetData<string_t>(limit_entry);
+    auto offset_data = FlatVector::GetData<string_t>(offset_entry);
+    auto limit_percent_data = FlatVector::GetData<bool>(limit_percent_entry);
+    auto windows_data = FlatVector::GetData<list_entry_t>(windows_entry);
+
+    for (size_t i = 0; i < number_of_orderings; i++) {
+        const auto &ordering = orderings[i];
+        auto idx = current_size + i;
+
+        node_type_data[idx] = StringVector::AddStringOrBlob(node_type_entry, ordering.node_type);
+        tables_data[idx] = WriteStringList(tables_entry, ordering.tables);
+        order_by_data[idx] = WriteOrderKeyList(order_by_entry, ordering.order_by);
+        WriteStringOrNull(limit_entry, limit_data, idx, ordering.limit);
+        WriteStringOrNull(offset_entry, offset_data, idx, ordering.offset);
+        limit_percent_data[idx] = ordering.limit_percent;
+        windows_data[idx] = WriteWindowSpecList(windows_entry, ordering.windows);
+    }
+
+    return list_entry_t(current_size, number_of_orderings);
+}
+
+static LogicalType OrderKeyType() {
+    return LogicalType::STRUCT({
+        {"expression", LogicalType::VARCHAR},
+        {"column", LogicalType::VARCHAR},
+        {"direction", LogicalType::VARCHAR},
+        {"null_order", LogicalType::VARCHAR}
+    });
+}
+
+static LogicalType WindowSpecType() {
+    return LogicalType::STRUCT({
+        {"function_name", LogicalType::VARCHAR},
+        {"partition_by", LogicalType::LIST(LogicalType::VARCHAR)},
+        {"order_by", LogicalType::LIST(OrderKeyType())},
+        {"tables", LogicalType::LIST(LogicalType::VARCHAR)}
+    });
+}
+
+static void ParseOrderingScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    auto limits = ParserToolsLimits::Get(state.GetContext());
+
+    UnaryExecutor::ExecuteWithNulls<string_t, list_entry_t>(args.data[0], result, args.size(),
+    [&](string_t query, ValidityMask &mask, idx_t row) -> list_entry_t {
+        std::vector<OrderingResult> orderings;
+        ExtractionBudget budget(limits);
+        ExtractOrderingFromSQL(query.GetString(), orderings);
+        if (!budget.KeepResult("parse_ordering")) {
+            mask.SetInvalid(row);
+            return list_entry_t();
+        }
+        return WriteOrderingList(result, orderings);
+    });
+}
+
+// Extension scaffolding
+// ---------------------------------------------------
+
+void RegisterParseOrderingFunction(DatabaseInstance &db) {
+    // parse_ordering reports sort keys, top-N limits and window specs, e.g. to choose sort orders to persist
+    auto return_type = LogicalType::LIST(LogicalType::STRUCT({
+        {"node_type", LogicalType::VARCHAR},
+        {"tables", LogicalType::LIST(LogicalType::VARCHAR)},
+        {"order_by", LogicalType::LIST(OrderKeyType())},
+        {"limit", LogicalType::VARCHAR},
+        {"offset", LogicalType::VARCHAR},
+        {"limit_percent", LogicalType::BOOLEAN},
+        {"windows", LogicalType::LIST(WindowSpecType())}
+    }));
+    ScalarFunction sf("parse_ordering", {LogicalType::VARCHAR}, return_type, ParseOrderingScalarFunction);
+    ExtensionUtil::RegisterFunction(db, sf);
+}
+
+} // namespace duckdb
@@ -1,46 +1,41 @@
 #include "parse_tables.hpp"
+#include "parser_tools_limits.hpp"
+#include "catalog_resolver.hpp"
+#include "tolerant_extractor.hpp"
+#include "sql_scanner.hpp"
+#include "parallel_extraction.hpp"
 #include "duckdb.hpp"
 #include "duckdb/parser/parser.hpp"
-#include "duckdb/parser/statement/select_statement.hpp"
-#include "duckdb/parser/query_node/select_node.hpp"
-#include "duckdb/parser/tableref/basetableref.hpp"
-#include "duckdb/parser/tableref/joinref.hpp"
-#include "duckdb/parser/tableref/subqueryref.hpp"
 #include "duckdb/main/extension_util.hpp"
+#include "duckdb/storage/statistics/node_statistics.hpp"
 #include "duckdb/function/scalar/nested_functions.hpp"
 
 
 namespace duckdb {
 
-inline const char *ToString(TableContext context) {
-    switch (context) {
-        case TableContext::From: return "from";
-        case TableContext::JoinLeft: return "join_left";
-        case TableContext::JoinRight: return "join_right";
-        case TableContext::FromCTE: return "from_cte";
-        case TableContext::CTE: return "cte";
-        case TableContext::Subquery: return "subquery";
-        default: return "unknown";
-    }
-}
-
-inline const TableContext FromString(const char *context) {
-    if (strcmp(context, "from") == 0) return TableContext::From;
-    if (strcmp(context, "join_left") == 0) return TableContext::JoinLeft;
-    if (strcmp(context, "join_right") == 0) return TableContext::JoinRight;
-    if (strcmp(context, "from_cte") == 0) return TableContext::FromCTE;
-    if (strcmp(context, "cte") == 0) return TableContext::CTE;
-    if (strcmp(context, "subquery") == 0) return TableContext::Subquery;
-    throw InternalException("Unknown table context: %s", context);
-}
+struct ParseTablesBindData : public TableFunctionData {
+    string sql;
+    // extracted once at bind time, shared by every scan of the (prepared) statement
+    vector<TableRefResult> results;
+    // large inputs are instead extracted by the scan, one statement at a time
+    bool statement_at_a_time = false;
+    // resolve := true, resolved[i] is the catalog entry of results[i]
+    bool resolve = false;
+    vector<ResolvedName> resolved;
+    // tolerant := true, exact[i] is false if results[i] was recovered from SQL that does not parse
+    bool tolerant = false;
+    vector<bool> exact;
+};
 
 struct ParseTablesState : public GlobalTableFunctionState {
     idx_t row = 0;
+    // statement at a time: the results of the current statement only
+    unique_ptr<StatementCursor> cursor;
+    ParserToolsLimits limits;
     vector<TableRefResult> results;
-};
-
-struct ParseTablesBindData : public TableFunctionData {
-    string sql;
+    vector<ResolvedName> resolved;
+    vector<bool> exact;
+    CatalogResolver resolver;
 };
 
 // BIND function: runs during query planning to decide output schema
@@ -50,120 +45,104 @@ static unique_ptr<FunctionData> ParseTablesBind(ClientContext &context,
                                     vector<string> &names) {
                                 
     string sql_input = StringValue::Get(input.inputs[0]);
-                                                    
-    // always return the same columns:
 
-    return_types = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR};
-    // schema name, table name, usage context (from, join, cte, etc)
-    names = {"schema", "table", "context"};
-    
     // create a bind data object to hold the SQL input
     
     auto result = make_uniq<ParseTablesBindData>();
     result->sql = sql_input;
 
-    return std::move(result);
-}
-
-// INIT function: runs before table function execution
-static unique_ptr<GlobalTableFunctionState> ParseTablesInit(ClientContext &context,
-    TableFunctionInitInput &input) {
-    return make_uniq<ParseTablesState>();
-}
-
-static void ExtractTablesFromRef(
-    const duckdb::TableRef &ref,
-    std::vector<TableRefResult> &results,
-    const TableContext context = TableContext::From,
-    bool is_top_level = false,
-    const duckdb::CommonTableExpressionMap *cte_map = nullptr
-) {
-    using namespace duckdb;
-
-    switch (ref.type) {
-        case TableReferenceType::BASE_TABLE: {
-            auto &base = (BaseTableRef &)ref;
-            TableContext context_label = context;
-
-            if (cte_map && cte_map->map.find(base.table_name) != cte_map->map.end()) {
-                context_label = TableContext::FromCTE;
-            } else if (is_top_level) {
-                context_label = TableContext::From;
-            }
-
-            results.push_back(TableRefResult{
-                base.schema_name.empty() ? "main" : base.schema_name,
-                base.table_name,
-                context_label
-            });
-            break;
-        }
-        case TableReferenceType::JOIN: {
-            auto &join = (JoinRef &)ref;
-            ExtractTablesFromRef(*join.left, results, TableContext::JoinLeft, is_top_level, cte_map);
-            ExtractTablesFromRef(*join.right, results, TableContext::JoinRight, false, cte_map);
-            break;
-        }
-        case TableReferenceType::SUBQUERY: {
-            auto &subquery = (SubqueryRef &)ref;
-            if (subquery.subquery && subquery.subquery->node) {
-                ExtractTablesFromQueryNode(*subquery.subquery->node, results, TableContext::Subquery, cte_map);
-            }
-            break;
-        }
-        default:
-            break;
+    auto resolve = input.named_parameters.find("resolve");
+    if (resolve != input.named_parameters.end() && !resolve->second.IsNull()) {
+        result->resolve = BooleanValue::Get(resolve->second);
+    }
+    auto tolerant = input.named_parameters.find("tolerant");
+    if (tolerant != input.named_parameters.end() && !tolerant->second.IsNull()) {
+        result->tolerant = BooleanValue::Get(tolerant->second);
     }
-}
-
 
-static void ExtractTablesFromQueryNode(
-    const duckdb::QueryNode &node,
-    std::vector<TableRefResult> &results,
-    const TableContext context,
-    const duckdb::CommonTableExpressionMap *cte_map
-) {
-    using namespace duckdb;
+    if (result->resolve) {
+        return_types = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR,
+                        LogicalType::VARCHAR};
+        // catalog, schema and name of the catalog entry, entry type (table, view), usage context
+        names = {"catalog", "schema", "table", "object_type", "context"};
+    } else {
+        return_types = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR};
+        // schema name, table name, usage context (from, join, cte, etc)
+        names = {"schema", "table", "context"};
+    }
+    if (result->tolerant) {
+        return_types.push_back(LogicalType::BOOLEAN);
+        names.push_back("exact");
+    }
 
-    if (node.type == QueryNodeType::SELECT_NODE) {
-        auto &select_node = (SelectNode &)node;
+    // parse during binding so the optimizer knows the exact cardinality
+    auto limits = ParserToolsLimits::Get(context);
+    ExtractionBudget budget(limits);
+    if (result->sql.size() >= STATEMENT_AT_A_TIME_MIN_BYTES && ExtractionBudget::AllowInputSize(result->sql.size())) {
+        result->statement_at_a_time = true;
+    } else if (result->tolerant) {
+        ExtractTablesFromSQLTolerant(result->sql, result->results, result->exact);
+    } else {
+        ExtractTablesFromSQL(result->sql, result->results);
+    }
+    if (!budget.KeepResult("parse_tables")) {
+        result->results.clear();
+        result->exact.clear();
+    }
 
-        // Emit CTE definitions
-        for (const auto &entry : select_node.cte_map.map) {
-            results.push_back(TableRefResult{
-                "", entry.first, TableContext::CTE
-            });
+    if (result->resolve) {
+        CatalogResolver resolver;
+        ResolveTableRefs(context, resolver, result->results, result->resolved);
+    }
 
-            if (entry.second && entry.second->query && entry.second->query->node) {
-                ExtractTablesFromQueryNode(*entry.second->query->node, results, TableContext::From, &select_node.cte_map);
-            }
-        }
+    return std::move(result);
+}
 
-        if (select_node.from_table) {
-            ExtractTablesFromRef(*select_node.from_table, results, context, true, &select_node.cte_map);
-        }
+static unique_ptr<NodeStatistics> ParseTablesCardinality(ClientContext &context, const FunctionData *bind_data_p) {
+    auto &bind_data = (const ParseTablesBindData &)*bind_data_p;
+    if (bind_data.statement_at_a_time) {
+        return make_uniq<NodeStatistics>();
     }
+    return make_uniq<NodeStatistics>(bind_data.results.size(), bind_data.results.size());
 }
 
-static void ExtractTablesFromSQL(const std::string &sql, std::vector<TableRefResult> &results) {
-    Parser parser;
-
-    try {
-        parser.ParseQuery(sql);
-    } catch (const ParserException &ex) {
-        // swallow parser exceptions to make this function more robust. is_parsable can be used if needed
-        return; 
+// INIT function: runs before table function execution
+static unique_ptr<GlobalTableFunctionState> ParseTablesInit(ClientContext &context,
+    TableFunctionInitInput &input) {
+    auto &bind_data = (const ParseTablesBindData &)*input.bind_data;
+    auto result = make_uniq<ParseTablesState>();
+    if (bind_data.statement_at_a_time) {
+        result->cursor = make_uniq<StatementCursor>(bind_data.sql);
+        result->limits = ParserToolsLimits::Get(context);
     }
-    
+    return std::move(result);
+}
 
-    for (auto &stmt : parser.statements) {
-        if (stmt->type == StatementType::SELECT_STATEMENT) {
-            auto &select_stmt = (SelectStatement &)*stmt;
-            if (select_stmt.node) {
-                ExtractTablesFromQueryNode(*select_stmt.node, results);
-            }
+// Replaces the scan's results with those of the next statement that has any, returns false at the
+// end of the input. The resource limits apply to each statement on its own.
+static bool ExtractNextStatement(ClientContext &context, const ParseTablesBindData &bind_data,
+                                 ParseTablesState &state) {
+    state.results.clear();
+    state.resolved.clear();
+    state.exact.clear();
+    state.row = 0;
+    std::string statement;
+    while (state.results.empty() && state.cursor->Next(statement)) {
+        ExtractionBudget budget(state.limits);
+        if (bind_data.tolerant) {
+            ExtractTablesFromSQLTolerant(statement, state.results, state.exact);
+        } else {
+            ExtractTablesFromSQL(statement, state.results);
+        }
+        if (!budget.KeepResult("parse_tables")) {
+            state.results.clear();
+            state.exact.clear();
         }
     }
+    if (bind_data.resolve) {
+        ResolveTableRefs(context, state.resolver, state.results, state.resolved);
+    }
+    return !state.results.empty();
 }
 
 static void ExtractTablesFromSQL(const std::string & sql, std::vector<TableRefResult> &result, std::unordered_set<std::string> excluded_types) {
@@ -187,22 +166,107 @@ static void ParseTablesFunction(ClientContext &context,
                    DataChunk &output) {
     auto &state = (ParseTablesState &)*data.global_state;
     auto &bind_data = (ParseTablesBindData &)*data.bind_data;
+    auto &results = bind_data.statement_at_a_time ? state.results : bind_data.results;
+    auto &resolved_names = bind_data.statement_at_a_time ? state.resolved : bind_data.resolved;
+    auto &exact = bind_data.statement_at_a_time ? state.exact : bind_data.exact;
+
+    idx_t count = 0;
+    while (count < STANDARD_VECTOR_SIZE) {
+        if (state.row >= results.size()) {
+            if (bind_data.statement_at_a_time && ExtractNextStatement(context, bind_data, state)) {
+                continue;
+            }
+            break;
+        }
+        auto &ref = results[state.row];
+        if (bind_data.resolve) {
+            auto &resolved = resolved_names[state.row];
+            output.SetValue(0, count, resolved.found ? Value(resolved.catalog) : Value());
+            output.SetValue(1, count, Value(resolved.schema));
+            output.SetValue(2, count, Value(resolved.name));
+            output.SetValue(3, count, resolved.object_type.empty() ? Value() : Value(resolved.object_type));
+            output.SetValue(4, count, Value(ToString(ref.context)));
+        } else {
+            output.SetValue(0, count, Value(ref.schema));
+            output.SetValue(1, count, Value(ref.table));
+            output.SetValue(2, count, Value(ToString(ref.context)));
+        }
+        if (bind_data.tolerant) {
+            output.SetValue(bind_data.resolve ? 5 : 3, count, Value::BOOLEAN(exact[state.row]));
+        }
 
-    if (state.results.empty() && state.row == 0) {
-        ExtractTablesFromSQL(bind_data.sql, state.results);
+        state.row++;
+        count++;
     }
+    output.SetCardinality(count);
+}
+
+// The tables of one row, extracted before any result of the chunk is written
+struct TableExtraction {
+    bool keep = false;
+    std::vector<TableRefResult> tables;
+    std::vector<bool> exact;
+};
 
-    if (state.row >= state.results.size()) {
-        return;
+list_entry_t WriteTableNameList(Vector &result, const std::vector<TableRefResult> &parsed_tables) {
+    auto current_size = ListVector::GetListSize(result);
+    auto number_of_tables = parsed_tables.size();
+    auto new_size = current_size + number_of_tables;
+
+    // grow list if needed
+    if (ListVector::GetListCapacity(result) < new_size) {
+        ListVector::Reserve(result, new_size);
     }
 
-    auto &ref = state.results[state.row];
-    output.SetCardinality(1);
-    output.SetValue(0, 0, Value(ref.schema));
-    output.SetValue(1, 0, Value(ref.table));
-    output.SetValue(2, 0, Value(ToString(ref.context)));
+    // Write the string into the child vector
+    auto tables = FlatVector::GetData<string_t>(ListVector::GetEntry(result));
+    for (size_t i = 0; i < parsed_tables.size(); i++) {
+        auto &table = parsed_tables[i];
+        tables[current_size + i] = StringVector::AddStringOrBlob(ListVector::GetEntry(result), table.table);
+    }
+
+    // Update size
+    ListVector::SetListSize(result, new_size);
+
+    return list_entry_t(current_size, number_of_tables);
+}
+
+list_entry_t WriteTableStructList(Vector &result, const std::vector<TableRefResult> &parsed_tables) {
+    auto current_size = ListVector::GetListSize(result);
+    auto number_of_tables = parsed_tables.size();
+    auto new_size = current_size + number_of_tables;
+
+    // Grow list vector if needed
+    if (ListVector::GetListCapacity(result) < new_size) {
+        ListVector::Reserve(result, new_size);
+    }
+
+    // Get the struct child vector of the list
+    auto &struct_vector = ListVector::GetEntry(result);
+
+    // Ensure list size is updated
+    ListVector::SetListSize(result, new_size);
+
+    // Get the fields in the STRUCT
+    auto &entries = StructVector::GetEntries(struct_vector);
+    auto &schema_entry = *entries[0]; // "schema" field
+    auto &table_entry = *entries[1];  // "table" field
+    auto &context_entry = *entries[2]; // "context" field
 
-    state.row++;
+    auto schema_data = FlatVector::GetData<string_t>(schema_entry);
+    auto table_data = FlatVector::GetData<string_t>(table_entry);
+    auto context_data = FlatVector::GetData<string_t>(context_entry);
+
+    for (size_t i = 0; i < number_of_tables; i++) {
+        const auto &table = parsed_tables[i];
+        auto idx = current_size + i;
+
+        schema_data[idx] = StringVector::AddStringOrBlob(schema_entry, table.schema);
+        table_data[idx] = StringVector::AddStringOrBlob(table_entry, table.table);
+        context_data[idx] = StringVector::AddStringOrBlob(context_entry, ToString(table.context));
+    }
+
+    return list_entry_t(current_size, number_of_tables);
 }
 
 static void ParseTablesScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
@@ -220,53 +284,160 @@ static void ParseTablesScalarFunction(DataChunk &args, ExpressionState &state, V
         throw InvalidInputException("parse_tables() expects 1 or 2 arguments");
     }
 
+    UnifiedVectorFormat flag_data;
+    flag.ToUnifiedFormat(args.size(), flag_data);
+    auto flags = UnifiedVectorFormat::GetData<bool>(flag_data);
+
+    std::vector<TableExtraction> extractions;
+    ExtractChunk(state.GetContext(), args, "parse_table_names", extractions,
+    [&](const std::string &query_string, idx_t row, TableExtraction &extraction) {
+        auto flag_idx = flag_data.sel->get_index(row);
+        if (!flag_data.validity.RowIsValid(flag_idx)) {
+            return;
+        }
+        if (flags[flag_idx]) {
+            std::unordered_set<std::string> excluded_types = {"cte", "from_cte"};
+            ExtractTablesFromSQL(query_string, extraction.tables, excluded_types);
+        } else {
+            ExtractTablesFromSQL(query_string, extraction.tables);
+        }
+    });
+
     // Execute does the heavy lifting of iterating over the input data
     // and calling the provided lambda function for each input value.
-    // The lambda function is responsible for parsing the SQL query and
-    // extracting the table names.
-    BinaryExecutor::Execute<string_t, bool, list_entry_t>(args.data[0], flag, result, args.size(), 
-    [&result](string_t query, bool exclude_cte) -> list_entry_t {
-        // Parse the SQL query and extract table names
-        auto query_string = query.GetString();
-        std::vector<TableRefResult> parsed_tables;
-        if (exclude_cte) {
-            std::unordered_set<std::string> excluded_types = {"cte", "from_cte"};
-            ExtractTablesFromSQL(query_string, parsed_tables, excluded_types);
+    // The lambda function writes the tables extracted above.
+    BinaryExecutor::ExecuteWithNulls<string_t, bool, list_entry_t>(args.data[0], flag, result, args.size(), 
+    [&result, &extractions](string_t query, bool exclude_cte, ValidityMask &mask, idx_t row) -> list_entry_t {
+        if (!extractions[row].keep) {
+            mask.SetInvalid(row);
+            return list_entry_t();
+        }
+        return WriteTableNameList(result, extractions[row].tables);
+    });
+}
+
+static void ParseTablesScalarFunction_struct(DataChunk &args, ExpressionState &state, Vector &result) {
+    std::vector<TableExtraction> extractions;
+    ExtractChunk(state.GetContext(), args, "parse_tables", extractions,
+    [](const std::string &query_string, idx_t row, TableExtraction &extraction) {
+        ExtractTablesFromSQL(query_string, extraction.tables);
+    });
+
+    UnaryExecutor::ExecuteWithNulls<string_t, list_entry_t>(args.data[0], result, args.size(),
+    [&result, &extractions](string_t query, ValidityMask &mask, idx_t row) -> list_entry_t {
+        if (!extractions[row].keep) {
+            mask.SetInvalid(row);
+            return list_entry_t();
+        }
+        return WriteTableStructList(result, extractions[row].tables);
+    });
+}
+
+static void ParseTablesTolerantScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    UnifiedVectorFormat tolerant_data;
+    args.data[1].ToUnifiedFormat(args.size(), tolerant_data);
+    auto tolerant_flags = UnifiedVectorFormat::GetData<bool>(tolerant_data);
+
+    std::vector<TableExtraction> extractions;
+    ExtractChunk(state.GetContext(), args, "parse_tables", extractions,
+    [&](const std::string &query_string, idx_t row, TableExtraction &extraction) {
+        auto tolerant_idx = tolerant_data.sel->get_index(row);
+        if (!tolerant_data.validity.RowIsValid(tolerant_idx)) {
+            return;
+        }
+        if (tolerant_flags[tolerant_idx]) {
+            ExtractTablesFromSQLTolerant(query_string, extraction.tables, extraction.exact);
         } else {
-            ExtractTablesFromSQL(query_string, parsed_tables);
+            ExtractTablesFromSQL(query_string, extraction.tables);
+            extraction.exact.resize(extraction.tables.size(), true);
         }
-        
-    
+    });
+
+    BinaryExecutor::ExecuteWithNulls<string_t, bool, list_entry_t>(args.data[0], args.data[1], result, args.size(),
+    [&result, &extractions](string_t query, bool tolerant, ValidityMask &mask, idx_t row) -> list_entry_t {
+        if (!extractions[row].keep) {
+            mask.SetInvalid(row);
+            return list_entry_t();
+        }
+        auto &parsed_tables = extractions[row].tables;
+        auto &exact = extractions[row].exact;
+
         auto current_size = ListVector::GetListSize(result);
         auto number_of_tables = parsed_tables.size();
         auto new_size = current_size + number_of_tables;
 
-        // grow list if needed
+        // Grow list vector if needed
         if (ListVector::GetListCapacity(result) < new_size) {
             ListVector::Reserve(result, new_size);
         }
 
-        // Write the string into the child vector
-        auto tables = FlatVector::GetData<string_t>(ListVector::GetEntry(result));
-        for (size_t i = 0; i < parsed_tables.size(); i++) {
-            auto &table = parsed_tables[i];
-            tables[current_size + i] = StringVector::AddStringOrBlob(ListVector::GetEntry(result), table.table);
-        }
+        // Get the struct child vector of the list
+        auto &struct_vector = ListVector::GetEntry(result);
 
-        // Update size
+        // Ensure list size is updated
         ListVector::SetListSize(result, new_size);
 
-        return list_entry_t(current_size, number_of_tables); 
+        // Get the fields in the STRUCT
+        auto &entries = StructVector::GetEntries(struct_vector);
+        auto &schema_entry = *entries[0];  // "schema" field
+        auto &table_entry = *entries[1];   // "table" field
+        auto &context_entry = *entries[2]; // "context" field
+        auto &exact_entry = *entries[3];   // "exact" field
+
+        auto schema_data = FlatVector::GetData<string_t>(schema_entry);
+        auto table_data = FlatVector::GetData<string_t>(table_entry);
+        auto context_data = FlatVector::GetData<string_t>(context_entry);
+        auto exact_data = FlatVector::GetData<bool>(exact_entry);
+
+        for (size_t i = 0; i < number_of_tables; i++) {
+            const auto &table = parsed_tables[i];
+            auto idx = current_size + i;
+
+            schema_data[idx] = StringVector::AddStringOrBlob(schema_entry, table.schema);
+            table_data[idx] = StringVector::AddStringOrBlob(table_entry, table.table);
+            context_data[idx] = StringVector::AddStringOrBlob(context_entry, ToString(table.context));
+            exact_data[idx] = exact[i];
+        }
+
+        return list_entry_t(current_size, number_of_tables);
     });
 }
 
-static void ParseTablesScalarFunction_struct(DataChunk &args, ExpressionState &state, Vector &result) {
-    UnaryExecutor::Execute<string_t, list_entry_t>(args.data[0], result, args.size(),
-    [&result](string_t query) -> list_entry_t {
-        // Parse the SQL query and extract table names
-        auto query_string = query.GetString();
-        std::vector<TableRefResult> parsed_tables;
-        ExtractTablesFromSQL(query_string, parsed_tables);    
+void ResolveTableRefs(ClientContext &context, CatalogResolver &resolver, const std::vector<TableRefResult> &tables,
+                      std::vector<ResolvedName> &resolved) {
+    resolved.reserve(resolved.size() + tables.size());
+    for (auto &table : tables) {
+        if (table.context == TableContext::CTE || table.context == TableContext::FromCTE) {
+            // CTE names are local to the query and never looked up in the catalog
+            resolved.push_back(ResolvedName{false, "", table.schema, table.table, "cte"});
+            continue;
+        }
+        resolved.push_back(resolver.Resolve(context, ResolveKind::Table, table.catalog_name, table.schema_name,
+                                            table.table));
+    }
+}
+
+static void ParseTablesResolvedScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    auto &context = state.GetContext();
+    auto &resolver = GetCatalogResolver(state);
+
+    std::vector<TableExtraction> extractions;
+    ExtractChunk(context, args, "parse_tables_resolved", extractions,
+    [](const std::string &query_string, idx_t row, TableExtraction &extraction) {
+        ExtractTablesFromSQL(query_string, extraction.tables);
+    });
+
+    // names are resolved while writing, on the calling thread
+    UnaryExecutor::ExecuteWithNulls<string_t, list_entry_t>(args.data[0], result, args.size(),
+    [&](string_t query, ValidityMask &mask, idx_t row) -> list_entry_t {
+        if (!extractions[row].keep) {
+            mask.SetInvalid(row);
+            return list_entry_t();
+        }
+        auto &parsed_tables = extractions[row].tables;
+
+        std::vector<ResolvedName> resolved;
+        ResolveTableRefs(context, resolver, parsed_tables, resolved);
 
         auto current_size = ListVector::GetListSize(result);
         auto number_of_tables = parsed_tables.size();
@@ -285,22 +456,35 @@ static void ParseTablesScalarFunction_struct(DataChunk &args, ExpressionState &s
 
         // Get the fields in the STRUCT
         auto &entries = StructVector::GetEntries(struct_vector);
-        auto &schema_entry = *entries[0]; // "schema" field
-        auto &table_entry = *entries[1];  // "table" field
-        auto &context_entry = *entries[2]; // "context" field
+        auto &catalog_entry = *entries[0];     // "catalog" field
+        auto &schema_entry = *entries[1];      // "schema" field
+        auto &table_entry = *entries[2];       // "table" field
+        auto &object_type_entry = *entries[3]; // "object_type" field
+        auto &context_entry = *entries[4];     // "context" field
 
+        auto catalog_data = FlatVector::GetData<string_t>(catalog_entry);
         auto schema_data = FlatVector::GetData<string_t>(schema_entry);
         auto table_data = FlatVector::GetData<string_t>(table_entry);
+        auto object_type_data = FlatVector::GetData<string_t>(object_type_entry);
         auto context_data = FlatVector::GetData<string_t>(context_entry);
 
-
         for (size_t i = 0; i < number_of_tables; i++) {
-            const auto &table = parsed_tables[i];
+            const auto &name = resolved[i];
             auto idx = current_size + i;
 
-            schema_data[idx] = StringVector::AddStringOrBlob(schema_entry, table.schema);
-            table_data[idx] = StringVector::AddStringOrBlob(table_entry, table.table);
-            context_data[idx] = StringVector::AddStringOrBlob(context_entry, ToString(table.context));
+            if (name.found) {
+                catalog_data[idx] = StringVector::AddStringOrBlob(catalog_entry, name.catalog);
+            } else {
+                FlatVector::SetNull(catalog_entry, idx, true);
+            }
+            schema_data[idx] = StringVector::AddStringOrBlob(schema_entry, name.schema);
+            table_data[idx] = StringVector::AddStringOrBlob(table_entry, name.name);
+            if (!name.object_type.empty()) {
+                object_type_data[idx] = StringVector::AddStringOrBlob(object_type_entry, name.object_type);
+            } else {
+                FlatVector::SetNull(object_type_entry, idx, true);
+            }
+            context_data[idx] = StringVector::AddStringOrBlob(context_entry, ToString(parsed_tables[i].context));
         }
 
         return list_entry_t(current_size, number_of_tables);
@@ -325,6 +509,9 @@ static void IsParsableFunction(DataChunk &args, ExpressionState &state, Vector &
 
 void RegisterParseTablesFunction(DatabaseInstance &db) {
     TableFunction tf("parse_tables", {LogicalType::VARCHAR}, ParseTablesFunction, ParseTablesBind, ParseTablesInit);
+    tf.named_parameters["resolve"] = LogicalType::BOOLEAN;
+    tf.named_parameters["tolerant"] = LogicalType::BOOLEAN;
+    tf.cardinality = ParseTablesCardinality;
     ExtensionUtil::RegisterFunction(db, tf);
 }
 
@@ -343,8 +530,32 @@ void RegisterParseTableScalarFunction(DatabaseInstance &db) {
         {"table", LogicalType::VARCHAR},
         {"context", LogicalType::VARCHAR}
     }));
-    ScalarFunction sf("parse_tables", {LogicalType::VARCHAR}, return_type, ParseTablesScalarFunction_struct);
-    ExtensionUtil::RegisterFunction(db, sf);
+    // parse_tables(sql_query, tolerant) recovers tables from SQL that does not parse, e.g. truncated statements
+    auto tolerant_type = LogicalType::LIST(LogicalType::STRUCT({
+        {"schema", LogicalType::VARCHAR},
+        {"table", LogicalType::VARCHAR},
+        {"context", LogicalType::VARCHAR},
+        {"exact", LogicalType::BOOLEAN}
+    }));
+    ScalarFunctionSet tables_set("parse_tables");
+    tables_set.AddFunction(ScalarFunction({LogicalType::VARCHAR}, return_type, ParseTablesScalarFunction_struct));
+    tables_set.AddFunction(ScalarFunction({LogicalType::VARCHAR, LogicalType::BOOLEAN}, tolerant_type,
+                                          ParseTablesTolerantScalarFunction));
+    ExtensionUtil::RegisterFunction(db, tables_set);
+
+    // parse_tables_resolved looks each table up in the catalog and search path of the session
+    auto resolved_type = LogicalType::LIST(LogicalType::STRUCT({
+        {"catalog", LogicalType::VARCHAR},
+        {"schema", LogicalType::VARCHAR},
+        {"table", LogicalType::VARCHAR},
+        {"object_type", LogicalType::VARCHAR},
+        {"context", LogicalType::VARCHAR}
+    }));
+    ScalarFunction resolved("parse_tables_resolved", {LogicalType::VARCHAR}, resolved_type,
+                            ParseTablesResolvedScalarFunction, CatalogResolverBind);
+    // the result depends on the catalog, it must not be folded into a prepared statement
+    resolved.stability = FunctionStability::CONSISTENT_WITHIN_QUERY;
+    ExtensionUtil::RegisterFunction(db, resolved);
 
     // is_parsable is a scalar function that returns a boolean indicating whether the SQL query is parsable (no parse errors)
     ScalarFunction is_parsable("is_parsable", {LogicalType::VARCHAR}, LogicalType::BOOLEAN, IsParsableFunction);
@@ -0,0 +1,356 @@
+#include "parse_tables_recursive.hpp"
+#include "parse_tables.hpp"
+#include "parser_tools_limits.hpp"
+#include "duckdb.hpp"
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/catalog/catalog_entry/macro_catalog_entry.hpp"
+#include "duckdb/catalog/catalog_entry/view_catalog_entry.hpp"
+#include "duckdb/function/table_macro_function.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include "duckdb/parser/parser.hpp"
+#include "duckdb/parser/expression/function_expression.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+#include "duckdb/parser/query_node/select_node.hpp"
+#include "duckdb/parser/tableref/joinref.hpp"
+#include "duckdb/parser/tableref/subqueryref.hpp"
+#include "duckdb/parser/tableref/table_function_ref.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include <unordered_set>
+
+namespace duckdb {
+
+std::string QualifiedObjectName(const ResolvedName &object) {
+    if (!object.found) {
+        return object.schema + "." + object.name;
+    }
+    return object.catalog + "." + object.schema + "." + object.name;
+}
+
+static std::string ObjectKey(const ResolvedName &object) {
+    return object.object_type + ":" + QualifiedObjectName(object);
+}
+
+// Table functions in FROM clauses, which is how table macros are invoked
+static void CollectTableFunctionCalls(const QueryNode &node, std::vector<const FunctionExpression *> &calls);
+
+static void CollectTableFunctionCalls(const TableRef &ref, std::vector<const FunctionExpression *> &calls) {
+    switch (ref.type) {
+        case TableReferenceType::TABLE_FUNCTION: {
+            auto &table_function = (TableFunctionRef &)ref;
+            if (table_function.function && table_function.function->GetExpressionClass() == ExpressionClass::FUNCTION) {
+                calls.push_back(&(FunctionExpression &)*table_function.function);
+            }
+            break;
+        }
+        case TableReferenceType::JOIN: {
+            auto &join = (JoinRef &)ref;
+            CollectTableFunctionCalls(*join.left, calls);
+            CollectTableFunctionCalls(*join.right, calls);
+            break;
+        }
+        case TableReferenceType::SUBQUERY: {
+            auto &subquery = (SubqueryRef &)ref;
+            if (subquery.subquery && subquery.subquery->node) {
+                CollectTableFunctionCalls(*subquery.subquery->node, calls);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static void CollectTableFunctionCalls(const QueryNode &node, std::vector<const FunctionExpression *> &calls) {
+    if (node.type != QueryNodeType::SELECT_NODE) {
+        return;
+    }
+    auto &select_node = (SelectNode &)node;
+    for (const auto &entry : select_node.cte_map.map) {
+        if (entry.second && entry.second->query && entry.second->query->node) {
+            CollectTableFunctionCalls(*entry.second->query->node, calls);
+        }
+    }
+    if (select_node.from_table) {
+        CollectTableFunctionCalls(*select_node.from_table, calls);
+    }
+}
+
+// Names inside a view definition are bound relative to the view's own catalog and schema first
+static const ResolvedName &ResolveInScope(ClientContext &context, CatalogResolver &resolver, ResolveKind kind,
+                                          const std::string &catalog, const std::string &schema,
+                                          const std::string &name, const ResolvedName *scope) {
+    if (scope && catalog.empty()) {
+        auto &scoped = resolver.Resolve(context, kind, scope->catalog, schema.empty() ? scope->schema : schema, name);
+        if (scoped.found) {
+            return scoped;
+        }
+    }
+    return resolver.Resolve(context, kind, catalog, schema, name);
+}
+
+void CollectDependencies(ClientContext &context, CatalogResolver &resolver, const QueryNode &node,
+                         const ResolvedName *scope, std::vector<ResolvedName> &results) {
+    std::unordered_set<std::string> seen;
+    auto add = [&](const ResolvedName &object) {
+        if (seen.insert(ObjectKey(object)).second) {
+            results.push_back(object);
+        }
+    };
+
+    std::vector<TableRefResult> tables;
+    ExtractTablesFromQueryNode(node, tables);
+    for (auto &table : tables) {
+        if (table.context == TableContext::CTE || table.context == TableContext::FromCTE) {
+            continue;
+        }
+        add(ResolveInScope(context, resolver, ResolveKind::Table, table.catalog_name, table.schema_name, table.table,
+                           scope));
+    }
+
+    std::vector<const FunctionExpression *> calls;
+    CollectTableFunctionCalls(node, calls);
+    for (auto call : calls) {
+        add(ResolveInScope(context, resolver, ResolveKind::TableFunction, call->catalog, call->schema,
+                           call->function_name, scope));
+    }
+}
+
+static optional_ptr<CatalogEntry> GetDefinition(ClientContext &context, CatalogType type, const ResolvedName &object) {
+    try {
+        auto entry = Catalog::GetEntry(context, type, object.catalog, object.schema, object.name,
+                                       OnEntryNotFound::RETURN_NULL);
+        if (entry && entry->type == type) {
+            return entry;
+        }
+    } catch (const CatalogException &ex) {
+        // dropped since it was resolved
+    }
+    return nullptr;
+}
+
+const std::vector<ResolvedName> &DependencyGraph::Dependencies(ClientContext &context, const ResolvedName &object) {
+    static const std::vector<ResolvedName> NO_DEPENDENCIES;
+    if (!object.found || (object.object_type != "view" && object.object_type != "table_macro")) {
+        return NO_DEPENDENCIES;
+    }
+
+    auto key = ObjectKey(object);
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto cached = dependencies.find(key);
+        if (cached != dependencies.end()) {
+            return cached->second;
+        }
+    }
+
+    // walk the definition outside of the lock, it may recurse into the resolver
+    std::vector<ResolvedName> result;
+    if (object.object_type == "view") {
+        auto entry = GetDefinition(context, CatalogType::VIEW_ENTRY, object);
+        if (entry) {
+            auto &view = entry->Cast<ViewCatalogEntry>();
+            if (view.query && view.query->node) {
+                CollectDependencies(context, resolver, *view.query->node, &object, result);
+            }
+        }
+    } else {
+        auto entry = GetDefinition(context, CatalogType::TABLE_MACRO_ENTRY, object);
+        if (entry) {
+            // every overload of the macro contributes its dependencies
+            auto &macro = entry->Cast<MacroCatalogEntry>();
+            for (auto &function : macro.macros) {
+                if (function->type != MacroType::TABLE_MACRO) {
+                    continue;
+                }
+                auto &table_macro = function->Cast<TableMacroFunction>();
+                if (table_macro.query_node) {
+                    CollectDependencies(context, resolver, *table_macro.query_node, &object, result);
+                }
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+    return dependencies.emplace(std::move(key), std::move(result)).first->second;
+}
+
+void DependencyGraph::Expand(ClientContext &context, const std::vector<ResolvedName> &roots,
+                             std::vector<DependencyResult> &results) {
+    // every object is expanded once, so each edge of the DAG is reported once, at the depth at
+    // which its parent was first reached
+    std::unordered_set<std::string> expanded;
+    std::vector<const ResolvedName *> level;
+    for (auto &root : roots) {
+        results.push_back(DependencyResult{root, "", 0});
+        if (expanded.insert(ObjectKey(root)).second) {
+            level.push_back(&root);
+        }
+    }
+
+    for (idx_t depth = 1; !level.empty(); depth++) {
+        std::vector<const ResolvedName *> next_level;
+        for (auto parent : level) {
+            auto &children = Dependencies(context, *parent);
+            if (children.empty()) {
+                continue;
+            }
+            auto parent_name = QualifiedObjectName(*parent);
+            for (auto &child : children) {
+                results.push_back(DependencyResult{child, parent_name, depth});
+                if (expanded.insert(ObjectKey(child)).second) {
+                    next_level.push_back(&child);
+                }
+            }
+        }
+        level = std::move(next_level);
+    }
+}
+
+static void ExtractDependenciesFromSQL(ClientContext &context, DependencyGraph &graph, const std::string &sql,
+                                       std::vector<DependencyResult> &results) {
+    if (!ExtractionBudget::AllowInput(sql)) {
+        return;
+    }
+
+    Parser parser;
+
+    try {
+        parser.ParseQuery(sql);
+    } catch (const ParserException &ex) {
+        // swallow parser exceptions to make this function more robust. is_parsable can be used if needed
+        return;
+    }
+
+    if (!ExtractionBudget::CheckDeadline()) {
+        return;
+    }
+
+    std::vector<ResolvedName> roots;
+    for (auto &stmt : parser.statements) {
+        if (stmt->type == StatementType::SELECT_STATEMENT) {
+            auto &select_stmt = (SelectStatement &)*stmt;
+            if (select_stmt.node) {
+                CollectDependencies(context, graph.resolver, *select_stmt.node, nullptr, roots);
+            }
+        }
+    }
+    graph.Expand(context, roots, results);
+}
+
+struct DependencyGraphBindData : public FunctionData {
+    shared_ptr<DependencyGraph> graph;
+
+    unique_ptr<FunctionData> Copy() const override {
+        auto copy = make_uniq<DependencyGraphBindData>();
+        copy->graph = graph;
+        return std::move(copy);
+    }
+
+    bool Equals(const FunctionData &other) const override {
+        return true;
+    }
+};
+
+static unique_ptr<FunctionData> ParseTablesRecursiveBind(ClientContext &context, ScalarFunction &bound_function,
+                                                         vector<unique_ptr<Expression>> &arguments) {
+    // one graph per bound expression, shared by every row and thread of the scan
+    auto result = make_uniq<DependencyGraphBindData>();
+    result->graph = make_shared_ptr<DependencyGraph>();
+    return std::move(result);
+}
+
+static void ParseTablesRecursiveScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    auto &context = state.GetContext();
+    auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+    auto &graph = *func_expr.bind_info->Cast<DependencyGraphBindData>().graph;
+    auto limits = ParserToolsLimits::Get(context);
+
+    UnaryExecutor::ExecuteWithNulls<string_t, list_entry_t>(args.data[0], result, args.size(),
+    [&](string_t query, ValidityMask &mask, idx_t row) -> list_entry_t {
+        std::vector<DependencyResult> dependencies;
+        ExtractionBudget budget(limits);
+        ExtractDependenciesFromSQL(context, graph, query.GetString(), dependencies);
+        if (!budget.KeepResult("parse_tables_recursive")) {
+            mask.SetInvalid(row);
+            return list_entry_t();
+        }
+
+        auto current_size = ListVector::GetListSize(result);
+        auto number_of_dependencies = dependencies.size();
+        auto new_size = current_size + number_of_dependencies;
+
+        // Grow list vector if needed
+        if (ListVector::GetListCapacity(result) < new_size) {
+            ListVector::Reserve(result, new_size);
+        }
+
+        // Get the struct child vector of the list
+        auto &struct_vector = ListVector::GetEntry(result);
+
+        // Ensure list size is updated
+        ListVector::SetListSize(result, new_size);
+
+        // Get the fields in the STRUCT
+        auto &entries = StructVector::GetEntries(struct_vector);
+        auto &catalog_entry = *entries[0];     // "catalog" field
+        auto &schema_entry = *entries[1];      // "schema" field
+        auto &table_entry = *entries[2];       // "table" field
+        auto &object_type_entry = *entries[3]; // "object_type" field
+        auto &depth_entry = *entries[4];       // "depth" field
+        auto &parent_entry = *entries[5];      // "parent" field
+
+        auto catalog_data = FlatVector::GetData<string_t>(catalog_entry);
+        auto schema_data = FlatVector::GetData<string_t>(schema_entry);
+        auto table_data = FlatVector::GetData<string_t>(table_entry);
+        auto object_type_data = FlatVector::GetData<string_t>(object_type_entry);
+        auto depth_data = FlatVector::GetData<int32_t>(depth_entry);
+        auto parent_data = FlatVector::GetData<string_t>(parent_entry);
+
+        for (size_t i = 0; i < number_of_dependencies; i++) {
+            const auto &dependency = dependencies[i];
+            const auto &object = dependency.object;
+            auto idx = current_size + i;
+
+            if (object.found) {
+                catalog_data[idx] = StringVector::AddStringOrBlob(catalog_entry, object.catalog);
+                object_type_data[idx] = StringVector::AddStringOrBlob(object_type_entry, object.object_type);
+            } else {
+                FlatVector::SetNull(catalog_entry, idx, true);
+                FlatVector::SetNull(object_type_entry, idx, true);
+            }
+            schema_data[idx] = StringVector::AddStringOrBlob(schema_entry, object.schema);
+            table_data[idx] = StringVector::AddStringOrBlob(table_entry, object.name);
+            depth_data[idx] = (int32_t)dependency.depth;
+            if (dependency.parent.empty()) {
+                FlatVector::SetNull(parent_entry, idx, true);
+            } else {
+                parent_data[idx] = StringVector::AddStringOrBlob(parent_entry, dependency.parent);
+            }
+        }
+
+        return list_entry_t(current_size, number_of_dependencies);
+    });
+}
+
+// Extension scaffolding
+// ---------------------------------------------------
+
+void RegisterParseTablesRecursiveFunction(DatabaseInstance &db) {
+    // parse_tables_recursive expands views and table macros down to the objects they read from
+    auto return_type = LogicalType::LIST(LogicalType::STRUCT({
+        {"catalog", LogicalType::VARCHAR},
+        {"schema", LogicalType::VARCHAR},
+        {"table", LogicalType::VARCHAR},
+        {"object_type", LogicalType::VARCHAR},
+        {"depth", LogicalType::INTEGER},
+        {"parent", LogicalType::VARCHAR}
+    }));
+    ScalarFunction sf("parse_tables_recursive", {LogicalType::VARCHAR}, return_type,
+                      ParseTablesRecursiveScalarFunction, ParseTablesRecursiveBind);
+    // the result depends on the catalog, it must not be folded into a prepared statement
+    sf.stability = FunctionStability::CONSISTENT_WITHIN_QUERY;
+    ExtensionUtil::RegisterFunction(db, sf);
+}
+
+} // namespace duckdb
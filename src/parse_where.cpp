@@ -1,35 +1,31 @@
 #include "parse_where.hpp"
+#include "parser_tools_limits.hpp"
+#include "sql_scanner.hpp"
 #include "duckdb.hpp"
-#include "duckdb/parser/parser.hpp"
-#include "duckdb/parser/statement/select_statement.hpp"
-#include "duckdb/parser/query_node/select_node.hpp"
-#include "duckdb/parser/expression/columnref_expression.hpp"
-#include "duckdb/parser/expression/comparison_expression.hpp"
-#include "duckdb/parser/expression/conjunction_expression.hpp"
-#include "duckdb/parser/expression/constant_expression.hpp"
-#include "duckdb/parser/expression/function_expression.hpp"
-#include "duckdb/parser/expression/operator_expression.hpp"
-#include "duckdb/parser/expression/star_expression.hpp"
-#include "duckdb/parser/expression/subquery_expression.hpp"
-#include "duckdb/parser/expression/window_expression.hpp"
-#include "duckdb/parser/expression/case_expression.hpp"
-#include "duckdb/parser/expression/cast_expression.hpp"
-#include "duckdb/parser/expression/between_expression.hpp"
-#include "duckdb/parser/expression/lambda_expression.hpp"
-#include "duckdb/parser/expression/positional_reference_expression.hpp"
-#include "duckdb/parser/expression/parameter_expression.hpp"
-#include "duckdb/parser/tableref/basetableref.hpp"
 #include "duckdb/main/extension_util.hpp"
+#include "duckdb/storage/statistics/node_statistics.hpp"
 
 namespace duckdb {
 
-struct ParseWhereState : public GlobalTableFunctionState {
-    idx_t row = 0;
-    vector<WhereConditionResult> results;
-};
+// The SQL functions show conditions that cannot be attributed to a table with a placeholder
+static string TableNameOrEmpty(const string &table_name) {
+    return table_name.empty() ? "(empty)" : table_name;
+}
 
 struct ParseWhereBindData : public TableFunctionData {
     string sql;
+    // extracted once at bind time, shared by every scan of the (prepared) statement
+    vector<WhereConditionResult> results;
+    // large inputs are instead extracted by the scan, one statement at a time
+    bool statement_at_a_time = false;
+};
+
+struct ParseWhereState : public GlobalTableFunctionState {
+    idx_t row = 0;
+    // statement at a time: the results of the current statement only
+    unique_ptr<StatementCursor> cursor;
+    ParserToolsLimits limits;
+    vector<WhereConditionResult> results;
 };
 
 static unique_ptr<FunctionData> ParseWhereBind(ClientContext &context, 
@@ -49,195 +45,135 @@ static unique_ptr<FunctionData> ParseWhereBind(ClientContext &context,
     auto result = make_uniq<ParseWhereBindData>();
     result->sql = sql_input;
 
+    // parse during binding so the optimizer knows the exact cardinality
+    auto limits = ParserToolsLimits::Get(context);
+    ExtractionBudget budget(limits);
+    if (result->sql.size() >= STATEMENT_AT_A_TIME_MIN_BYTES && ExtractionBudget::AllowInputSize(result->sql.size())) {
+        result->statement_at_a_time = true;
+    } else {
+        ExtractWhereConditionsFromSQL(result->sql, result->results);
+    }
+    if (!budget.KeepResult("parse_where")) {
+        result->results.clear();
+    }
+
     return std::move(result);
 }
 
-static unique_ptr<GlobalTableFunctionState> ParseWhereInit(ClientContext &context,
-    TableFunctionInitInput &input) {
-    return make_uniq<ParseWhereState>();
+static unique_ptr<NodeStatistics> ParseWhereCardinality(ClientContext &context, const FunctionData *bind_data_p) {
+    auto &bind_data = (const ParseWhereBindData &)*bind_data_p;
+    if (bind_data.statement_at_a_time) {
+        return make_uniq<NodeStatistics>();
+    }
+    return make_uniq<NodeStatistics>(bind_data.results.size(), bind_data.results.size());
 }
 
-static string ExpressionToString(const ParsedExpression &expr) {
-    return expr.ToString();
+static unique_ptr<GlobalTableFunctionState> ParseWhereInit(ClientContext &context,
+    TableFunctionInitInput &input) {
+    auto &bind_data = (const ParseWhereBindData &)*input.bind_data;
+    auto result = make_uniq<ParseWhereState>();
+    if (bind_data.statement_at_a_time) {
+        result->cursor = make_uniq<StatementCursor>(bind_data.sql);
+        result->limits = ParserToolsLimits::Get(context);
+    }
+    return std::move(result);
 }
 
-static void ExtractWhereConditionsFromExpression(
-    const ParsedExpression &expr,
-    vector<WhereConditionResult> &results,
-    const string &context = "WHERE",
-    const string &table_name = ""
-) {
-    if (expr.type == ExpressionType::INVALID) return;
-
-    switch (expr.GetExpressionClass()) {
-        case ExpressionClass::CONJUNCTION: {
-            auto &conj = (ConjunctionExpression &)expr;
-            for (auto &child : conj.children) {
-                ExtractWhereConditionsFromExpression(*child, results, context, table_name);
-            }
-            break;
-        }
-        case ExpressionClass::COMPARISON: {
-            auto &comp = (ComparisonExpression &)expr;
-            results.push_back(WhereConditionResult{
-                ExpressionToString(comp),
-                table_name,
-                context
-            });
-            break;
-        }
-        case ExpressionClass::OPERATOR: {
-            auto &op = (OperatorExpression &)expr;
-            results.push_back(WhereConditionResult{
-                ExpressionToString(op),
-                table_name,
-                context
-            });
-            break;
-        }
-        case ExpressionClass::FUNCTION: {
-            auto &func = (FunctionExpression &)expr;
-            results.push_back(WhereConditionResult{
-                ExpressionToString(func),
-                table_name,
-                context
-            });
-            break;
-        }
-        case ExpressionClass::BETWEEN: {
-            auto &between = (BetweenExpression &)expr;
-            results.push_back(WhereConditionResult{
-                ExpressionToString(between),
-                table_name,
-                context
-            });
-            break;
+// Replaces the scan's results with those of the next statement that has any, returns false at the
+// end of the input. The resource limits apply to each statement on its own.
+static bool ExtractNextStatement(ParseWhereState &state) {
+    state.results.clear();
+    state.row = 0;
+    std::string statement;
+    while (state.results.empty() && state.cursor->Next(statement)) {
+        ExtractionBudget budget(state.limits);
+        ExtractWhereConditionsFromSQL(statement, state.results);
+        if (!budget.KeepResult("parse_where")) {
+            state.results.clear();
         }
-        case ExpressionClass::CASE: {
-            auto &case_expr = (CaseExpression &)expr;
-            results.push_back(WhereConditionResult{
-                ExpressionToString(case_expr),
-                table_name,
-                context
-            });
-            break;
-        }
-        default:
-            break;
     }
+    return !state.results.empty();
 }
 
-static void ExtractWhereConditionsFromQueryNode(
-    const QueryNode &node,
-    vector<WhereConditionResult> &results
-) {
-    if (node.type == QueryNodeType::SELECT_NODE) {
-        auto &select_node = (SelectNode &)node;
-        string table_name = "(empty)";  // Default table name
-
-        // Extract table name from FROM clause
-        if (select_node.from_table) {
-            if (select_node.from_table->type == TableReferenceType::BASE_TABLE) {
-                auto &base = (BaseTableRef &)*select_node.from_table;
-                table_name = base.table_name;
-            }
-        }
+static void ParseWhereFunction(ClientContext &context,
+                   TableFunctionInput &data,
+                   DataChunk &output) {
+    auto &state = (ParseWhereState &)*data.global_state;
+    auto &bind_data = (ParseWhereBindData &)*data.bind_data;
+    auto &results = bind_data.statement_at_a_time ? state.results : bind_data.results;
 
-        // Extract WHERE conditions
-        if (select_node.where_clause) {
-            ExtractWhereConditionsFromExpression(*select_node.where_clause, results, "WHERE", table_name);
+    idx_t count = 0;
+    while (count < STANDARD_VECTOR_SIZE) {
+        if (state.row >= results.size()) {
+            if (bind_data.statement_at_a_time && ExtractNextStatement(state)) {
+                continue;
+            }
+            break;
         }
+        auto &result = results[state.row];
+        output.SetValue(0, count, Value(result.condition));
+        output.SetValue(1, count, Value(TableNameOrEmpty(result.table_name)));
+        output.SetValue(2, count, Value(result.context));
 
-        // Extract HAVING conditions
-        if (select_node.having) {
-            ExtractWhereConditionsFromExpression(*select_node.having, results, "HAVING", table_name);
-        }
+        state.row++;
+        count++;
     }
+    output.SetCardinality(count);
 }
 
-static void ExtractWhereConditionsFromSQL(const string &sql, vector<WhereConditionResult> &results) {
-    Parser parser;
+list_entry_t WriteWhereConditionList(Vector &result, const std::vector<WhereConditionResult> &conditions) {
+    auto current_size = ListVector::GetListSize(result);
+    auto number_of_conditions = conditions.size();
+    auto new_size = current_size + number_of_conditions;
 
-    try {
-        parser.ParseQuery(sql);
-    } catch (const ParserException &ex) {
-        return;
+    if (ListVector::GetListCapacity(result) < new_size) {
+        ListVector::Reserve(result, new_size);
     }
 
-    for (auto &stmt : parser.statements) {
-        if (stmt->type == StatementType::SELECT_STATEMENT) {
-            auto &select_stmt = (SelectStatement &)*stmt;
-            if (select_stmt.node) {
-                ExtractWhereConditionsFromQueryNode(*select_stmt.node, results);
-            }
-        }
-    }
-}
+    auto &struct_vector = ListVector::GetEntry(result);
+    auto &entries = StructVector::GetEntries(struct_vector);
+    auto &condition_entry = *entries[0];
+    auto &table_entry = *entries[1];
+    auto &context_entry = *entries[2];
 
-static void ParseWhereFunction(ClientContext &context,
-                   TableFunctionInput &data,
-                   DataChunk &output) {
-    auto &state = (ParseWhereState &)*data.global_state;
-    auto &bind_data = (ParseWhereBindData &)*data.bind_data;
+    auto condition_data = FlatVector::GetData<string_t>(condition_entry);
+    auto table_data = FlatVector::GetData<string_t>(table_entry);
+    auto context_data = FlatVector::GetData<string_t>(context_entry);
 
-    if (state.results.empty() && state.row == 0) {
-        ExtractWhereConditionsFromSQL(bind_data.sql, state.results);
-    }
+    for (size_t i = 0; i < number_of_conditions; i++) {
+        const auto &condition = conditions[i];
+        auto idx = current_size + i;
 
-    if (state.row >= state.results.size()) {
-        return;
+        condition_data[idx] = StringVector::AddStringOrBlob(condition_entry, condition.condition);
+        table_data[idx] = StringVector::AddStringOrBlob(table_entry, TableNameOrEmpty(condition.table_name));
+        context_data[idx] = StringVector::AddStringOrBlob(context_entry, condition.context);
     }
 
-    auto &result = state.results[state.row];
-    output.SetCardinality(1);
-    output.SetValue(0, 0, Value(result.condition));
-    output.SetValue(1, 0, Value(result.table_name));
-    output.SetValue(2, 0, Value(result.context));
-
-    state.row++;
+    ListVector::SetListSize(result, new_size);
+    return list_entry_t(current_size, number_of_conditions);
 }
 
 static void ParseWhereScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-    UnaryExecutor::Execute<string_t, list_entry_t>(args.data[0], result, args.size(),
-    [&result](string_t query) -> list_entry_t {
+    auto limits = ParserToolsLimits::Get(state.GetContext());
+
+    UnaryExecutor::ExecuteWithNulls<string_t, list_entry_t>(args.data[0], result, args.size(),
+    [&result, &limits](string_t query, ValidityMask &mask, idx_t row) -> list_entry_t {
         auto query_string = query.GetString();
         vector<WhereConditionResult> conditions;
+        ExtractionBudget budget(limits);
         ExtractWhereConditionsFromSQL(query_string, conditions);
-
-        auto current_size = ListVector::GetListSize(result);
-        auto number_of_conditions = conditions.size();
-        auto new_size = current_size + number_of_conditions;
-
-        if (ListVector::GetListCapacity(result) < new_size) {
-            ListVector::Reserve(result, new_size);
-        }
-
-        auto &struct_vector = ListVector::GetEntry(result);
-        auto &entries = StructVector::GetEntries(struct_vector);
-        auto &condition_entry = *entries[0];
-        auto &table_entry = *entries[1];
-        auto &context_entry = *entries[2];
-
-        auto condition_data = FlatVector::GetData<string_t>(condition_entry);
-        auto table_data = FlatVector::GetData<string_t>(table_entry);
-        auto context_data = FlatVector::GetData<string_t>(context_entry);
-
-        for (size_t i = 0; i < number_of_conditions; i++) {
-            const auto &condition = conditions[i];
-            auto idx = current_size + i;
-
-            condition_data[idx] = StringVector::AddStringOrBlob(condition_entry, condition.condition);
-            table_data[idx] = StringVector::AddStringOrBlob(table_entry, condition.table_name);
-            context_data[idx] = StringVector::AddStringOrBlob(context_entry, condition.context);
+        if (!budget.KeepResult("parse_where")) {
+            mask.SetInvalid(row);
+            return list_entry_t();
         }
 
-        ListVector::SetListSize(result, new_size);
-        return list_entry_t(current_size, number_of_conditions);
+        return WriteWhereConditionList(result, conditions);
     });
 }
 
 void RegisterParseWhereFunction(DatabaseInstance &db) {
     TableFunction tf("parse_where", {LogicalType::VARCHAR}, ParseWhereFunction, ParseWhereBind, ParseWhereInit);
+    tf.cardinality = ParseWhereCardinality;
     ExtensionUtil::RegisterFunction(db, tf);
 }
 
@@ -251,147 +187,22 @@ void RegisterParseWhereScalarFunction(DatabaseInstance &db) {
     ExtensionUtil::RegisterFunction(db, sf);
 }
 
-static string DetailedExpressionTypeToOperator(ExpressionType type) {
-    switch (type) {
-        case ExpressionType::COMPARE_EQUAL:
-            return "=";
-        case ExpressionType::COMPARE_NOTEQUAL:
-            return "!=";
-        case ExpressionType::COMPARE_LESSTHAN:
-            return "<";
-        case ExpressionType::COMPARE_GREATERTHAN:
-            return ">";
-        case ExpressionType::COMPARE_LESSTHANOREQUALTO:
-            return "<=";
-        case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
-            return ">=";
-        case ExpressionType::COMPARE_DISTINCT_FROM:
-            return "IS DISTINCT FROM";
-        case ExpressionType::COMPARE_NOT_DISTINCT_FROM:
-            return "IS NOT DISTINCT FROM";
-        default:
-            return "UNKNOWN";
-    }
-}
-
-static void ExtractDetailedWhereConditionsFromExpression(
-    const ParsedExpression &expr,
-    vector<DetailedWhereConditionResult> &results,
-    const string &context = "WHERE",
-    const string &table_name = ""
-) {
-    if (expr.type == ExpressionType::INVALID) return;
-
-    switch (expr.GetExpressionClass()) {
-        case ExpressionClass::CONJUNCTION: {
-            auto &conj = (ConjunctionExpression &)expr;
-            for (auto &child : conj.children) {
-                ExtractDetailedWhereConditionsFromExpression(*child, results, context, table_name);
-            }
-            break;
-        }
-        case ExpressionClass::COMPARISON: {
-            auto &comp = (ComparisonExpression &)expr;
-            DetailedWhereConditionResult result;
-            result.context = context;
-            result.table_name = table_name;
-            
-            // Extract column name
-            if (comp.left->GetExpressionClass() == ExpressionClass::COLUMN_REF) {
-                auto &col_ref = (ColumnRefExpression &)*comp.left;
-                result.column_name = col_ref.GetColumnName();
-            }
-            
-            // Extract operator
-            result.operator_type = DetailedExpressionTypeToOperator(comp.type);
-            
-            // Extract value
-            if (comp.right->GetExpressionClass() == ExpressionClass::CONSTANT) {
-                auto &const_expr = (ConstantExpression &)*comp.right;
-                result.value = const_expr.value.ToString();
-            } else {
-                result.value = comp.right->ToString();
-            }
-            
-            results.push_back(result);
-            break;
-        }
-        case ExpressionClass::BETWEEN: {
-            auto &between = (BetweenExpression &)expr;
-            DetailedWhereConditionResult result;
-            result.context = context;
-            result.table_name = table_name;
-            
-            // Extract column name
-            if (between.input->GetExpressionClass() == ExpressionClass::COLUMN_REF) {
-                auto &col_ref = (ColumnRefExpression &)*between.input;
-                result.column_name = col_ref.GetColumnName();
-            }
-            
-            // For BETWEEN, we'll create two conditions: >= lower AND <= upper
-            result.operator_type = ">=";
-            if (between.lower->GetExpressionClass() == ExpressionClass::CONSTANT) {
-                auto &const_expr = (ConstantExpression &)*between.lower;
-                result.value = const_expr.value.ToString();
-            } else {
-                result.value = between.lower->ToString();
-            }
-            results.push_back(result);
-            
-            // Add the upper bound condition
-            DetailedWhereConditionResult upper_result = result;
-            upper_result.operator_type = "<=";
-            if (between.upper->GetExpressionClass() == ExpressionClass::CONSTANT) {
-                auto &const_expr = (ConstantExpression &)*between.upper;
-                upper_result.value = const_expr.value.ToString();
-            } else {
-                upper_result.value = between.upper->ToString();
-            }
-            results.push_back(upper_result);
-            break;
-        }
-        case ExpressionClass::OPERATOR: {
-            auto &op = (OperatorExpression &)expr;
-            if (op.children.size() >= 2) {
-                DetailedWhereConditionResult result;
-                result.context = context;
-                result.table_name = table_name;
-                
-                // Extract column name
-                if (op.children[0]->GetExpressionClass() == ExpressionClass::COLUMN_REF) {
-                    auto &col_ref = (ColumnRefExpression &)*op.children[0];
-                    result.column_name = col_ref.GetColumnName();
-                }
-                
-                // Extract operator
-                result.operator_type = DetailedExpressionTypeToOperator(op.type);
-                
-                // Extract value
-                if (op.children[1]->GetExpressionClass() == ExpressionClass::CONSTANT) {
-                    auto &const_expr = (ConstantExpression &)*op.children[1];
-                    result.value = const_expr.value.ToString();
-                } else {
-                    result.value = op.children[1]->ToString();
-                }
-                
-                results.push_back(result);
-            }
-            break;
-        }
-        default:
-            break;
-    }
-}
+struct ParseWhereDetailedBindData : public TableFunctionData {
+    string sql;
+    // extracted once at bind time, shared by every scan of the (prepared) statement
+    vector<DetailedWhereConditionResult> results;
+    // large inputs are instead extracted by the scan, one statement at a time
+    bool statement_at_a_time = false;
+};
 
 struct ParseWhereDetailedState : public GlobalTableFunctionState {
     idx_t row = 0;
+    // statement at a time: the results of the current statement only
+    unique_ptr<StatementCursor> cursor;
+    ParserToolsLimits limits;
     vector<DetailedWhereConditionResult> results;
 };
 
-struct ParseWhereDetailedBindData : public TableFunctionData {
-    string sql;
-};
-
 static unique_ptr<FunctionData> ParseWhereDetailedBind(ClientContext &context, 
                                     TableFunctionBindInput &input, 
                                     vector<LogicalType> &return_types, 
@@ -411,12 +222,54 @@ static unique_ptr<FunctionData> ParseWhereDetailedBind(ClientContext &context,
     auto result = make_uniq<ParseWhereDetailedBindData>();
     result->sql = sql_input;
 
+    // parse during binding so the optimizer knows the exact cardinality
+    auto limits = ParserToolsLimits::Get(context);
+    ExtractionBudget budget(limits);
+    if (result->sql.size() >= STATEMENT_AT_A_TIME_MIN_BYTES && ExtractionBudget::AllowInputSize(result->sql.size())) {
+        result->statement_at_a_time = true;
+    } else {
+        ExtractDetailedWhereConditionsFromSQL(result->sql, result->results);
+    }
+    if (!budget.KeepResult("parse_where_detailed")) {
+        result->results.clear();
+    }
+
     return std::move(result);
 }
 
+static unique_ptr<NodeStatistics> ParseWhereDetailedCardinality(ClientContext &context, const FunctionData *bind_data_p) {
+    auto &bind_data = (const ParseWhereDetailedBindData &)*bind_data_p;
+    if (bind_data.statement_at_a_time) {
+        return make_uniq<NodeStatistics>();
+    }
+    return make_uniq<NodeStatistics>(bind_data.results.size(), bind_data.results.size());
+}
+
 static unique_ptr<GlobalTableFunctionState> ParseWhereDetailedInit(ClientContext &context,
     TableFunctionInitInput &input) {
-    return make_uniq<ParseWhereDetailedState>();
+    auto &bind_data = (const ParseWhereDetailedBindData &)*input.bind_data;
+    auto result = make_uniq<ParseWhereDetailedState>();
+    if (bind_data.statement_at_a_time) {
+        result->cursor = make_uniq<StatementCursor>(bind_data.sql);
+        result->limits = ParserToolsLimits::Get(context);
+    }
+    return std::move(result);
+}
+
+// Replaces the scan's results with those of the next statement that has any, returns false at the
+// end of the input. The resource limits apply to each statement on its own.
+static bool ExtractNextStatement(ParseWhereDetailedState &state) {
+    state.results.clear();
+    state.row = 0;
+    std::string statement;
+    while (state.results.empty() && state.cursor->Next(statement)) {
+        ExtractionBudget budget(state.limits);
+        ExtractDetailedWhereConditionsFromSQL(statement, state.results);
+        if (!budget.KeepResult("parse_where_detailed")) {
+            state.results.clear();
+        }
+    }
+    return !state.results.empty();
 }
 
 static void ParseWhereDetailedFunction(ClientContext &context,
@@ -424,60 +277,32 @@ static void ParseWhereDetailedFunction(ClientContext &context,
                    DataChunk &output) {
     auto &state = (ParseWhereDetailedState &)*data.global_state;
     auto &bind_data = (ParseWhereDetailedBindData &)*data.bind_data;
+    auto &results = bind_data.statement_at_a_time ? state.results : bind_data.results;
 
-    if (state.results.empty() && state.row == 0) {
-        Parser parser;
-        try {
-            parser.ParseQuery(bind_data.sql);
-        } catch (const ParserException &ex) {
-            return;
-        }
-
-        for (auto &stmt : parser.statements) {
-            if (stmt->type == StatementType::SELECT_STATEMENT) {
-                auto &select_stmt = (SelectStatement &)*stmt;
-                if (select_stmt.node) {
-                    if (select_stmt.node->type == QueryNodeType::SELECT_NODE) {
-                        auto &select_node = (SelectNode &)*select_stmt.node;
-                        string table_name = "(empty)";  // Default table name
-                        
-                        // Try to extract table name from FROM clause
-                        if (select_node.from_table) {
-                            if (select_node.from_table->type == TableReferenceType::BASE_TABLE) {
-                                auto &base_table = (BaseTableRef &)*select_node.from_table;
-                                table_name = base_table.table_name;
-                            }
-                        }
-                        
-                        if (select_node.where_clause) {
-                            ExtractDetailedWhereConditionsFromExpression(*select_node.where_clause, state.results, "WHERE", table_name);
-                        }
-                        if (select_node.having) {
-                            ExtractDetailedWhereConditionsFromExpression(*select_node.having, state.results, "HAVING", table_name);
-                        }
-                    }
-                }
+    idx_t count = 0;
+    while (count < STANDARD_VECTOR_SIZE) {
+        if (state.row >= results.size()) {
+            if (bind_data.statement_at_a_time && ExtractNextStatement(state)) {
+                continue;
             }
+            break;
         }
+        auto &result = results[state.row];
+        output.SetValue(0, count, Value(result.column_name));
+        output.SetValue(1, count, Value(result.operator_type));
+        output.SetValue(2, count, Value(result.value));
+        output.SetValue(3, count, Value(TableNameOrEmpty(result.table_name)));
+        output.SetValue(4, count, Value(result.context));
+
+        state.row++;
+        count++;
     }
-
-    if (state.row >= state.results.size()) {
-        return;
-    }
-
-    auto &result = state.results[state.row];
-    output.SetCardinality(1);
-    output.SetValue(0, 0, Value(result.column_name));
-    output.SetValue(1, 0, Value(result.operator_type));
-    output.SetValue(2, 0, Value(result.value));
-    output.SetValue(3, 0, Value(result.table_name));
-    output.SetValue(4, 0, Value(result.context));
-
-    state.row++;
+    output.SetCardinality(count);
 }
 
 void RegisterParseWhereDetailedFunction(DatabaseInstance &db) {
     TableFunction tf("parse_where_detailed", {LogicalType::VARCHAR}, ParseWhereDetailedFunction, ParseWhereDetailedBind, ParseWhereDetailedInit);
+    tf.cardinality = ParseWhereDetailedCardinality;
     ExtensionUtil::RegisterFunction(db, tf);
 }
 
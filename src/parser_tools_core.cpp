@@ -0,0 +1,49 @@
+#include "parser_tools_core.hpp"
+#include "parse_tables.hpp"
+#include "parse_functions.hpp"
+#include "parse_where.hpp"
+#include "duckdb.hpp"
+
+namespace parser_tools {
+
+std::vector<TableReference> ExtractTables(const std::string &sql) {
+    std::vector<duckdb::TableRefResult> tables;
+    duckdb::ExtractTablesFromSQL(sql, tables);
+
+    std::vector<TableReference> result;
+    result.reserve(tables.size());
+    for (auto &table : tables) {
+        result.push_back(TableReference{std::move(table.schema), std::move(table.table),
+                                        duckdb::ToString(table.context)});
+    }
+    return result;
+}
+
+std::vector<FunctionReference> ExtractFunctions(const std::string &sql) {
+    std::vector<duckdb::FunctionResult> functions;
+    duckdb::ExtractFunctionsFromSQL(sql, functions);
+
+    std::vector<FunctionReference> result;
+    result.reserve(functions.size());
+    for (auto &function : functions) {
+        result.push_back(FunctionReference{std::move(function.function_name), std::move(function.schema),
+                                           std::move(function.context)});
+    }
+    return result;
+}
+
+std::vector<PredicateReference> ExtractPredicates(const std::string &sql) {
+    std::vector<duckdb::DetailedWhereConditionResult> conditions;
+    duckdb::ExtractDetailedWhereConditionsFromSQL(sql, conditions);
+
+    std::vector<PredicateReference> result;
+    result.reserve(conditions.size());
+    for (auto &condition : conditions) {
+        result.push_back(PredicateReference{std::move(condition.column_name), std::move(condition.operator_type),
+                                            std::move(condition.value), std::move(condition.table_name),
+                                            std::move(condition.context)});
+    }
+    return result;
+}
+
+} // namespace parser_tools
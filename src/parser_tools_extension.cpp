@@ -4,6 +4,22 @@
 #include "parse_tables.hpp"
 #include "parse_where.hpp"
 #include "parse_functions.hpp"
+#include "sql_parameterize.hpp"
+#include "sql_minhash.hpp"
+#include "query_index.hpp"
+#include "parser_tools_limits.hpp"
+#include "literal_fast_path.hpp"
+#include "parse_tables_recursive.hpp"
+#include "sql_complexity.hpp"
+#include "sql_access_profile.hpp"
+#include "sql_rewrite_tables.hpp"
+#include "parse_aggregations.hpp"
+#include "parse_ordering.hpp"
+#include "query_capture.hpp"
+#include "result_cache.hpp"
+#include "parse_file_references.hpp"
+#include "parse_document.hpp"
+#include "predicate_sketch.hpp"
 #include "duckdb.hpp"
 #include "duckdb/common/exception.hpp"
 #include "duckdb/common/string_util.hpp"
@@ -23,6 +39,7 @@ namespace duckdb {
 // EXTENSION SCAFFOLDING
 
 static void LoadInternal(DatabaseInstance &instance) {
+	RegisterParserToolsSettings(instance);
     RegisterParseTablesFunction(instance);
 	RegisterParseTableScalarFunction(instance);
 	RegisterParseWhereFunction(instance);
@@ -30,6 +47,21 @@ static void LoadInternal(DatabaseInstance &instance) {
 	RegisterParseWhereDetailedFunction(instance);
 	RegisterParseFunctionsFunction(instance);
 	RegisterParseFunctionScalarFunction(instance);
+	RegisterSqlParameterizeFunction(instance);
+	RegisterSqlMinhashFunctions(instance);
+	RegisterQueryIndexFunctions(instance);
+	RegisterParseInsertValuesFunction(instance);
+	RegisterParseTablesRecursiveFunction(instance);
+	RegisterSqlComplexityFunction(instance);
+	RegisterSqlAccessProfileFunction(instance);
+	RegisterSqlRewriteTablesFunction(instance);
+	RegisterParseAggregationsFunction(instance);
+	RegisterParseOrderingFunction(instance);
+	RegisterQueryCaptureFunctions(instance);
+	RegisterResultCacheFunctions(instance);
+	RegisterParseFileReferencesFunction(instance);
+	RegisterParseDocumentFunctions(instance);
+	RegisterPredicateSketchFunctions(instance);
 }
 
 void ParserToolsExtension::Load(DuckDB &db) {
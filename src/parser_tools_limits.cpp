@@ -0,0 +1,78 @@
+#include "parser_tools_limits.hpp"
+#include "duckdb.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/config.hpp"
+
+namespace duckdb {
+
+static idx_t GetLimitSetting(ClientContext &context, const char *name) {
+    Value value;
+    if (!context.TryGetCurrentSetting(name, value) || value.IsNull()) {
+        return 0;
+    }
+    return UBigIntValue::Get(value.DefaultCastAs(LogicalType::UBIGINT));
+}
+
+static bool TryParseLimitBehavior(const Value &value, LimitBehavior &behavior) {
+    auto name = StringUtil::Lower(value.ToString());
+    if (name == "null") {
+        behavior = LimitBehavior::ReturnNull;
+    } else if (name == "error") {
+        behavior = LimitBehavior::Error;
+    } else if (name == "truncate") {
+        behavior = LimitBehavior::Truncate;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static void ThrowInvalidLimitBehavior(const Value &value) {
+    throw InvalidInputException("parser_tools_on_limit must be one of 'null', 'error' or 'truncate', got '%s'",
+                                value.ToString());
+}
+
+ParserToolsLimits ParserToolsLimits::Get(ClientContext &context) {
+    ParserToolsLimits limits;
+    limits.max_sql_bytes = GetLimitSetting(context, "parser_tools_max_sql_bytes");
+    limits.max_ast_nodes = GetLimitSetting(context, "parser_tools_max_ast_nodes");
+    limits.max_parse_ms = GetLimitSetting(context, "parser_tools_max_parse_ms");
+
+    Value on_limit;
+    if (context.TryGetCurrentSetting("parser_tools_on_limit", on_limit) && !on_limit.IsNull() &&
+        !TryParseLimitBehavior(on_limit, limits.on_limit)) {
+        // rejected by SET already, only reachable through a value set before the extension was loaded
+        ThrowInvalidLimitBehavior(on_limit);
+    }
+    return limits;
+}
+
+// Rejects unknown behaviors at SET time, so a typo does not break every extractor call afterwards
+static void SetOnLimit(ClientContext &context, SetScope scope, Value &parameter) {
+    LimitBehavior behavior;
+    if (!parameter.IsNull() && !TryParseLimitBehavior(parameter, behavior)) {
+        ThrowInvalidLimitBehavior(parameter);
+    }
+}
+
+// Extension scaffolding
+// ---------------------------------------------------
+
+void RegisterParserToolsSettings(DatabaseInstance &db) {
+    auto &config = DBConfig::GetConfig(db);
+    config.AddExtensionOption("parser_tools_max_sql_bytes",
+                              "Maximum size in bytes of a SQL value parsed by the parser_tools functions (0 = unlimited)",
+                              LogicalType::UBIGINT, Value::UBIGINT(0));
+    config.AddExtensionOption("parser_tools_max_ast_nodes",
+                              "Maximum number of AST nodes visited per SQL value by the parser_tools functions (0 = unlimited)",
+                              LogicalType::UBIGINT, Value::UBIGINT(0));
+    config.AddExtensionOption("parser_tools_max_parse_ms",
+                              "Maximum time in milliseconds spent parsing and extracting a single SQL value (0 = unlimited)",
+                              LogicalType::UBIGINT, Value::UBIGINT(0));
+    config.AddExtensionOption("parser_tools_on_limit",
+                              "What to do when a parser_tools limit is hit: 'null', 'error' or 'truncate'",
+                              LogicalType::VARCHAR, Value("null"), SetOnLimit);
+}
+
+} // namespace duckdb
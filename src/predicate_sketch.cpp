@@ -0,0 +1,718 @@
+#include "predicate_sketch.hpp"
+#include "parser_tools_limits.hpp"
+#include "duckdb.hpp"
+#include "duckdb/common/types/hash.hpp"
+#include "duckdb/common/types/timestamp.hpp"
+#include "duckdb/function/aggregate_function.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+namespace duckdb {
+
+static constexpr idx_t HLL_PRECISION = 10;
+static constexpr idx_t HLL_REGISTER_COUNT = idx_t(1) << HLL_PRECISION;
+
+// Capacity of the top level of a quantile sketch, lower levels hold 2/3 of the level above
+static constexpr idx_t QUANTILE_SKETCH_K = 200;
+static constexpr idx_t QUANTILE_SKETCH_MIN_CAPACITY = 8;
+
+static constexpr idx_t HEAVY_HITTER_COUNTERS = 32;
+
+// Bumped whenever the serialized layout or HashLiteral changes, registers of two versions cannot be merged
+static constexpr uint8_t PREDICATE_SKETCH_VERSION = 2;
+
+// The quantiles predicate_sketch_summary reports
+static const double SUMMARY_QUANTILES[] = {0, 0.01, 0.25, 0.5, 0.75, 0.99, 1};
+
+// ---------------------------------------------------
+// Distinct values
+// ---------------------------------------------------
+
+// Implemented locally (instead of using duckdb::Hash) so that persisted registers stay comparable
+// across DuckDB versions: FNV-1a over the literal, then the splitmix64 finalizer to spread the bits
+// the register index is taken from
+static uint64_t HashLiteral(const std::string &literal) {
+    uint64_t hash = 14695981039346656037ULL; // FNV-1a offset basis
+    for (auto c : literal) {
+        hash ^= (uint8_t)c;
+        hash *= 1099511628211ULL;
+    }
+    hash += 0x9E3779B97F4A7C15ULL;
+    hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+    return hash ^ (hash >> 31);
+}
+
+void DistinctSketch::Add(uint64_t hash) {
+    if (registers.empty()) {
+        registers.resize(HLL_REGISTER_COUNT);
+    }
+    auto index = hash >> (64 - HLL_PRECISION);
+    auto remaining = hash << HLL_PRECISION;
+    // position of the first set bit in the rest of the hash
+    uint8_t rank = 1;
+    while (rank <= 64 - HLL_PRECISION && (remaining & (uint64_t(1) << 63)) == 0) {
+        remaining <<= 1;
+        rank++;
+    }
+    registers[index] = MaxValue(registers[index], rank);
+}
+
+void DistinctSketch::Merge(const DistinctSketch &other) {
+    if (other.registers.empty()) {
+        return;
+    }
+    if (registers.empty()) {
+        registers = other.registers;
+        return;
+    }
+    for (idx_t i = 0; i < HLL_REGISTER_COUNT; i++) {
+        registers[i] = MaxValue(registers[i], other.registers[i]);
+    }
+}
+
+double DistinctSketch::Estimate() const {
+    if (registers.empty()) {
+        return 0;
+    }
+    double m = (double)HLL_REGISTER_COUNT;
+    double sum = 0;
+    idx_t zeros = 0;
+    for (auto rank : registers) {
+        sum += std::ldexp(1.0, -(int)rank);
+        zeros += rank == 0;
+    }
+    auto estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+    // linear counting is more accurate while many registers are still empty
+    if (estimate <= 2.5 * m && zeros > 0) {
+        estimate = m * std::log(m / (double)zeros);
+    }
+    return estimate;
+}
+
+// ---------------------------------------------------
+// Quantiles
+// ---------------------------------------------------
+
+idx_t QuantileSketch::Capacity(idx_t level) const {
+    auto depth = levels.size() - 1 - level;
+    auto capacity = (double)QUANTILE_SKETCH_K * std::pow(2.0 / 3.0, (double)depth);
+    return MaxValue<idx_t>(QUANTILE_SKETCH_MIN_CAPACITY, (idx_t)capacity);
+}
+
+void QuantileSketch::Compress() {
+    for (idx_t level = 0; level < levels.size(); level++) {
+        if (levels[level].size() < Capacity(level)) {
+            continue;
+        }
+        if (level + 1 == levels.size()) {
+            levels.emplace_back();
+        }
+        auto &values = levels[level];
+        auto &promoted = levels[level + 1];
+        std::sort(values.begin(), values.end());
+        // an odd value out stays on its level, so the total weight does not change
+        bool odd = values.size() % 2 == 1;
+        double left_over = odd ? values.back() : 0;
+        if (odd) {
+            values.pop_back();
+        }
+        for (idx_t i = compactions % 2; i < values.size(); i += 2) {
+            promoted.push_back(values[i]);
+        }
+        compactions++;
+        values.clear();
+        if (odd) {
+            values.push_back(left_over);
+        }
+    }
+}
+
+void QuantileSketch::Add(double value) {
+    if (count == 0) {
+        min = max = value;
+    } else {
+        min = MinValue(min, value);
+        max = MaxValue(max, value);
+    }
+    count++;
+    if (levels.empty()) {
+        levels.emplace_back();
+    }
+    levels[0].push_back(value);
+    if (levels[0].size() >= Capacity(0)) {
+        Compress();
+    }
+}
+
+void QuantileSketch::Merge(const QuantileSketch &other) {
+    if (other.count == 0) {
+        return;
+    }
+    if (count == 0) {
+        min = other.min;
+        max = other.max;
+    } else {
+        min = MinValue(min, other.min);
+        max = MaxValue(max, other.max);
+    }
+    count += other.count;
+    if (levels.size() < other.levels.size()) {
+        levels.resize(other.levels.size());
+    }
+    for (idx_t level = 0; level < other.levels.size(); level++) {
+        levels[level].insert(levels[level].end(), other.levels[level].begin(), other.levels[level].end());
+    }
+    Compress();
+}
+
+double QuantileSketch::Quantile(double q) const {
+    if (q <= 0) {
+        return min;
+    }
+    if (q >= 1) {
+        return max;
+    }
+    std::vector<std::pair<double, uint64_t>> weighted;
+    uint64_t total = 0;
+    for (idx_t level = 0; level < levels.size(); level++) {
+        for (auto value : levels[level]) {
+            weighted.emplace_back(value, uint64_t(1) << level);
+            total += uint64_t(1) << level;
+        }
+    }
+    std::sort(weighted.begin(), weighted.end());
+    auto target = q * (double)total;
+    uint64_t cumulative = 0;
+    for (auto &entry : weighted) {
+        cumulative += entry.second;
+        if ((double)cumulative >= target) {
+            return entry.first;
+        }
+    }
+    return max;
+}
+
+// ---------------------------------------------------
+// Frequent values
+// ---------------------------------------------------
+
+void HeavyHitters::Add(const std::string &value, uint64_t count) {
+    counters[value] += count;
+    Prune();
+}
+
+void HeavyHitters::Merge(const HeavyHitters &other) {
+    for (auto &entry : other.counters) {
+        counters[entry.first] += entry.second;
+    }
+    Prune();
+}
+
+// Subtracts the count of the (HEAVY_HITTER_COUNTERS + 1)-th most frequent value from every counter
+// and drops the counters that reach zero
+void HeavyHitters::Prune() {
+    if (counters.size() <= HEAVY_HITTER_COUNTERS) {
+        return;
+    }
+    std::vector<uint64_t> counts;
+    counts.reserve(counters.size());
+    for (auto &entry : counters) {
+        counts.push_back(entry.second);
+    }
+    std::nth_element(counts.begin(), counts.begin() + HEAVY_HITTER_COUNTERS, counts.end(), std::greater<uint64_t>());
+    auto cut = counts[HEAVY_HITTER_COUNTERS];
+    for (auto it = counters.begin(); it != counters.end();) {
+        if (it->second <= cut) {
+            it = counters.erase(it);
+        } else {
+            it->second -= cut;
+            ++it;
+        }
+    }
+}
+
+std::vector<std::pair<std::string, uint64_t>> HeavyHitters::Top() const {
+    std::vector<std::pair<std::string, uint64_t>> top(counters.begin(), counters.end());
+    std::sort(top.begin(), top.end(),
+              [](const std::pair<std::string, uint64_t> &a, const std::pair<std::string, uint64_t> &b) {
+                  return a.second != b.second ? a.second > b.second : a.first < b.first;
+              });
+    return top;
+}
+
+// ---------------------------------------------------
+// Predicate sketch
+// ---------------------------------------------------
+
+void PredicateSketch::Add(const DetailedWhereConditionResult &condition) {
+    auto &column = columns[PredicateSketchKey(condition.table_name, condition.column_name, condition.operator_type)];
+    column.predicates++;
+    if (!condition.is_constant) {
+        return;
+    }
+    column.literals++;
+    column.distinct.Add(HashLiteral(condition.value));
+    column.frequent.Add(condition.value);
+
+    Value number(condition.value);
+    if (number.DefaultTryCastAs(LogicalType::DOUBLE, true)) {
+        auto value = DoubleValue::Get(number);
+        if (std::isfinite(value)) {
+            column.numeric.Add(value);
+        }
+        return;
+    }
+    Value time(condition.value);
+    if (time.DefaultTryCastAs(LogicalType::TIMESTAMP, true)) {
+        auto timestamp = TimestampValue::Get(time);
+        if (Timestamp::IsFinite(timestamp)) {
+            column.temporal.Add((double)Timestamp::GetEpochMicroSeconds(timestamp));
+        }
+    }
+}
+
+void PredicateSketch::Merge(const PredicateSketch &other) {
+    for (auto &entry : other.columns) {
+        auto &column = columns[entry.first];
+        auto &source = entry.second;
+        column.predicates += source.predicates;
+        column.literals += source.literals;
+        column.distinct.Merge(source.distinct);
+        column.numeric.Merge(source.numeric);
+        column.temporal.Merge(source.temporal);
+        column.frequent.Merge(source.frequent);
+    }
+}
+
+// Serialization
+// ---------------------------------------------------
+// A version byte, then every column: its key, counts, the non-zero HLL registers, both quantile
+// sketches level by level and the frequent value counters. Integers are varints, doubles 8 bytes.
+
+static void WriteVarint(uint64_t value, std::string &target) {
+    while (value >= 0x80) {
+        target.push_back((char)((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    target.push_back((char)value);
+}
+
+static void WriteString(const std::string &value, std::string &target) {
+    WriteVarint(value.size(), target);
+    target.append(value);
+}
+
+static void WriteDouble(double value, std::string &target) {
+    char bytes[sizeof(double)];
+    std::memcpy(bytes, &value, sizeof(double));
+    target.append(bytes, sizeof(double));
+}
+
+static void WriteQuantiles(const QuantileSketch &sketch, std::string &target) {
+    WriteVarint(sketch.count, target);
+    if (sketch.count == 0) {
+        return;
+    }
+    WriteDouble(sketch.min, target);
+    WriteDouble(sketch.max, target);
+    WriteVarint(sketch.compactions, target);
+    WriteVarint(sketch.levels.size(), target);
+    for (auto &level : sketch.levels) {
+        WriteVarint(level.size(), target);
+        for (auto value : level) {
+            WriteDouble(value, target);
+        }
+    }
+}
+
+void PredicateSketch::Serialize(std::string &target) const {
+    target.push_back((char)PREDICATE_SKETCH_VERSION);
+    WriteVarint(columns.size(), target);
+    for (auto &entry : columns) {
+        WriteString(std::get<0>(entry.first), target);
+        WriteString(std::get<1>(entry.first), target);
+        WriteString(std::get<2>(entry.first), target);
+        auto &column = entry.second;
+        WriteVarint(column.predicates, target);
+        WriteVarint(column.literals, target);
+
+        idx_t used = 0;
+        for (auto rank : column.distinct.registers) {
+            used += rank != 0;
+        }
+        WriteVarint(used, target);
+        for (idx_t i = 0; i < column.distinct.registers.size(); i++) {
+            if (column.distinct.registers[i] != 0) {
+                WriteVarint(i, target);
+                target.push_back((char)column.distinct.registers[i]);
+            }
+        }
+
+        WriteQuantiles(column.numeric, target);
+        WriteQuantiles(column.temporal, target);
+
+        WriteVarint(column.frequent.counters.size(), target);
+        for (auto &counter : column.frequent.counters) {
+            WriteString(counter.first, target);
+            WriteVarint(counter.second, target);
+        }
+    }
+}
+
+class SketchReader {
+public:
+    SketchReader(const char *data, idx_t size) : data((const uint8_t *)data), end((const uint8_t *)data + size) {
+    }
+
+    uint8_t Byte() {
+        Require(1);
+        return *data++;
+    }
+
+    uint64_t Varint() {
+        uint64_t value = 0;
+        for (idx_t shift = 0; shift < 64; shift += 7) {
+            auto byte = Byte();
+            value |= (uint64_t)(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw InvalidInputException("predicate_sketch: malformed sketch");
+    }
+
+    // A count of items that each take at least min_bytes, checked against the bytes left
+    idx_t Count(idx_t min_bytes) {
+        auto count = Varint();
+        if (count > (uint64_t)(end - data) / min_bytes) {
+            throw InvalidInputException("predicate_sketch: malformed sketch");
+        }
+        return (idx_t)count;
+    }
+
+    std::string String() {
+        auto size = Count(1);
+        std::string value((const char *)data, size);
+        data += size;
+        return value;
+    }
+
+    double Double() {
+        Require(sizeof(double));
+        double value;
+        std::memcpy(&value, data, sizeof(double));
+        data += sizeof(double);
+        return value;
+    }
+
+    bool AtEnd() const {
+        return data == end;
+    }
+
+private:
+    void Require(idx_t bytes) {
+        if ((idx_t)(end - data) < bytes) {
+            throw InvalidInputException("predicate_sketch: truncated sketch");
+        }
+    }
+
+    const uint8_t *data;
+    const uint8_t *end;
+};
+
+static void ReadQuantiles(SketchReader &reader, QuantileSketch &sketch) {
+    sketch.count = reader.Varint();
+    if (sketch.count == 0) {
+        return;
+    }
+    sketch.min = reader.Double();
+    sketch.max = reader.Double();
+    sketch.compactions = reader.Varint();
+    sketch.levels.resize(reader.Count(1));
+    for (auto &level : sketch.levels) {
+        level.resize(reader.Count(sizeof(double)));
+        for (auto &value : level) {
+            value = reader.Double();
+        }
+    }
+}
+
+void PredicateSketch::Deserialize(const char *data, idx_t size, PredicateSketch &result) {
+    SketchReader reader(data, size);
+    if (reader.Byte() != PREDICATE_SKETCH_VERSION) {
+        throw InvalidInputException("predicate_sketch: unsupported sketch version");
+    }
+    auto column_count = reader.Count(3);
+    for (idx_t c = 0; c < column_count; c++) {
+        auto table = reader.String();
+        auto column_name = reader.String();
+        auto operator_type = reader.String();
+        auto &column = result.columns[PredicateSketchKey(table, column_name, operator_type)];
+        column.predicates = reader.Varint();
+        column.literals = reader.Varint();
+
+        auto used = reader.Count(2);
+        if (used > 0) {
+            column.distinct.registers.resize(HLL_REGISTER_COUNT);
+        }
+        for (idx_t i = 0; i < used; i++) {
+            auto index = reader.Varint();
+            if (index >= HLL_REGISTER_COUNT) {
+                throw InvalidInputException("predicate_sketch: malformed sketch");
+            }
+            column.distinct.registers[index] = reader.Byte();
+        }
+
+        ReadQuantiles(reader, column.numeric);
+        ReadQuantiles(reader, column.temporal);
+
+        auto counters = reader.Count(2);
+        for (idx_t i = 0; i < counters; i++) {
+            auto value = reader.String();
+            column.frequent.counters[value] = reader.Varint();
+        }
+    }
+    if (!reader.AtEnd()) {
+        throw InvalidInputException("predicate_sketch: malformed sketch");
+    }
+}
+
+// ---------------------------------------------------
+// predicate_sketch / predicate_sketch_merge
+// ---------------------------------------------------
+
+struct PredicateSketchBindData : public FunctionData {
+    explicit PredicateSketchBindData(ParserToolsLimits limits) : limits(limits) {
+    }
+
+    unique_ptr<FunctionData> Copy() const override {
+        return make_uniq<PredicateSketchBindData>(limits);
+    }
+
+    bool Equals(const FunctionData &other_p) const override {
+        auto &other = other_p.Cast<PredicateSketchBindData>();
+        return limits.max_sql_bytes == other.limits.max_sql_bytes &&
+               limits.max_ast_nodes == other.limits.max_ast_nodes &&
+               limits.max_parse_ms == other.limits.max_parse_ms && limits.on_limit == other.limits.on_limit;
+    }
+
+    ParserToolsLimits limits;
+};
+
+static unique_ptr<FunctionData> PredicateSketchBind(ClientContext &context, AggregateFunction &function,
+                                                    vector<unique_ptr<Expression>> &arguments) {
+    return make_uniq<PredicateSketchBindData>(ParserToolsLimits::Get(context));
+}
+
+struct PredicateSketchState {
+    PredicateSketch *sketch;
+};
+
+struct PredicateSketchOperationBase {
+    template <class STATE>
+    static void Initialize(STATE &state) {
+        state.sketch = nullptr;
+    }
+
+    template <class INPUT_TYPE, class STATE, class OP>
+    static void ConstantOperation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &unary_input,
+                                  idx_t count) {
+        for (idx_t i = 0; i < count; i++) {
+            OP::template Operation<INPUT_TYPE, STATE, OP>(state, input, unary_input);
+        }
+    }
+
+    template <class STATE, class OP>
+    static void Combine(const STATE &source, STATE &target, AggregateInputData &aggr_input_data) {
+        if (!source.sketch) {
+            return;
+        }
+        if (!target.sketch) {
+            target.sketch = new PredicateSketch(*source.sketch);
+            return;
+        }
+        target.sketch->Merge(*source.sketch);
+    }
+
+    template <class T, class STATE>
+    static void Finalize(STATE &state, T &target, AggregateFinalizeData &finalize_data) {
+        if (!state.sketch) {
+            finalize_data.ReturnNull();
+            return;
+        }
+        std::string serialized;
+        state.sketch->Serialize(serialized);
+        target = StringVector::AddStringOrBlob(finalize_data.result, serialized);
+    }
+
+    template <class STATE>
+    static void Destroy(STATE &state, AggregateInputData &aggr_input_data) {
+        if (state.sketch) {
+            delete state.sketch;
+            state.sketch = nullptr;
+        }
+    }
+
+    static bool IgnoreNull() {
+        return true;
+    }
+};
+
+// Adds the predicates of a query
+struct PredicateSketchOperation : public PredicateSketchOperationBase {
+    template <class INPUT_TYPE, class STATE, class OP>
+    static void Operation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &unary_input) {
+        auto &bind_data = unary_input.input.bind_data->template Cast<PredicateSketchBindData>();
+        if (!state.sketch) {
+            state.sketch = new PredicateSketch();
+        }
+        std::vector<DetailedWhereConditionResult> conditions;
+        ExtractionBudget budget(bind_data.limits);
+        ExtractDetailedWhereConditionsFromSQL(input.GetString(), conditions);
+        if (!budget.KeepResult("predicate_sketch")) {
+            return;
+        }
+        for (auto &condition : conditions) {
+            state.sketch->Add(condition);
+        }
+    }
+};
+
+// Merges a sketch built earlier, e.g. the one of another day
+struct PredicateSketchMergeOperation : public PredicateSketchOperationBase {
+    template <class INPUT_TYPE, class STATE, class OP>
+    static void Operation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &unary_input) {
+        PredicateSketch sketch;
+        PredicateSketch::Deserialize(input.GetData(), input.GetSize(), sketch);
+        if (!state.sketch) {
+            state.sketch = new PredicateSketch(std::move(sketch));
+            return;
+        }
+        state.sketch->Merge(sketch);
+    }
+};
+
+// ---------------------------------------------------
+// predicate_sketch_summary
+// ---------------------------------------------------
+
+static Value StringOrNull(const std::string &str) {
+    return str.empty() ? Value(LogicalType::VARCHAR) : Value(str);
+}
+
+static LogicalType HeavyHitterType() {
+    return LogicalType::STRUCT({
+        {"value", LogicalType::VARCHAR},
+        {"count", LogicalType::UBIGINT}
+    });
+}
+
+static Value QuantilesToValue(const QuantileSketch &sketch, bool temporal) {
+    auto type = temporal ? LogicalType::TIMESTAMP : LogicalType::DOUBLE;
+    if (sketch.count == 0) {
+        return Value(LogicalType::LIST(type));
+    }
+    vector<Value> quantiles;
+    for (auto q : SUMMARY_QUANTILES) {
+        auto value = sketch.Quantile(q);
+        quantiles.push_back(temporal ? Value::TIMESTAMP(Timestamp::FromEpochMicroSeconds((int64_t)value))
+                                     : Value::DOUBLE(value));
+    }
+    return Value::LIST(type, std::move(quantiles));
+}
+
+static Value ColumnToValue(const PredicateSketchKey &key, const PredicateColumnSketch &column,
+                           const LogicalType &hitter_type) {
+    vector<Value> hitters;
+    for (auto &hitter : column.frequent.Top()) {
+        child_list_t<Value> fields;
+        fields.emplace_back("value", Value(hitter.first));
+        fields.emplace_back("count", Value::UBIGINT(hitter.second));
+        hitters.push_back(Value::STRUCT(std::move(fields)));
+    }
+
+    child_list_t<Value> fields;
+    fields.emplace_back("table_name", StringOrNull(std::get<0>(key)));
+    fields.emplace_back("column_name", StringOrNull(std::get<1>(key)));
+    fields.emplace_back("operator_type", Value(std::get<2>(key)));
+    fields.emplace_back("predicates", Value::UBIGINT(column.predicates));
+    fields.emplace_back("literals", Value::UBIGINT(column.literals));
+    fields.emplace_back("distinct_values", Value::UBIGINT((uint64_t)std::llround(column.distinct.Estimate())));
+    fields.emplace_back("numeric_quantiles", QuantilesToValue(column.numeric, false));
+    fields.emplace_back("temporal_quantiles", QuantilesToValue(column.temporal, true));
+    fields.emplace_back("heavy_hitters", Value::LIST(hitter_type, std::move(hitters)));
+    return Value::STRUCT(std::move(fields));
+}
+
+static void PredicateSketchSummaryScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    auto &input = args.data[0];
+    auto count = args.size();
+    auto &entry_type = ListType::GetChildType(result.GetType());
+    auto hitter_type = HeavyHitterType();
+
+    UnifiedVectorFormat input_data;
+    input.ToUnifiedFormat(count, input_data);
+    auto blobs = UnifiedVectorFormat::GetData<string_t>(input_data);
+
+    for (idx_t row = 0; row < count; row++) {
+        auto idx = input_data.sel->get_index(row);
+        if (!input_data.validity.RowIsValid(idx)) {
+            result.SetValue(row, Value(result.GetType()));
+            continue;
+        }
+
+        PredicateSketch sketch;
+        PredicateSketch::Deserialize(blobs[idx].GetData(), blobs[idx].GetSize(), sketch);
+
+        vector<Value> entries;
+        for (auto &column : sketch.columns) {
+            entries.push_back(ColumnToValue(column.first, column.second, hitter_type));
+        }
+        result.SetValue(row, Value::LIST(entry_type, std::move(entries)));
+    }
+
+    if (args.AllConstant()) {
+        result.SetVectorType(VectorType::CONSTANT_VECTOR);
+    }
+}
+
+// Extension scaffolding
+// ---------------------------------------------------
+
+void RegisterPredicateSketchFunctions(DatabaseInstance &db) {
+    // predicate_sketch summarizes the literals compared against each column of a workload in a BLOB
+    auto sketch = AggregateFunction::UnaryAggregateDestructor<PredicateSketchState, string_t, string_t,
+                                                              PredicateSketchOperation>(LogicalType::VARCHAR,
+                                                                                        LogicalType::BLOB);
+    sketch.name = "predicate_sketch";
+    sketch.bind = PredicateSketchBind;
+    ExtensionUtil::RegisterFunction(db, sketch);
+
+    // predicate_sketch_merge combines sketches, e.g. daily ones into a monthly one
+    auto merge = AggregateFunction::UnaryAggregateDestructor<PredicateSketchState, string_t, string_t,
+                                                             PredicateSketchMergeOperation>(LogicalType::BLOB,
+                                                                                            LogicalType::BLOB);
+    merge.name = "predicate_sketch_merge";
+    ExtensionUtil::RegisterFunction(db, merge);
+
+    auto summary_type = LogicalType::LIST(LogicalType::STRUCT({
+        {"table_name", LogicalType::VARCHAR},
+        {"column_name", LogicalType::VARCHAR},
+        {"operator_type", LogicalType::VARCHAR},
+        {"predicates", LogicalType::UBIGINT},
+        {"literals", LogicalType::UBIGINT},
+        {"distinct_values", LogicalType::UBIGINT},
+        {"numeric_quantiles", LogicalType::LIST(LogicalType::DOUBLE)},
+        {"temporal_quantiles", LogicalType::LIST(LogicalType::TIMESTAMP)},
+        {"heavy_hitters", LogicalType::LIST(HeavyHitterType())}
+    }));
+    ScalarFunction summary("predicate_sketch_summary", {LogicalType::BLOB}, summary_type,
+                           PredicateSketchSummaryScalarFunction);
+    ExtensionUtil::RegisterFunction(db, summary);
+}
+
+} // namespace duckdb
@@ -0,0 +1,412 @@
+#include "query_capture.hpp"
+#include "parse_tables.hpp"
+#include "parse_functions.hpp"
+#include "sql_scanner.hpp"
+#include "duckdb.hpp"
+#include "duckdb/common/enums/statement_type.hpp"
+#include "duckdb/common/types/timestamp.hpp"
+#include "duckdb/function/pragma_function.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/client_context_state.hpp"
+#include "duckdb/main/config.hpp"
+#include "duckdb/main/connection_manager.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include "duckdb/main/prepared_statement_data.hpp"
+#include "duckdb/parser/keyword_helper.hpp"
+#include "duckdb/parser/qualified_name.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+#include "duckdb/planner/extension_callback.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <thread>
+
+namespace duckdb {
+
+// Number of queries kept per database, older entries are overwritten
+static constexpr idx_t QUERY_CAPTURE_CAPACITY = 4096;
+
+static const char *QUERY_CAPTURE_STATE_KEY = "parser_tools_query_capture";
+
+// ---------------------------------------------------
+// Ring buffer
+// ---------------------------------------------------
+
+// Layout of a slot: captured_at, connection_id, fingerprint, then one word with the statement type
+// and the name counts, then the table and function names, each terminated by a zero byte
+static constexpr idx_t SLOT_HEADER_WORDS = 4;
+static constexpr idx_t SLOT_NAME_BYTES = (QUERY_CAPTURE_SLOT_WORDS - SLOT_HEADER_WORDS) * sizeof(uint64_t);
+
+static void AppendNames(const std::vector<std::string> &names, char *bytes, idx_t &length, uint64_t &count) {
+    for (auto &name : names) {
+        if (length + name.size() + 1 > SLOT_NAME_BYTES) {
+            return;
+        }
+        memcpy(bytes + length, name.c_str(), name.size() + 1);
+        length += name.size() + 1;
+        count++;
+    }
+}
+
+static void ReadNames(const char *bytes, idx_t length, idx_t &offset, uint64_t count,
+                      std::vector<std::string> &names) {
+    for (uint64_t i = 0; i < count && offset < length; i++) {
+        names.emplace_back(bytes + offset);
+        offset += names.back().size() + 1;
+    }
+}
+
+QueryCaptureBuffer::QueryCaptureBuffer(idx_t capacity)
+    : capacity(capacity), slots(new Slot[capacity]()), next_sequence(0), drained_until(0) {
+}
+
+void QueryCaptureBuffer::Record(const CapturedQuery &entry) {
+    uint64_t words[QUERY_CAPTURE_SLOT_WORDS] = {};
+    words[0] = (uint64_t)Timestamp::GetEpochMicroSeconds(entry.captured_at);
+    words[1] = entry.connection_id;
+    words[2] = entry.fingerprint;
+    auto names = (char *)(words + SLOT_HEADER_WORDS);
+    idx_t names_length = 0;
+    uint64_t table_count = 0;
+    uint64_t function_count = 0;
+    AppendNames(entry.tables, names, names_length, table_count);
+    AppendNames(entry.functions, names, names_length, function_count);
+    words[3] = (uint64_t)entry.statement_type | table_count << 8 | function_count << 24;
+
+    auto sequence = next_sequence.fetch_add(1, std::memory_order_relaxed);
+    auto &slot = slots[sequence % capacity];
+    auto writing = 2 * sequence + 1;
+    auto version = slot.version.load(std::memory_order_relaxed);
+    while (true) {
+        if (version >= writing) {
+            // a writer that claimed a later lap already owns the slot, this entry is overwritten
+            return;
+        }
+        if (version % 2 == 1) {
+            // the ring wrapped around while an older writer is still storing into this slot
+            std::this_thread::yield();
+            version = slot.version.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (slot.version.compare_exchange_weak(version, writing, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    for (idx_t i = 0; i < QUERY_CAPTURE_SLOT_WORDS; i++) {
+        slot.words[i].store(words[i], std::memory_order_relaxed);
+    }
+    slot.version.store(writing + 1, std::memory_order_release);
+}
+
+void QueryCaptureBuffer::Snapshot(std::vector<CapturedQuery> &entries, bool drain) {
+    auto from = drained_until.load();
+    auto end = next_sequence.load();
+    // older sequences have been overwritten
+    auto sequence = end > capacity ? MaxValue<uint64_t>(from, end - capacity) : from;
+    uint64_t words[QUERY_CAPTURE_SLOT_WORDS];
+    for (; sequence < end; sequence++) {
+        auto &slot = slots[sequence % capacity];
+        auto published = 2 * sequence + 2;
+        auto version = slot.version.load(std::memory_order_acquire);
+        if (version < published) {
+            // claimed but not published yet: stop here so that the watermark never passes it
+            break;
+        }
+        if (version > published) {
+            // a later lap took the slot before this sequence was read
+            continue;
+        }
+        for (idx_t i = 0; i < QUERY_CAPTURE_SLOT_WORDS; i++) {
+            words[i] = slot.words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.version.load(std::memory_order_relaxed) != version) {
+            // overwritten while it was copied
+            continue;
+        }
+
+        CapturedQuery entry;
+        entry.sequence = sequence;
+        entry.captured_at = Timestamp::FromEpochMicroSeconds((int64_t)words[0]);
+        entry.connection_id = words[1];
+        entry.fingerprint = words[2];
+        entry.statement_type = (StatementType)(words[3] & 0xff);
+        auto names = (const char *)(words + SLOT_HEADER_WORDS);
+        idx_t offset = 0;
+        ReadNames(names, SLOT_NAME_BYTES, offset, (words[3] >> 8) & 0xffff, entry.tables);
+        ReadNames(names, SLOT_NAME_BYTES, offset, (words[3] >> 24) & 0xffff, entry.functions);
+        entries.push_back(std::move(entry));
+    }
+    if (drain) {
+        // only ever move the watermark forward, a concurrent drain may have passed us already
+        auto until = sequence;
+        while (from < until && !drained_until.compare_exchange_weak(from, until)) {
+        }
+    }
+}
+
+// ---------------------------------------------------
+// Fingerprint
+// ---------------------------------------------------
+
+static constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+
+static void HashByte(uint64_t &hash, uint8_t byte) {
+    hash ^= byte;
+    hash *= 1099511628211ULL; // FNV-1a prime
+}
+
+uint64_t FingerprintSQL(const std::string &sql, idx_t start, idx_t length) {
+    idx_t end = length == 0 ? sql.size() : std::min<idx_t>(sql.size(), start + length);
+    uint64_t hash = FNV_OFFSET_BASIS;
+    SqlScanner scanner(sql);
+    scanner.Reset(start);
+    SqlToken token;
+    while (scanner.Next(token) && token.start < end) {
+        switch (token.type) {
+            case SqlTokenType::String:
+            case SqlTokenType::Number:
+            case SqlTokenType::Parameter:
+                HashByte(hash, '?');
+                break;
+            case SqlTokenType::Semicolon:
+                continue;
+            case SqlTokenType::Identifier:
+                for (idx_t i = token.start; i < token.start + token.length; i++) {
+                    HashByte(hash, (uint8_t)std::tolower((unsigned char)sql[i]));
+                }
+                break;
+            default:
+                for (idx_t i = token.start; i < token.start + token.length; i++) {
+                    HashByte(hash, (uint8_t)sql[i]);
+                }
+                break;
+        }
+        // token boundary, so that "a b" and "ab" differ
+        HashByte(hash, 0x1f);
+    }
+    return hash;
+}
+
+// ---------------------------------------------------
+// Capture hook
+// ---------------------------------------------------
+
+static void AddUnique(std::vector<std::string> &values, std::string value) {
+    if (std::find(values.begin(), values.end(), value) == values.end()) {
+        values.push_back(std::move(value));
+    }
+}
+
+// Summarizes the statement the binder was given, the query text is not parsed a second time
+static void RecordStatement(ClientContext &context, QueryCaptureBuffer &buffer, const PreparedStatementData &prepared) {
+    if (!prepared.unbound_statement) {
+        return;
+    }
+    auto &statement = *prepared.unbound_statement;
+
+    CapturedQuery entry;
+    entry.sequence = 0;
+    entry.captured_at = Timestamp::GetCurrentTimestamp();
+    entry.connection_id = context.GetConnectionId();
+    entry.statement_type = statement.type;
+    entry.fingerprint = FingerprintSQL(statement.query, statement.stmt_location, statement.stmt_length);
+
+    if (statement.type == StatementType::SELECT_STATEMENT) {
+        auto &select = (SelectStatement &)statement;
+        if (select.node) {
+            std::vector<TableRefResult> tables;
+            ExtractTablesFromQueryNode(*select.node, tables);
+            for (auto &table : tables) {
+                if (table.context == TableContext::CTE || table.context == TableContext::FromCTE) {
+                    continue;
+                }
+                AddUnique(entry.tables, table.schema + "." + table.table);
+            }
+            std::vector<FunctionResult> functions;
+            ExtractFunctionsFromQueryNode(*select.node, functions);
+            for (auto &function : functions) {
+                AddUnique(entry.functions, function.function_name);
+            }
+        }
+    }
+    buffer.Record(entry);
+}
+
+class QueryCaptureState : public ClientContextState {
+public:
+    explicit QueryCaptureState(std::shared_ptr<QueryCaptureBuffer> buffer) : buffer(std::move(buffer)) {
+    }
+
+    void QueryBegin(ClientContext &context) override {
+        Value setting;
+        just_recorded = nullptr;
+        enabled = context.TryGetCurrentSetting("parser_tools_capture_queries", setting) && !setting.IsNull() &&
+                  BooleanValue::Get(setting);
+    }
+
+    // OnFinalizePrepare is only called when some state may request a rebind, which is how the
+    // hook stays free while capture is disabled
+    bool CanRequestRebind() override {
+        return enabled;
+    }
+
+    RebindQueryInfo OnFinalizePrepare(ClientContext &context, PreparedStatementData &prepared_statement,
+                                      PreparedStatementMode mode) override {
+        // statements prepared explicitly are recorded each time they are executed instead
+        if (enabled && mode == PreparedStatementMode::PREPARE_AND_EXECUTE) {
+            RecordStatement(context, *buffer, prepared_statement);
+            just_recorded = &prepared_statement;
+        }
+        return RebindQueryInfo::DO_NOT_REBIND;
+    }
+
+    RebindQueryInfo OnExecutePrepared(ClientContext &context, PreparedStatementCallbackInfo &info,
+                                      RebindQueryInfo current_rebind) override {
+        if (enabled && just_recorded != &info.prepared_statement) {
+            RecordStatement(context, *buffer, info.prepared_statement);
+        }
+        just_recorded = nullptr;
+        return current_rebind;
+    }
+
+    std::shared_ptr<QueryCaptureBuffer> buffer;
+
+private:
+    bool enabled = false;
+    // the statement recorded while it was prepared for immediate execution, so it is not recorded twice
+    const PreparedStatementData *just_recorded = nullptr;
+};
+
+class QueryCaptureExtensionCallback : public ExtensionCallback {
+public:
+    explicit QueryCaptureExtensionCallback(std::shared_ptr<QueryCaptureBuffer> buffer) : buffer(std::move(buffer)) {
+    }
+
+    void OnConnectionOpened(ClientContext &context) override {
+        context.registered_state->GetOrCreate<QueryCaptureState>(QUERY_CAPTURE_STATE_KEY, buffer);
+    }
+
+private:
+    std::shared_ptr<QueryCaptureBuffer> buffer;
+};
+
+// ---------------------------------------------------
+// parser_tools_recent_queries
+// ---------------------------------------------------
+
+struct RecentQueriesBindData : public TableFunctionData {
+    bool drain = false;
+};
+
+struct RecentQueriesState : public GlobalTableFunctionState {
+    std::vector<CapturedQuery> entries;
+    idx_t row = 0;
+};
+
+static unique_ptr<FunctionData> RecentQueriesBind(ClientContext &context, TableFunctionBindInput &input,
+                                                  vector<LogicalType> &return_types, vector<string> &names) {
+    auto result = make_uniq<RecentQueriesBindData>();
+    auto drain = input.named_parameters.find("drain");
+    if (drain != input.named_parameters.end() && !drain->second.IsNull()) {
+        result->drain = BooleanValue::Get(drain->second);
+    }
+
+    return_types = {LogicalType::UBIGINT, LogicalType::TIMESTAMP, LogicalType::UBIGINT, LogicalType::VARCHAR,
+                    LogicalType::UBIGINT, LogicalType::LIST(LogicalType::VARCHAR),
+                    LogicalType::LIST(LogicalType::VARCHAR)};
+    names = {"sequence", "captured_at", "connection_id", "statement_type", "fingerprint", "tables", "functions"};
+    return std::move(result);
+}
+
+// The snapshot (and the drain) happens once per execution, not at bind time
+static unique_ptr<GlobalTableFunctionState> RecentQueriesInit(ClientContext &context, TableFunctionInitInput &input) {
+    auto &bind_data = (const RecentQueriesBindData &)*input.bind_data;
+    auto result = make_uniq<RecentQueriesState>();
+    auto state = context.registered_state->Get<QueryCaptureState>(QUERY_CAPTURE_STATE_KEY);
+    if (state) {
+        state->buffer->Snapshot(result->entries, bind_data.drain);
+    }
+    return std::move(result);
+}
+
+static Value StringList(const std::vector<std::string> &strings) {
+    vector<Value> values;
+    for (auto &s : strings) {
+        values.push_back(Value(s));
+    }
+    return Value::LIST(LogicalType::VARCHAR, values);
+}
+
+static void RecentQueriesFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+    auto &state = (RecentQueriesState &)*data.global_state;
+
+    idx_t count = 0;
+    while (state.row < state.entries.size() && count < STANDARD_VECTOR_SIZE) {
+        auto &entry = state.entries[state.row];
+        output.SetValue(0, count, Value::UBIGINT(entry.sequence));
+        output.SetValue(1, count, Value::TIMESTAMP(entry.captured_at));
+        output.SetValue(2, count, Value::UBIGINT(entry.connection_id));
+        output.SetValue(3, count, Value(StatementTypeToString(entry.statement_type)));
+        output.SetValue(4, count, Value::UBIGINT(entry.fingerprint));
+        output.SetValue(5, count, StringList(entry.tables));
+        output.SetValue(6, count, StringList(entry.functions));
+
+        state.row++;
+        count++;
+    }
+    output.SetCardinality(count);
+}
+
+// PRAGMA parser_tools_flush_queries('table'): moves the captured queries into a table
+static string FlushQueriesPragma(ClientContext &context, const FunctionParameters &parameters) {
+    auto name = QualifiedName::Parse(StringValue::Get(parameters.values[0]));
+    string table;
+    if (!name.catalog.empty()) {
+        table += KeywordHelper::WriteOptionallyQuoted(name.catalog) + ".";
+    }
+    if (!name.schema.empty()) {
+        table += KeywordHelper::WriteOptionallyQuoted(name.schema) + ".";
+    }
+    table += KeywordHelper::WriteOptionallyQuoted(name.name);
+    return "CREATE TABLE IF NOT EXISTS " + table + " AS FROM parser_tools_recent_queries() LIMIT 0; " +
+           "INSERT INTO " + table + " FROM parser_tools_recent_queries(drain := true);";
+}
+
+static void SqlFingerprintScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    UnaryExecutor::Execute<string_t, uint64_t>(args.data[0], result, args.size(), [](string_t query) {
+        return FingerprintSQL(query.GetString());
+    });
+}
+
+// Extension scaffolding
+// ---------------------------------------------------
+
+void RegisterQueryCaptureFunctions(DatabaseInstance &db) {
+    auto &config = DBConfig::GetConfig(db);
+    config.AddExtensionOption("parser_tools_capture_queries",
+                              "Record the tables, functions and fingerprint of every query executed on this database",
+                              LogicalType::BOOLEAN, Value::BOOLEAN(false));
+
+    auto buffer = std::make_shared<QueryCaptureBuffer>(QUERY_CAPTURE_CAPACITY);
+    config.extension_callbacks.push_back(make_uniq<QueryCaptureExtensionCallback>(buffer));
+    // connections opened before the extension was loaded, including the one loading it
+    for (auto &connection : ConnectionManager::Get(db).GetConnectionList()) {
+        connection->registered_state->GetOrCreate<QueryCaptureState>(QUERY_CAPTURE_STATE_KEY, buffer);
+    }
+
+    TableFunction recent("parser_tools_recent_queries", {}, RecentQueriesFunction, RecentQueriesBind,
+                         RecentQueriesInit);
+    recent.named_parameters["drain"] = LogicalType::BOOLEAN;
+    ExtensionUtil::RegisterFunction(db, recent);
+
+    auto flush = PragmaFunction::PragmaCall("parser_tools_flush_queries", FlushQueriesPragma, {LogicalType::VARCHAR});
+    ExtensionUtil::RegisterFunction(db, flush);
+
+    ScalarFunction fingerprint("sql_fingerprint", {LogicalType::VARCHAR}, LogicalType::UBIGINT,
+                               SqlFingerprintScalarFunction);
+    ExtensionUtil::RegisterFunction(db, fingerprint);
+}
+
+} // namespace duckdb
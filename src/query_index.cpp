@@ -0,0 +1,332 @@
+#include "query_index.hpp"
+#include "parse_tables.hpp"
+#include "parse_functions.hpp"
+#include "duckdb.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/function/pragma_function.hpp"
+#include "duckdb/parser/parser.hpp"
+#include "duckdb/parser/keyword_helper.hpp"
+#include "duckdb/parser/qualified_name.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+#include "duckdb/parser/query_node/select_node.hpp"
+#include "duckdb/parser/expression/columnref_expression.hpp"
+#include "duckdb/parser/expression/subquery_expression.hpp"
+#include "duckdb/parser/parsed_expression_iterator.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include <algorithm>
+#include <set>
+#include <tuple>
+
+namespace duckdb {
+
+using IndexTermKey = std::tuple<std::string, std::string, std::string>;
+
+static void ExtractColumnsFromQueryNode(QueryNode &node, std::set<IndexTermKey> &terms);
+
+static void ExtractColumnsFromExpression(const ParsedExpression &expr, std::set<IndexTermKey> &terms) {
+    switch (expr.GetExpressionClass()) {
+        case ExpressionClass::COLUMN_REF: {
+            auto &column = (ColumnRefExpression &)expr;
+            terms.insert(IndexTermKey{
+                "column",
+                column.IsQualified() ? column.GetTableName() : "",
+                column.GetColumnName()
+            });
+            return;
+        }
+        case ExpressionClass::SUBQUERY: {
+            auto &subquery = (SubqueryExpression &)expr;
+            if (subquery.subquery && subquery.subquery->node) {
+                ExtractColumnsFromQueryNode(*subquery.subquery->node, terms);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    ParsedExpressionIterator::EnumerateChildren(expr, [&](const ParsedExpression &child) {
+        ExtractColumnsFromExpression(child, terms);
+    });
+}
+
+static void ExtractColumnsFromQueryNode(QueryNode &node, std::set<IndexTermKey> &terms) {
+    // visits the select list, FROM tree (including subqueries and join conditions), WHERE, GROUP BY,
+    // HAVING, QUALIFY, ORDER BY and CTEs
+    ParsedExpressionIterator::EnumerateQueryNodeChildren(node, [&](unique_ptr<ParsedExpression> &child) {
+        if (child) {
+            ExtractColumnsFromExpression(*child, terms);
+        }
+    });
+}
+
+void ExtractIndexTermsFromSQL(const std::string &sql, std::vector<IndexTermResult> &results) {
+    Parser parser;
+
+    try {
+        parser.ParseQuery(sql);
+    } catch (const ParserException &ex) {
+        // swallow parser exceptions, unparsable queries are simply not indexed
+        return;
+    }
+
+    // a query is posted at most once per term, no matter how often it references the object
+    std::set<IndexTermKey> terms;
+    for (auto &stmt : parser.statements) {
+        if (stmt->type != StatementType::SELECT_STATEMENT) {
+            continue;
+        }
+        auto &select_stmt = (SelectStatement &)*stmt;
+        if (!select_stmt.node) {
+            continue;
+        }
+
+        std::vector<TableRefResult> tables;
+        ExtractTablesFromQueryNode(*select_stmt.node, tables);
+        for (auto &table : tables) {
+            if (table.context == TableContext::CTE || table.context == TableContext::FromCTE) {
+                continue;
+            }
+            terms.insert(IndexTermKey{"table", table.schema, table.table});
+        }
+
+        std::vector<FunctionResult> functions;
+        ExtractFunctionsFromQueryNode(*select_stmt.node, functions);
+        for (auto &function : functions) {
+            terms.insert(IndexTermKey{"function", function.schema, function.function_name});
+        }
+
+        ExtractColumnsFromQueryNode(*select_stmt.node, terms);
+    }
+
+    for (auto &term : terms) {
+        results.push_back(IndexTermResult{std::get<0>(term), std::get<1>(term), std::get<2>(term)});
+    }
+}
+
+static void IndexTermsScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    UnaryExecutor::Execute<string_t, list_entry_t>(args.data[0], result, args.size(),
+    [&result](string_t query) -> list_entry_t {
+        auto query_string = query.GetString();
+        std::vector<IndexTermResult> terms;
+        ExtractIndexTermsFromSQL(query_string, terms);
+
+        auto current_size = ListVector::GetListSize(result);
+        auto number_of_terms = terms.size();
+        auto new_size = current_size + number_of_terms;
+
+        // Grow list vector if needed
+        if (ListVector::GetListCapacity(result) < new_size) {
+            ListVector::Reserve(result, new_size);
+        }
+
+        // Get the struct child vector of the list
+        auto &struct_vector = ListVector::GetEntry(result);
+
+        // Ensure list size is updated
+        ListVector::SetListSize(result, new_size);
+
+        // Get the fields in the STRUCT
+        auto &entries = StructVector::GetEntries(struct_vector);
+        auto &kind_entry = *entries[0];      // "kind" field
+        auto &qualifier_entry = *entries[1]; // "qualifier" field
+        auto &name_entry = *entries[2];      // "name" field
+
+        auto kind_data = FlatVector::GetData<string_t>(kind_entry);
+        auto qualifier_data = FlatVector::GetData<string_t>(qualifier_entry);
+        auto name_data = FlatVector::GetData<string_t>(name_entry);
+
+        for (size_t i = 0; i < number_of_terms; i++) {
+            const auto &term = terms[i];
+            auto idx = current_size + i;
+
+            kind_data[idx] = StringVector::AddStringOrBlob(kind_entry, term.kind);
+            qualifier_data[idx] = StringVector::AddStringOrBlob(qualifier_entry, term.qualifier);
+            name_data[idx] = StringVector::AddStringOrBlob(name_entry, term.name);
+        }
+
+        return list_entry_t(current_size, number_of_terms);
+    });
+}
+
+// Posting lists are stored as sorted, de-duplicated row ids: the first id zig-zag encoded, followed
+// by the gaps between consecutive ids, all as LEB128 varints. Dense posting lists cost ~1 byte per id.
+static void WriteVarint(uint64_t value, std::string &target) {
+    while (value >= 0x80) {
+        target.push_back((char)((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    target.push_back((char)value);
+}
+
+static uint64_t ReadVarint(const uint8_t *&data, const uint8_t *end) {
+    uint64_t value = 0;
+    for (idx_t shift = 0; shift < 64; shift += 7) {
+        if (data >= end) {
+            throw InvalidInputException("postings_decode: truncated posting list");
+        }
+        auto byte = *data++;
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+    throw InvalidInputException("postings_decode: malformed posting list");
+}
+
+static void PostingsEncodeScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    auto &ids_vector = args.data[0];
+    UnifiedVectorFormat ids_data;
+    ListVector::GetEntry(ids_vector).ToUnifiedFormat(ListVector::GetListSize(ids_vector), ids_data);
+    auto ids = UnifiedVectorFormat::GetData<int64_t>(ids_data);
+
+    UnaryExecutor::Execute<list_entry_t, string_t>(ids_vector, result, args.size(),
+    [&](list_entry_t list) -> string_t {
+        vector<int64_t> postings;
+        postings.reserve(list.length);
+        for (idx_t i = 0; i < list.length; i++) {
+            auto idx = ids_data.sel->get_index(list.offset + i);
+            if (ids_data.validity.RowIsValid(idx)) {
+                postings.push_back(ids[idx]);
+            }
+        }
+        std::sort(postings.begin(), postings.end());
+        postings.erase(std::unique(postings.begin(), postings.end()), postings.end());
+
+        std::string encoded;
+        for (idx_t i = 0; i < postings.size(); i++) {
+            if (i == 0) {
+                auto first = postings[0];
+                WriteVarint(((uint64_t)first << 1) ^ (uint64_t)(first >> 63), encoded);
+            } else {
+                WriteVarint((uint64_t)postings[i] - (uint64_t)postings[i - 1], encoded);
+            }
+        }
+        return StringVector::AddStringOrBlob(result, encoded.data(), encoded.size());
+    });
+}
+
+static void PostingsDecodeScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    UnaryExecutor::Execute<string_t, list_entry_t>(args.data[0], result, args.size(),
+    [&result](string_t blob) -> list_entry_t {
+        auto data = (const uint8_t *)blob.GetData();
+        auto end = data + blob.GetSize();
+
+        vector<int64_t> postings;
+        while (data < end) {
+            auto value = ReadVarint(data, end);
+            if (postings.empty()) {
+                postings.push_back((int64_t)((value >> 1) ^ (~(value & 1) + 1)));
+            } else {
+                postings.push_back((int64_t)((uint64_t)postings.back() + value));
+            }
+        }
+
+        auto current_size = ListVector::GetListSize(result);
+        auto number_of_postings = postings.size();
+        auto new_size = current_size + number_of_postings;
+
+        // grow list if needed
+        if (ListVector::GetListCapacity(result) < new_size) {
+            ListVector::Reserve(result, new_size);
+        }
+
+        auto ids = FlatVector::GetData<int64_t>(ListVector::GetEntry(result));
+        for (size_t i = 0; i < number_of_postings; i++) {
+            ids[current_size + i] = postings[i];
+        }
+
+        // Update size
+        ListVector::SetListSize(result, new_size);
+
+        return list_entry_t(current_size, number_of_postings);
+    });
+}
+
+static string QuoteQualifiedName(const string &name) {
+    auto qualified_name = QualifiedName::Parse(name);
+    string result;
+    if (!qualified_name.catalog.empty()) {
+        result += KeywordHelper::WriteOptionallyQuoted(qualified_name.catalog) + ".";
+    }
+    if (!qualified_name.schema.empty()) {
+        result += KeywordHelper::WriteOptionallyQuoted(qualified_name.schema) + ".";
+    }
+    return result + KeywordHelper::WriteOptionallyQuoted(qualified_name.name);
+}
+
+// PRAGMA parser_tools_index_update(index_table, log_table, id_column, sql_column)
+// Creates the index table if needed and indexes every log row whose id is above the high-water mark,
+// so repeated calls only parse newly appended rows. The mark is a row of its own (kind NULL) and
+// covers rows without terms too. Postings of new rows are merged into the existing row of each term.
+// Ids are expected to grow monotonically: rows appended with an id at or below the mark are not indexed.
+static string PragmaIndexUpdateQuery(ClientContext &context, const FunctionParameters &parameters) {
+    auto index_table = QuoteQualifiedName(StringValue::Get(parameters.values[0]));
+    auto log_table = QuoteQualifiedName(StringValue::Get(parameters.values[1]));
+    auto id_column = KeywordHelper::WriteOptionallyQuoted(StringValue::Get(parameters.values[2]));
+    auto sql_column = KeywordHelper::WriteOptionallyQuoted(StringValue::Get(parameters.values[3]));
+
+    // the batch is materialized first, rows appended while the update runs are left for the next one
+    return StringUtil::Format(R"(
+CREATE TABLE IF NOT EXISTS %s (kind VARCHAR, qualifier VARCHAR, name VARCHAR, min_id BIGINT, max_id BIGINT, postings BLOB);
+INSERT INTO %s
+SELECT NULL, NULL, NULL, NULL, coalesce(max(max_id), -9223372036854775808), NULL
+FROM %s
+HAVING count(*) FILTER (WHERE kind IS NULL) = 0;
+CREATE OR REPLACE TEMPORARY TABLE parser_tools_index_batch AS
+SELECT %s::BIGINT AS id, %s AS query
+FROM %s
+WHERE %s > (SELECT max_id FROM %s WHERE kind IS NULL);
+CREATE OR REPLACE TEMPORARY TABLE parser_tools_index_batch_terms AS
+SELECT term.kind, term.qualifier, term.name, min(id) AS min_id, max(id) AS max_id, list(id) AS ids
+FROM (SELECT id, unnest(parser_tools_index_terms(query)) AS term FROM parser_tools_index_batch)
+GROUP BY term.kind, term.qualifier, term.name;
+UPDATE %s AS i
+SET min_id = least(i.min_id, b.min_id), max_id = greatest(i.max_id, b.max_id),
+    postings = postings_encode(list_concat(postings_decode(i.postings), b.ids))
+FROM parser_tools_index_batch_terms AS b
+WHERE i.kind = b.kind AND i.qualifier IS NOT DISTINCT FROM b.qualifier AND i.name = b.name;
+INSERT INTO %s
+SELECT b.kind, b.qualifier, b.name, b.min_id, b.max_id, postings_encode(b.ids)
+FROM parser_tools_index_batch_terms AS b
+WHERE NOT EXISTS (
+    SELECT 1 FROM %s AS i
+    WHERE i.kind = b.kind AND i.qualifier IS NOT DISTINCT FROM b.qualifier AND i.name = b.name
+);
+UPDATE %s
+SET max_id = greatest(max_id, coalesce((SELECT max(id) FROM parser_tools_index_batch), max_id))
+WHERE kind IS NULL;
+DROP TABLE parser_tools_index_batch_terms;
+DROP TABLE parser_tools_index_batch;
+)", index_table, index_table, index_table, id_column, sql_column, log_table, id_column, index_table,
+    index_table, index_table, index_table, index_table);
+}
+
+// Extension scaffolding
+// ---------------------------------------------------
+
+void RegisterQueryIndexFunctions(DatabaseInstance &db) {
+    // parser_tools_index_terms returns the distinct tables, columns and functions referenced by a query
+    auto return_type = LogicalType::LIST(LogicalType::STRUCT({
+        {"kind", LogicalType::VARCHAR},
+        {"qualifier", LogicalType::VARCHAR},
+        {"name", LogicalType::VARCHAR}
+    }));
+    ScalarFunction terms("parser_tools_index_terms", {LogicalType::VARCHAR}, return_type, IndexTermsScalarFunction);
+    ExtensionUtil::RegisterFunction(db, terms);
+
+    // postings_encode / postings_decode convert between a list of row ids and a compressed posting list
+    ScalarFunction encode("postings_encode", {LogicalType::LIST(LogicalType::BIGINT)}, LogicalType::BLOB,
+                          PostingsEncodeScalarFunction);
+    ExtensionUtil::RegisterFunction(db, encode);
+
+    ScalarFunction decode("postings_decode", {LogicalType::BLOB}, LogicalType::LIST(LogicalType::BIGINT),
+                          PostingsDecodeScalarFunction);
+    ExtensionUtil::RegisterFunction(db, decode);
+
+    auto update = PragmaFunction::PragmaCall("parser_tools_index_update", PragmaIndexUpdateQuery,
+        {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR});
+    ExtensionUtil::RegisterFunction(db, update);
+}
+
+} // namespace duckdb
@@ -0,0 +1,709 @@
+#include "result_cache.hpp"
+#include "parse_tables_recursive.hpp"
+#include "parser_tools_limits.hpp"
+#include "sql_access_profile.hpp"
+#include "duckdb.hpp"
+#include "duckdb/common/enums/expression_type.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include "duckdb/parser/parser.hpp"
+#include "duckdb/parser/parsed_expression_iterator.hpp"
+#include "duckdb/parser/expression/between_expression.hpp"
+#include "duckdb/parser/expression/columnref_expression.hpp"
+#include "duckdb/parser/expression/comparison_expression.hpp"
+#include "duckdb/parser/expression/conjunction_expression.hpp"
+#include "duckdb/parser/expression/constant_expression.hpp"
+#include "duckdb/parser/parsed_data/copy_info.hpp"
+#include "duckdb/parser/query_node/select_node.hpp"
+#include "duckdb/parser/statement/copy_statement.hpp"
+#include "duckdb/parser/statement/delete_statement.hpp"
+#include "duckdb/parser/statement/insert_statement.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+#include "duckdb/parser/statement/update_statement.hpp"
+#include "duckdb/parser/tableref/basetableref.hpp"
+#include "duckdb/parser/tableref/expressionlistref.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace duckdb {
+
+// ---------------------------------------------------
+// Column ranges
+// ---------------------------------------------------
+
+// The values a column can take, as far as simple comparisons with constants tell
+struct ColumnRange {
+    ColumnRange() : has_lower(false), lower_inclusive(false), has_upper(false), upper_inclusive(false) {
+    }
+
+    bool has_lower;
+    bool lower_inclusive;
+    Value lower;
+    bool has_upper;
+    bool upper_inclusive;
+    Value upper;
+};
+
+// Keyed by lower case column name, a row must satisfy every range
+using ColumnRanges = std::unordered_map<std::string, ColumnRange>;
+
+static int OrderValues(const Value &left, const Value &right) {
+    return left < right ? -1 : (right < left ? 1 : 0);
+}
+
+// Orders two constants, returns false if they cannot be compared. The type of the column is not
+// known, so numbers are only compared with numbers and strings with strings. Strings that also read
+// as numbers or timestamps must order the same way under that reading, the column could be of that type.
+static bool CompareConstants(const Value &left, const Value &right, int &result) {
+    if (left.IsNull() || right.IsNull()) {
+        return false;
+    }
+    if (left.type().IsNumeric() && right.type().IsNumeric()) {
+        Value l = left;
+        Value r = right;
+        if (!l.DefaultTryCastAs(LogicalType::DOUBLE, true) || !r.DefaultTryCastAs(LogicalType::DOUBLE, true)) {
+            return false;
+        }
+        result = OrderValues(l, r);
+        return true;
+    }
+    if (left.type().id() != LogicalTypeId::VARCHAR || right.type().id() != LogicalTypeId::VARCHAR) {
+        return false;
+    }
+    auto &l = StringValue::Get(left);
+    auto &r = StringValue::Get(right);
+    result = l < r ? -1 : (r < l ? 1 : 0);
+    for (auto &type : {LogicalType(LogicalTypeId::DOUBLE), LogicalType(LogicalTypeId::TIMESTAMP)}) {
+        Value l_cast = left;
+        Value r_cast = right;
+        if (l_cast.DefaultTryCastAs(type, true) && r_cast.DefaultTryCastAs(type, true) &&
+            OrderValues(l_cast, r_cast) != result) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Dropping a bound only widens the range, so bounds that cannot be compared keep the first one
+static void TightenLower(ColumnRange &range, const Value &value, bool inclusive) {
+    int cmp;
+    if (!range.has_lower || (CompareConstants(value, range.lower, cmp) && (cmp > 0 || (cmp == 0 && !inclusive)))) {
+        range.has_lower = true;
+        range.lower = value;
+        range.lower_inclusive = inclusive;
+    }
+}
+
+static void TightenUpper(ColumnRange &range, const Value &value, bool inclusive) {
+    int cmp;
+    if (!range.has_upper || (CompareConstants(value, range.upper, cmp) && (cmp < 0 || (cmp == 0 && !inclusive)))) {
+        range.has_upper = true;
+        range.upper = value;
+        range.upper_inclusive = inclusive;
+    }
+}
+
+// Whether every value of a is smaller than every value of b
+static bool Below(const ColumnRange &a, const ColumnRange &b) {
+    int cmp;
+    if (!a.has_upper || !b.has_lower || !CompareConstants(a.upper, b.lower, cmp)) {
+        return false;
+    }
+    return cmp < 0 || (cmp == 0 && !(a.upper_inclusive && b.lower_inclusive));
+}
+
+// Whether no row can satisfy both sets of ranges
+static bool Disjoint(const ColumnRanges &a, const ColumnRanges &b) {
+    for (auto &entry : a) {
+        auto other = b.find(entry.first);
+        if (other != b.end() && (Below(entry.second, other->second) || Below(other->second, entry.second))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The column name if expr references a column of the table, empty otherwise
+static std::string ColumnOf(const ParsedExpression &expr, const std::string &table, const std::string &alias,
+                            bool allow_unqualified) {
+    if (expr.GetExpressionClass() != ExpressionClass::COLUMN_REF) {
+        return "";
+    }
+    auto &column = (ColumnRefExpression &)expr;
+    if (column.column_names.size() == 1) {
+        return allow_unqualified ? StringUtil::Lower(column.GetColumnName()) : "";
+    }
+    auto qualifier = StringUtil::Lower(column.column_names[column.column_names.size() - 2]);
+    if (qualifier != StringUtil::Lower(alias.empty() ? table : alias)) {
+        return "";
+    }
+    return StringUtil::Lower(column.GetColumnName());
+}
+
+// Ranges implied by the top-level AND of a condition. Conjuncts that are not a comparison of a
+// column with a constant are skipped, which only makes the ranges wider than the rows they describe.
+static void CollectRanges(const ParsedExpression &condition, const std::string &table, const std::string &alias,
+                          bool allow_unqualified, ColumnRanges &ranges) {
+    switch (condition.GetExpressionClass()) {
+        case ExpressionClass::CONJUNCTION: {
+            if (condition.type != ExpressionType::CONJUNCTION_AND) {
+                return;
+            }
+            auto &conjunction = (ConjunctionExpression &)condition;
+            for (auto &child : conjunction.children) {
+                CollectRanges(*child, table, alias, allow_unqualified, ranges);
+            }
+            break;
+        }
+        case ExpressionClass::COMPARISON: {
+            auto &comparison = (ComparisonExpression &)condition;
+            auto type = comparison.type;
+            auto column = ColumnOf(*comparison.left, table, alias, allow_unqualified);
+            auto constant = comparison.right.get();
+            if (column.empty()) {
+                // 5 < x is x > 5
+                column = ColumnOf(*comparison.right, table, alias, allow_unqualified);
+                constant = comparison.left.get();
+                type = FlipComparisonExpression(type);
+            }
+            if (column.empty() || constant->GetExpressionClass() != ExpressionClass::CONSTANT) {
+                return;
+            }
+            auto &value = ((ConstantExpression &)*constant).value;
+            auto &range = ranges[column];
+            switch (type) {
+                case ExpressionType::COMPARE_EQUAL:
+                    TightenLower(range, value, true);
+                    TightenUpper(range, value, true);
+                    break;
+                case ExpressionType::COMPARE_GREATERTHAN:
+                    TightenLower(range, value, false);
+                    break;
+                case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+                    TightenLower(range, value, true);
+                    break;
+                case ExpressionType::COMPARE_LESSTHAN:
+                    TightenUpper(range, value, false);
+                    break;
+                case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+                    TightenUpper(range, value, true);
+                    break;
+                default:
+                    break;
+            }
+            break;
+        }
+        case ExpressionClass::BETWEEN: {
+            auto &between = (BetweenExpression &)condition;
+            auto column = ColumnOf(*between.input, table, alias, allow_unqualified);
+            if (column.empty()) {
+                return;
+            }
+            auto &range = ranges[column];
+            if (between.lower->GetExpressionClass() == ExpressionClass::CONSTANT) {
+                TightenLower(range, ((ConstantExpression &)*between.lower).value, true);
+            }
+            if (between.upper->GetExpressionClass() == ExpressionClass::CONSTANT) {
+                TightenUpper(range, ((ConstantExpression &)*between.upper).value, true);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static bool ContainsSubquery(const ParsedExpression &expr) {
+    if (expr.GetExpressionClass() == ExpressionClass::SUBQUERY) {
+        return true;
+    }
+    bool found = false;
+    ParsedExpressionIterator::EnumerateChildren(expr, [&](const ParsedExpression &child) {
+        found = found || ContainsSubquery(child);
+    });
+    return found;
+}
+
+// ---------------------------------------------------
+// Registry
+// ---------------------------------------------------
+
+struct CachedTable {
+    std::string catalog; // empty if it could not be resolved
+    std::string schema;
+    std::string name;
+};
+
+struct CachedQuery {
+    std::vector<CachedTable> tables;
+    // only set when the query reads a single base table, once, without subqueries
+    ColumnRanges ranges;
+};
+
+// What a statement changes in one object. With a footprint, only the rows it describes change.
+struct WriteEffect {
+    WriteEffect() : whole_schema(false), any_schema(false), footprint(false), by_rows(false) {
+    }
+
+    std::string catalog;
+    std::string schema;
+    std::string name;
+    bool whole_schema; // CREATE / DROP SCHEMA, name is empty
+    bool any_schema;   // the name did not resolve, it may be read under any catalog and schema
+    bool footprint;
+    bool by_rows;                    // INSERT ... VALUES: each row is a point
+    ColumnRanges ranges;             // UPDATE / DELETE: the rows matched by the WHERE clause
+    std::vector<ColumnRanges> rows;
+};
+
+static std::string IndexKey(const std::string &schema, const std::string &name) {
+    return schema + "." + name;
+}
+
+/**
+ * The read sets of the registered queries, with a reverse index from table to keys. One registry
+ * is shared by the cache functions of a database.
+ */
+class ResultCacheRegistry : public ScalarFunctionInfo {
+public:
+    void Register(const std::string &key, CachedQuery query) {
+        std::lock_guard<std::mutex> guard(lock);
+        RemoveLocked(key);
+        for (auto &table : query.tables) {
+            readers[IndexKey(table.schema, table.name)].insert(key);
+        }
+        queries.emplace(key, std::move(query));
+    }
+
+    bool Unregister(const std::string &key) {
+        std::lock_guard<std::mutex> guard(lock);
+        return RemoveLocked(key);
+    }
+
+    void InvalidatedBy(const std::vector<WriteEffect> &effects, bool everything, std::set<std::string> &keys) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (everything) {
+            for (auto &entry : queries) {
+                keys.insert(entry.first);
+            }
+            return;
+        }
+        for (auto &effect : effects) {
+            if (effect.whole_schema) {
+                for (auto &entry : queries) {
+                    for (auto &table : entry.second.tables) {
+                        if (table.schema == effect.schema && (effect.catalog.empty() || table.catalog == effect.catalog)) {
+                            keys.insert(entry.first);
+                        }
+                    }
+                }
+                continue;
+            }
+            if (effect.any_schema) {
+                for (auto &entry : queries) {
+                    for (auto &table : entry.second.tables) {
+                        if (table.name == effect.name && Overlaps(entry.second, effect)) {
+                            keys.insert(entry.first);
+                        }
+                    }
+                }
+                continue;
+            }
+            auto candidates = readers.find(IndexKey(effect.schema, effect.name));
+            if (candidates == readers.end()) {
+                continue;
+            }
+            for (auto &key : candidates->second) {
+                auto &query = queries[key];
+                if (Reads(query, effect) && Overlaps(query, effect)) {
+                    keys.insert(key);
+                }
+            }
+        }
+    }
+
+private:
+    bool RemoveLocked(const std::string &key) {
+        auto entry = queries.find(key);
+        if (entry == queries.end()) {
+            return false;
+        }
+        for (auto &table : entry->second.tables) {
+            auto index_key = IndexKey(table.schema, table.name);
+            readers[index_key].erase(key);
+            if (readers[index_key].empty()) {
+                readers.erase(index_key);
+            }
+        }
+        queries.erase(entry);
+        return true;
+    }
+
+    // The index matches on schema and name, catalogs only have to agree when both are known
+    static bool Reads(const CachedQuery &query, const WriteEffect &effect) {
+        for (auto &table : query.tables) {
+            if (table.schema == effect.schema && table.name == effect.name &&
+                (table.catalog.empty() || effect.catalog.empty() || table.catalog == effect.catalog)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static bool Overlaps(const CachedQuery &query, const WriteEffect &effect) {
+        if (!effect.footprint || query.ranges.empty()) {
+            return true;
+        }
+        if (!effect.by_rows) {
+            return !Disjoint(effect.ranges, query.ranges);
+        }
+        for (auto &row : effect.rows) {
+            if (!Disjoint(row, query.ranges)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::mutex lock;
+    std::unordered_map<std::string, CachedQuery> queries;
+    std::unordered_map<std::string, std::unordered_set<std::string>> readers;
+};
+
+static ResultCacheRegistry &GetRegistry(ExpressionState &state) {
+    auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+    return (ResultCacheRegistry &)*func_expr.function.function_info;
+}
+
+// ---------------------------------------------------
+// Read sets
+// ---------------------------------------------------
+
+// The ranges of a query that reads one base table, directly and only once
+static void CollectQueryRanges(const SelectStatement &select, const ResolvedName &table, ColumnRanges &ranges) {
+    if (!table.found || table.object_type != "table" || !select.node ||
+        select.node->type != QueryNodeType::SELECT_NODE) {
+        return;
+    }
+    auto &node = (SelectNode &)*select.node;
+    if (!node.cte_map.map.empty() || !node.from_table || node.from_table->type != TableReferenceType::BASE_TABLE ||
+        !node.where_clause) {
+        return;
+    }
+    // a subquery anywhere could read other rows of the same table
+    bool has_subquery = false;
+    ParsedExpressionIterator::EnumerateQueryNodeChildren(node, [&](unique_ptr<ParsedExpression> &child) {
+        has_subquery = has_subquery || ContainsSubquery(*child);
+    });
+    if (has_subquery) {
+        return;
+    }
+    auto &base = (BaseTableRef &)*node.from_table;
+    CollectRanges(*node.where_clause, base.table_name, base.alias, true, ranges);
+}
+
+// Returns false if the SQL is not one or more queries
+static bool BuildCachedQuery(ClientContext &context, DependencyGraph &graph, const std::string &sql,
+                             CachedQuery &query) {
+    if (!ExtractionBudget::AllowInput(sql)) {
+        return false;
+    }
+
+    Parser parser;
+
+    try {
+        parser.ParseQuery(sql);
+    } catch (const ParserException &ex) {
+        return false;
+    }
+
+    if (parser.statements.empty() || !ExtractionBudget::CheckDeadline()) {
+        return false;
+    }
+
+    std::vector<ResolvedName> roots;
+    for (auto &stmt : parser.statements) {
+        if (stmt->type != StatementType::SELECT_STATEMENT) {
+            return false;
+        }
+        auto &select_stmt = (SelectStatement &)*stmt;
+        if (select_stmt.node) {
+            CollectDependencies(context, graph.resolver, *select_stmt.node, nullptr, roots);
+        }
+    }
+
+    // views and table macros are expanded, a write to any table below them invalidates the query
+    std::vector<DependencyResult> dependencies;
+    graph.Expand(context, roots, dependencies);
+    std::unordered_set<std::string> seen;
+    for (auto &dependency : dependencies) {
+        auto &object = dependency.object;
+        CachedTable table;
+        table.catalog = object.found ? StringUtil::Lower(object.catalog) : "";
+        table.schema = StringUtil::Lower(object.schema);
+        table.name = StringUtil::Lower(object.name);
+        if (seen.insert(table.catalog + "." + IndexKey(table.schema, table.name)).second) {
+            query.tables.push_back(std::move(table));
+        }
+    }
+
+    if (parser.statements.size() == 1 && roots.size() == 1) {
+        CollectQueryRanges((SelectStatement &)*parser.statements[0], roots[0], query.ranges);
+    }
+    return true;
+}
+
+// ---------------------------------------------------
+// Write sets
+// ---------------------------------------------------
+
+static void RangesOfTarget(const unique_ptr<TableRef> &target, const unique_ptr<ParsedExpression> &condition,
+                           bool joined, WriteEffect &effect) {
+    if (!target || target->type != TableReferenceType::BASE_TABLE) {
+        return;
+    }
+    effect.footprint = true;
+    if (condition) {
+        // with USING / FROM, unqualified columns may belong to another table
+        auto &base = (BaseTableRef &)*target;
+        CollectRanges(*condition, base.table_name, base.alias, !joined, effect.ranges);
+    }
+}
+
+// The rows changed in the target of an INSERT, UPDATE or DELETE, if they can be told
+static void CollectFootprint(SQLStatement &stmt, WriteEffect &effect) {
+    switch (stmt.type) {
+        case StatementType::DELETE_STATEMENT: {
+            auto &del = (DeleteStatement &)stmt;
+            RangesOfTarget(del.table, del.condition, !del.using_clauses.empty(), effect);
+            break;
+        }
+        case StatementType::UPDATE_STATEMENT: {
+            auto &update = (UpdateStatement &)stmt;
+            if (!update.set_info) {
+                return;
+            }
+            RangesOfTarget(update.table, update.set_info->condition, update.from_table != nullptr, effect);
+            // an updated column can move rows into any range
+            for (auto &column : update.set_info->columns) {
+                effect.ranges.erase(StringUtil::Lower(column));
+            }
+            break;
+        }
+        case StatementType::INSERT_STATEMENT: {
+            auto &insert = (InsertStatement &)stmt;
+            // without a column list the position of a value says nothing about its column
+            if (insert.columns.empty() || insert.on_conflict_info || insert.default_values ||
+                insert.column_order != InsertColumnOrder::INSERT_BY_POSITION || !insert.select_statement ||
+                !insert.select_statement->node || insert.select_statement->node->type != QueryNodeType::SELECT_NODE) {
+                return;
+            }
+            auto &node = (SelectNode &)*insert.select_statement->node;
+            if (!node.from_table || node.from_table->type != TableReferenceType::EXPRESSION_LIST) {
+                return;
+            }
+            auto &values = (ExpressionListRef &)*node.from_table;
+            for (auto &row : values.values) {
+                ColumnRanges point;
+                for (idx_t i = 0; i < row.size() && i < insert.columns.size(); i++) {
+                    if (row[i]->GetExpressionClass() != ExpressionClass::CONSTANT) {
+                        continue;
+                    }
+                    auto &value = ((ConstantExpression &)*row[i]).value;
+                    auto &range = point[StringUtil::Lower(insert.columns[i])];
+                    TightenLower(range, value, true);
+                    TightenUpper(range, value, true);
+                }
+                effect.rows.push_back(std::move(point));
+            }
+            effect.footprint = true;
+            effect.by_rows = true;
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// Resolves a written object through the catalog and search path, the same way the read sets are
+static void ResolveWrittenObject(ClientContext &context, CatalogResolver &resolver, const SqlWrittenObject &object,
+                                 WriteEffect &effect) {
+    if (object.is_schema) {
+        effect.whole_schema = true;
+        effect.catalog = StringUtil::Lower(object.catalog);
+        effect.schema = StringUtil::Lower(object.schema);
+        return;
+    }
+    auto resolved = &resolver.Resolve(context, ResolveKind::Table, object.catalog, object.schema, object.name);
+    if (!resolved->found) {
+        // table macros are read like tables
+        resolved = &resolver.Resolve(context, ResolveKind::TableFunction, object.catalog, object.schema, object.name);
+    }
+    if (!resolved->found) {
+        // e.g. a table created by the statement, which can shadow a table of the same name elsewhere
+        effect.any_schema = true;
+        effect.name = StringUtil::Lower(object.name);
+        return;
+    }
+    effect.catalog = StringUtil::Lower(resolved->catalog);
+    effect.schema = StringUtil::Lower(resolved->schema);
+    effect.name = StringUtil::Lower(resolved->name);
+}
+
+// Returns false if the statements may have changed anything, e.g. when the SQL does not parse
+static bool CollectWriteEffects(ClientContext &context, CatalogResolver &resolver, const std::string &sql,
+                                std::vector<WriteEffect> &effects) {
+    if (!ExtractionBudget::AllowInput(sql)) {
+        return false;
+    }
+
+    Parser parser;
+
+    try {
+        parser.ParseQuery(sql);
+    } catch (const ParserException &ex) {
+        return false;
+    }
+
+    if (!ExtractionBudget::CheckDeadline()) {
+        return false;
+    }
+
+    for (auto &stmt : parser.statements) {
+        if (stmt->type == StatementType::COPY_STATEMENT && !((CopyStatement &)*stmt).info->is_from) {
+            // COPY TO writes a file, not the database
+            continue;
+        }
+        SqlAccessProfile profile;
+        ProfileStatementAccess(*stmt, profile);
+        if (profile.read_only) {
+            continue;
+        }
+        if (profile.writes.empty() || profile.written_objects.size() != profile.writes.size()) {
+            // PRAGMA, CALL, SET, ATTACH, ... can change what any query returns, as can writes to
+            // objects whose name cannot be told
+            return false;
+        }
+
+        WriteEffect target;
+        CollectFootprint(*stmt, target);
+        for (idx_t i = 0; i < profile.written_objects.size(); i++) {
+            WriteEffect effect;
+            ResolveWrittenObject(context, resolver, profile.written_objects[i], effect);
+            // the first write of a DML statement is its target table, later ones are sequences
+            if (i == 0 && target.footprint) {
+                effect.footprint = true;
+                effect.by_rows = target.by_rows;
+                effect.ranges = target.ranges;
+                effect.rows = target.rows;
+            }
+            effects.push_back(std::move(effect));
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------
+// Scalar functions
+// ---------------------------------------------------
+
+static void CacheRegisterScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    auto &context = state.GetContext();
+    auto &registry = GetRegistry(state);
+    auto limits = ParserToolsLimits::Get(context);
+    // views are expanded once per chunk
+    DependencyGraph graph;
+
+    BinaryExecutor::Execute<string_t, string_t, bool>(args.data[0], args.data[1], result, args.size(),
+    [&](string_t key, string_t sql) {
+        CachedQuery query;
+        ExtractionBudget budget(limits);
+        bool registered = BuildCachedQuery(context, graph, sql.GetString(), query);
+        if (!budget.KeepResult("cache_register") || budget.Exceeded()) {
+            // a truncated read set could miss a table
+            registered = false;
+        }
+        if (registered) {
+            registry.Register(key.GetString(), std::move(query));
+        } else {
+            registry.Unregister(key.GetString());
+        }
+        return registered;
+    });
+}
+
+static void CacheUnregisterScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    auto &registry = GetRegistry(state);
+    UnaryExecutor::Execute<string_t, bool>(args.data[0], result, args.size(), [&](string_t key) {
+        return registry.Unregister(key.GetString());
+    });
+}
+
+static void CacheInvalidatedByScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    auto &input = args.data[0];
+    auto count = args.size();
+    auto &context = state.GetContext();
+    auto &registry = GetRegistry(state);
+    auto limits = ParserToolsLimits::Get(context);
+    // written names are resolved once per chunk
+    CatalogResolver resolver;
+
+    UnifiedVectorFormat input_data;
+    input.ToUnifiedFormat(count, input_data);
+    auto statements = UnifiedVectorFormat::GetData<string_t>(input_data);
+
+    for (idx_t row = 0; row < count; row++) {
+        auto idx = input_data.sel->get_index(row);
+        if (!input_data.validity.RowIsValid(idx)) {
+            result.SetValue(row, Value(result.GetType()));
+            continue;
+        }
+
+        std::vector<WriteEffect> effects;
+        ExtractionBudget budget(limits);
+        bool known = CollectWriteEffects(context, resolver, statements[idx].GetString(), effects);
+        if (!budget.KeepResult("cache_invalidated_by") || budget.Exceeded()) {
+            // when in doubt, everything is invalidated
+            known = false;
+        }
+
+        std::set<std::string> keys;
+        registry.InvalidatedBy(effects, !known, keys);
+        vector<Value> values;
+        for (auto &key : keys) {
+            values.emplace_back(key);
+        }
+        result.SetValue(row, Value::LIST(LogicalType::VARCHAR, std::move(values)));
+    }
+}
+
+// Extension scaffolding
+// ---------------------------------------------------
+
+void RegisterResultCacheFunctions(DatabaseInstance &db) {
+    // the registry lives as long as the functions of this database
+    auto registry = make_shared_ptr<ResultCacheRegistry>();
+
+    ScalarFunction cache_register("cache_register", {LogicalType::VARCHAR, LogicalType::VARCHAR},
+                                  LogicalType::BOOLEAN, CacheRegisterScalarFunction);
+    cache_register.function_info = registry;
+    cache_register.stability = FunctionStability::VOLATILE;
+    ExtensionUtil::RegisterFunction(db, cache_register);
+
+    ScalarFunction cache_unregister("cache_unregister", {LogicalType::VARCHAR}, LogicalType::BOOLEAN,
+                                    CacheUnregisterScalarFunction);
+    cache_unregister.function_info = registry;
+    cache_unregister.stability = FunctionStability::VOLATILE;
+    ExtensionUtil::RegisterFunction(db, cache_unregister);
+
+    ScalarFunction invalidated_by("cache_invalidated_by", {LogicalType::VARCHAR},
+                                  LogicalType::LIST(LogicalType::VARCHAR), CacheInvalidatedByScalarFunction);
+    invalidated_by.function_info = registry;
+    invalidated_by.stability = FunctionStability::VOLATILE;
+    ExtensionUtil::RegisterFunction(db, invalidated_by);
+}
+
+} // namespace duckdb
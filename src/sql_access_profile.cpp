@@ -0,0 +1,589 @@
+#include "sql_access_profile.hpp"
+#include "parse_tables.hpp"
+#include "parser_tools_limits.hpp"
+#include "sql_scanner.hpp"
+#include "duckdb.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include "duckdb/parser/parser.hpp"
+#include "duckdb/parser/parsed_expression_iterator.hpp"
+#include "duckdb/parser/expression/columnref_expression.hpp"
+#include "duckdb/parser/expression/constant_expression.hpp"
+#include "duckdb/parser/expression/function_expression.hpp"
+#include "duckdb/parser/expression/subquery_expression.hpp"
+#include "duckdb/parser/parsed_data/alter_info.hpp"
+#include "duckdb/parser/parsed_data/copy_info.hpp"
+#include "duckdb/parser/parsed_data/create_function_info.hpp"
+#include "duckdb/parser/parsed_data/create_index_info.hpp"
+#include "duckdb/parser/parsed_data/create_sequence_info.hpp"
+#include "duckdb/parser/parsed_data/create_table_info.hpp"
+#include "duckdb/parser/parsed_data/create_type_info.hpp"
+#include "duckdb/parser/parsed_data/create_view_info.hpp"
+#include "duckdb/parser/parsed_data/drop_info.hpp"
+#include "duckdb/parser/statement/alter_statement.hpp"
+#include "duckdb/parser/statement/copy_statement.hpp"
+#include "duckdb/parser/statement/create_statement.hpp"
+#include "duckdb/parser/statement/delete_statement.hpp"
+#include "duckdb/parser/statement/drop_statement.hpp"
+#include "duckdb/parser/statement/explain_statement.hpp"
+#include "duckdb/parser/statement/insert_statement.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+#include "duckdb/parser/statement/update_statement.hpp"
+#include "duckdb/parser/tableref/basetableref.hpp"
+#include "duckdb/parser/tableref/expressionlistref.hpp"
+#include "duckdb/parser/tableref/joinref.hpp"
+#include "duckdb/parser/tableref/subqueryref.hpp"
+#include "duckdb/parser/tableref/table_function_ref.hpp"
+#include <unordered_set>
+
+namespace duckdb {
+
+// Functions whose result differs between calls with the same arguments, or that read data from
+// outside the database. Besides these, every read_* and *_scan table function is an external source.
+static const char *VOLATILE_FUNCTIONS[] = {
+    "random", "setseed", "uuid", "gen_random_uuid", "uuidv4", "uuidv7",
+    "now", "get_current_timestamp", "transaction_timestamp", "get_current_time", "current_date",
+    "current_localtime", "current_localtimestamp", "today",
+    "nextval", "currval",
+    "glob", "sniff_csv", "parquet_metadata", "parquet_schema", "parquet_file_metadata", "parquet_kv_metadata",
+    nullptr
+};
+
+// SQL value functions, which the parser leaves as unqualified column references
+static const char *VOLATILE_KEYWORDS[] = {
+    "current_timestamp", "current_date", "current_time", "localtime", "localtimestamp",
+    nullptr
+};
+
+static bool Contains(const char *const *names, const std::string &name) {
+    for (idx_t i = 0; names[i]; i++) {
+        if (name == names[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool IsVolatileFunction(const std::string &name) {
+    return Contains(VOLATILE_FUNCTIONS, name) || StringUtil::StartsWith(name, "read_") ||
+           StringUtil::EndsWith(name, "_scan");
+}
+
+static std::string ObjectName(const std::string &catalog, const std::string &schema, const std::string &name) {
+    std::string result = catalog.empty() ? "" : catalog + ".";
+    return result + (schema.empty() ? "main" : schema) + "." + name;
+}
+
+class AccessProfileCollector {
+public:
+    explicit AccessProfileCollector(SqlAccessProfile &profile) : profile(profile) {
+    }
+
+    void VisitStatement(SQLStatement &stmt) {
+        // the CTEs of a statement are only visible inside it
+        auto scope_size = cte_scope.size();
+        switch (stmt.type) {
+            case StatementType::SELECT_STATEMENT: {
+                auto &select_stmt = (SelectStatement &)stmt;
+                VisitQueryNode(select_stmt.node);
+                break;
+            }
+            case StatementType::INSERT_STATEMENT: {
+                auto &insert = (InsertStatement &)stmt;
+                VisitCTEMap(insert.cte_map);
+                AddWrittenObject(insert.catalog, insert.schema, insert.table);
+                if (insert.select_statement) {
+                    VisitQueryNode(insert.select_statement->node);
+                }
+                break;
+            }
+            case StatementType::UPDATE_STATEMENT: {
+                auto &update = (UpdateStatement &)stmt;
+                VisitCTEMap(update.cte_map);
+                AddWrittenTableRef(update.table);
+                VisitTableRef(update.from_table);
+                if (update.set_info) {
+                    VisitExpression(update.set_info->condition);
+                    for (auto &expr : update.set_info->expressions) {
+                        VisitExpression(expr);
+                    }
+                }
+                break;
+            }
+            case StatementType::DELETE_STATEMENT: {
+                auto &del = (DeleteStatement &)stmt;
+                VisitCTEMap(del.cte_map);
+                AddWrittenTableRef(del.table);
+                for (auto &using_clause : del.using_clauses) {
+                    VisitTableRef(using_clause);
+                }
+                VisitExpression(del.condition);
+                break;
+            }
+            case StatementType::CREATE_STATEMENT: {
+                auto &create = (CreateStatement &)stmt;
+                VisitCreateInfo(*create.info);
+                break;
+            }
+            case StatementType::DROP_STATEMENT: {
+                auto &drop = (DropStatement &)stmt;
+                auto &info = *drop.info;
+                if (info.type == CatalogType::SCHEMA_ENTRY) {
+                    AddWrittenSchema(info.catalog, info.name);
+                } else {
+                    AddWrittenObject(info.catalog, info.schema, info.name);
+                }
+                break;
+            }
+            case StatementType::ALTER_STATEMENT: {
+                auto &alter = (AlterStatement &)stmt;
+                AddWrittenObject(alter.info->catalog, alter.info->schema, alter.info->name);
+                break;
+            }
+            case StatementType::COPY_STATEMENT: {
+                auto &copy = (CopyStatement &)stmt;
+                auto &info = *copy.info;
+                if (info.is_from) {
+                    AddRead(info.file_path);
+                    AddWrittenObject(info.catalog, info.schema, info.table);
+                    // the file can change between executions
+                    profile.deterministic = false;
+                } else {
+                    if (info.select_statement) {
+                        VisitQueryNode(info.select_statement);
+                    } else {
+                        AddRead(ObjectName(info.catalog, info.schema, info.table));
+                    }
+                    AddWrite(info.file_path);
+                }
+                break;
+            }
+            case StatementType::EXPLAIN_STATEMENT: {
+                // EXPLAIN ANALYZE runs the statement, so both are profiled like the statement itself
+                auto &explain = (ExplainStatement &)stmt;
+                if (explain.stmt) {
+                    VisitStatement(*explain.stmt);
+                }
+                return;
+            }
+            case StatementType::TRANSACTION_STATEMENT:
+                return;
+            default:
+                // SET, PRAGMA, CALL, ATTACH, CHECKPOINT, ... are assumed to have side effects
+                break;
+        }
+        cte_scope.resize(scope_size);
+        if (stmt.type != StatementType::SELECT_STATEMENT) {
+            profile.read_only = false;
+        }
+    }
+
+private:
+    void VisitCreateInfo(CreateInfo &info) {
+        switch (info.type) {
+            case CatalogType::TABLE_ENTRY: {
+                auto &table_info = (CreateTableInfo &)info;
+                AddWrittenObject(info.catalog, info.schema, table_info.table);
+                if (table_info.query) {
+                    VisitQueryNode(table_info.query->node);
+                }
+                break;
+            }
+            case CatalogType::VIEW_ENTRY: {
+                // the view's query is not run, but it must be bindable against the objects it reads
+                auto &view_info = (CreateViewInfo &)info;
+                AddWrittenObject(info.catalog, info.schema, view_info.view_name);
+                if (view_info.query) {
+                    VisitQueryNode(view_info.query->node);
+                }
+                break;
+            }
+            case CatalogType::INDEX_ENTRY: {
+                auto &index_info = (CreateIndexInfo &)info;
+                AddWrittenObject(info.catalog, info.schema, index_info.index_name);
+                break;
+            }
+            case CatalogType::SEQUENCE_ENTRY: {
+                auto &sequence_info = (CreateSequenceInfo &)info;
+                AddWrittenObject(info.catalog, info.schema, sequence_info.name);
+                break;
+            }
+            case CatalogType::MACRO_ENTRY:
+            case CatalogType::TABLE_MACRO_ENTRY: {
+                auto &function_info = (CreateFunctionInfo &)info;
+                AddWrittenObject(info.catalog, info.schema, function_info.name);
+                break;
+            }
+            case CatalogType::TYPE_ENTRY: {
+                auto &type_info = (CreateTypeInfo &)info;
+                AddWrittenObject(info.catalog, info.schema, type_info.name);
+                break;
+            }
+            case CatalogType::SCHEMA_ENTRY:
+                AddWrittenSchema(info.catalog, info.schema);
+                break;
+            default:
+                break;
+        }
+    }
+
+    void VisitQueryNode(const unique_ptr<QueryNode> &node) {
+        if (!node) {
+            return;
+        }
+        auto scope_size = cte_scope.size();
+        AddCTENames(node->cte_map);
+
+        // base tables of the FROM clauses, including derived tables and CTE definitions
+        std::vector<TableRefResult> tables;
+        ExtractTablesFromQueryNode(*node, tables);
+        for (auto &table : tables) {
+            if (table.context == TableContext::CTE || table.context == TableContext::FromCTE) {
+                continue;
+            }
+            if (table.schema_name.empty() && table.catalog_name.empty() && IsCTE(table.table)) {
+                continue;
+            }
+            AddRead(ObjectName(table.catalog_name, table.schema_name, table.table));
+        }
+
+        // every expression of the tree, which also reaches table functions, join conditions and
+        // subquery expressions
+        ParsedExpressionIterator::EnumerateQueryNodeChildren(*node, [&](unique_ptr<ParsedExpression> &child) {
+            VisitExpression(child);
+        });
+        cte_scope.resize(scope_size);
+    }
+
+    void VisitTableRef(const unique_ptr<TableRef> &ref) {
+        if (!ref || !ExtractionBudget::Tick()) {
+            return;
+        }
+        switch (ref->type) {
+            case TableReferenceType::BASE_TABLE: {
+                auto &base = (BaseTableRef &)*ref;
+                AddRead(ObjectName(base.catalog_name, base.schema_name, base.table_name));
+                break;
+            }
+            case TableReferenceType::JOIN: {
+                auto &join = (JoinRef &)*ref;
+                VisitTableRef(join.left);
+                VisitTableRef(join.right);
+                VisitExpression(join.condition);
+                break;
+            }
+            case TableReferenceType::SUBQUERY: {
+                auto &subquery = (SubqueryRef &)*ref;
+                if (subquery.subquery) {
+                    VisitQueryNode(subquery.subquery->node);
+                }
+                break;
+            }
+            case TableReferenceType::TABLE_FUNCTION: {
+                auto &table_function = (TableFunctionRef &)*ref;
+                VisitExpression(table_function.function);
+                break;
+            }
+            case TableReferenceType::EXPRESSION_LIST: {
+                auto &values = (ExpressionListRef &)*ref;
+                for (auto &row : values.values) {
+                    for (auto &value : row) {
+                        VisitExpression(value);
+                    }
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    void VisitExpression(const unique_ptr<ParsedExpression> &expr) {
+        if (!expr || !ExtractionBudget::Tick()) {
+            return;
+        }
+        switch (expr->GetExpressionClass()) {
+            case ExpressionClass::FUNCTION: {
+                auto &function = (FunctionExpression &)*expr;
+                auto name = StringUtil::Lower(function.function_name);
+                if (IsVolatileFunction(name)) {
+                    AddVolatileFunction(name);
+                }
+                if (name == "nextval") {
+                    // advances the sequence
+                    profile.read_only = false;
+                    if (!function.children.empty() &&
+                        function.children[0]->GetExpressionClass() == ExpressionClass::CONSTANT) {
+                        auto &sequence = (ConstantExpression &)*function.children[0];
+                        auto sequence_name = sequence.value.ToString();
+                        auto parts = StringUtil::Split(sequence_name, ".");
+                        if (parts.size() == 1) {
+                            AddWrittenObject("", "", parts[0]);
+                        } else if (parts.size() == 2) {
+                            AddWrittenObject("", parts[0], parts[1]);
+                        } else if (parts.size() == 3) {
+                            AddWrittenObject(parts[0], parts[1], parts[2]);
+                        } else {
+                            AddWrite(sequence_name);
+                        }
+                    }
+                }
+                break;
+            }
+            case ExpressionClass::COLUMN_REF: {
+                auto &column = (ColumnRefExpression &)*expr;
+                if (!column.IsQualified()) {
+                    auto name = StringUtil::Lower(column.GetColumnName());
+                    if (Contains(VOLATILE_KEYWORDS, name)) {
+                        AddVolatileFunction(name);
+                    }
+                }
+                break;
+            }
+            case ExpressionClass::SUBQUERY: {
+                auto &subquery = (SubqueryExpression &)*expr;
+                if (subquery.subquery) {
+                    VisitQueryNode(subquery.subquery->node);
+                }
+                break;
+            }
+            default:
+                break;
+        }
+        ParsedExpressionIterator::EnumerateChildren(*expr, [&](unique_ptr<ParsedExpression> &child) {
+            VisitExpression(child);
+        });
+    }
+
+    // The WITH of INSERT/UPDATE/DELETE lives in the statement, so its definitions are visited here. A
+    // CTE sees the CTEs defined before it, and itself only if it is recursive.
+    void VisitCTEMap(const CommonTableExpressionMap &cte_map) {
+        for (auto &cte : cte_map.map) {
+            auto name = StringUtil::Lower(cte.first);
+            bool recursive = cte.second && cte.second->query && cte.second->query->node &&
+                             cte.second->query->node->type == QueryNodeType::RECURSIVE_CTE_NODE;
+            if (recursive) {
+                cte_scope.push_back(name);
+            }
+            if (cte.second && cte.second->query) {
+                VisitQueryNode(cte.second->query->node);
+            }
+            if (!recursive) {
+                cte_scope.push_back(name);
+            }
+        }
+    }
+
+    // The names stay in scope until the statement or query node that defines them has been visited
+    void AddCTENames(const CommonTableExpressionMap &cte_map) {
+        for (auto &cte : cte_map.map) {
+            cte_scope.push_back(StringUtil::Lower(cte.first));
+        }
+    }
+
+    bool IsCTE(const std::string &name) const {
+        auto lower_name = StringUtil::Lower(name);
+        for (auto &cte : cte_scope) {
+            if (cte == lower_name) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void AddWrittenTableRef(const unique_ptr<TableRef> &ref) {
+        if (ref && ref->type == TableReferenceType::BASE_TABLE) {
+            auto &base = (BaseTableRef &)*ref;
+            AddWrittenObject(base.catalog_name, base.schema_name, base.table_name);
+        }
+    }
+
+    void AddVolatileFunction(const std::string &name) {
+        profile.deterministic = false;
+        AddUnique(profile.volatile_functions, seen_functions, name);
+    }
+
+    void AddRead(const std::string &name) {
+        AddUnique(profile.reads, seen_reads, name);
+    }
+
+    void AddWrite(const std::string &name) {
+        AddUnique(profile.writes, seen_writes, name);
+    }
+
+    void AddWrittenObject(const std::string &catalog, const std::string &schema, const std::string &name) {
+        auto size = profile.writes.size();
+        AddWrite(ObjectName(catalog, schema, name));
+        if (profile.writes.size() > size) {
+            SqlWrittenObject object;
+            object.catalog = catalog;
+            object.schema = schema;
+            object.name = name;
+            profile.written_objects.push_back(std::move(object));
+        }
+    }
+
+    void AddWrittenSchema(const std::string &catalog, const std::string &schema) {
+        auto size = profile.writes.size();
+        AddWrite(catalog.empty() ? schema : catalog + "." + schema);
+        if (profile.writes.size() > size) {
+            SqlWrittenObject object;
+            object.catalog = catalog;
+            object.schema = schema;
+            object.is_schema = true;
+            profile.written_objects.push_back(std::move(object));
+        }
+    }
+
+    static void AddUnique(std::vector<std::string> &names, std::unordered_set<std::string> &seen,
+                          const std::string &name) {
+        if (seen.insert(name).second) {
+            names.push_back(name);
+        }
+    }
+
+    SqlAccessProfile &profile;
+    std::vector<std::string> cte_scope;
+    std::unordered_set<std::string> seen_reads;
+    std::unordered_set<std::string> seen_writes;
+    std::unordered_set<std::string> seen_functions;
+};
+
+bool ProfileSqlAccess(const std::string &sql, SqlAccessProfile &profile) {
+    if (!ExtractionBudget::AllowInput(sql)) {
+        return true;
+    }
+
+    // bulk INSERT ... VALUES and long IN lists are compacted first, their literals reference nothing
+    std::string compacted;
+    bool use_compacted = sql.size() >= LITERAL_FAST_PATH_MIN_BYTES && CompactLiteralLists(sql, compacted);
+
+    Parser parser;
+
+    try {
+        parser.ParseQuery(use_compacted ? compacted : sql);
+    } catch (const ParserException &ex) {
+        return false;
+    }
+
+    if (!ExtractionBudget::CheckDeadline()) {
+        return true;
+    }
+
+    AccessProfileCollector collector(profile);
+    for (auto &stmt : parser.statements) {
+        profile.statement_types.push_back(StringUtil::Lower(StatementTypeToString(stmt->type)));
+        collector.VisitStatement(*stmt);
+    }
+    if (!profile.read_only) {
+        // the result of a statement with side effects is never cacheable
+        profile.deterministic = false;
+    }
+    return true;
+}
+
+void ProfileStatementAccess(SQLStatement &stmt, SqlAccessProfile &profile) {
+    AccessProfileCollector collector(profile);
+    profile.statement_types.push_back(StringUtil::Lower(StatementTypeToString(stmt.type)));
+    collector.VisitStatement(stmt);
+    if (!profile.read_only) {
+        profile.deterministic = false;
+    }
+}
+
+// Appends the names to the child of a LIST(VARCHAR) vector and returns the entry of the row
+static list_entry_t WriteStringList(Vector &list_vector, const std::vector<std::string> &names) {
+    auto current_size = ListVector::GetListSize(list_vector);
+    auto new_size = current_size + names.size();
+
+    // Grow list vector if needed
+    if (ListVector::GetListCapacity(list_vector) < new_size) {
+        ListVector::Reserve(list_vector, new_size);
+    }
+
+    auto &child = ListVector::GetEntry(list_vector);
+    auto child_data = FlatVector::GetData<string_t>(child);
+    for (size_t i = 0; i < names.size(); i++) {
+        child_data[current_size + i] = StringVector::AddStringOrBlob(child, names[i]);
+    }
+    ListVector::SetListSize(list_vector, new_size);
+    return list_entry_t(current_size, names.size());
+}
+
+static void SqlAccessProfileScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    auto &input = args.data[0];
+    auto count = args.size();
+    auto limits = ParserToolsLimits::Get(state.GetContext());
+
+    UnifiedVectorFormat input_data;
+    input.ToUnifiedFormat(count, input_data);
+    auto queries = UnifiedVectorFormat::GetData<string_t>(input_data);
+
+    // Get the fields in the STRUCT
+    auto &entries = StructVector::GetEntries(result);
+    auto &read_only_entry = *entries[0];          // "read_only" field
+    auto &deterministic_entry = *entries[1];      // "deterministic" field
+    auto &statement_types_entry = *entries[2];    // "statement_types" field
+    auto &reads_entry = *entries[3];              // "reads" field
+    auto &writes_entry = *entries[4];             // "writes" field
+    auto &volatile_functions_entry = *entries[5]; // "volatile_functions" field
+
+    auto read_only_data = FlatVector::GetData<bool>(read_only_entry);
+    auto deterministic_data = FlatVector::GetData<bool>(deterministic_entry);
+    auto statement_types_data = FlatVector::GetData<list_entry_t>(statement_types_entry);
+    auto reads_data = FlatVector::GetData<list_entry_t>(reads_entry);
+    auto writes_data = FlatVector::GetData<list_entry_t>(writes_entry);
+    auto volatile_functions_data = FlatVector::GetData<list_entry_t>(volatile_functions_entry);
+
+    for (idx_t row = 0; row < count; row++) {
+        auto idx = input_data.sel->get_index(row);
+        if (!input_data.validity.RowIsValid(idx)) {
+            FlatVector::SetNull(result, row, true);
+            continue;
+        }
+
+        SqlAccessProfile profile;
+        ExtractionBudget budget(limits);
+        bool parsed = ProfileSqlAccess(queries[idx].GetString(), profile);
+        if (!parsed || !budget.KeepResult("sql_access_profile")) {
+            FlatVector::SetNull(result, row, true);
+            continue;
+        }
+        if (budget.Exceeded()) {
+            // a truncated profile may have missed a write, so it is never reported as safe
+            profile.read_only = false;
+            profile.deterministic = false;
+        }
+
+        read_only_data[row] = profile.read_only;
+        deterministic_data[row] = profile.deterministic;
+        statement_types_data[row] = WriteStringList(statement_types_entry, profile.statement_types);
+        reads_data[row] = WriteStringList(reads_entry, profile.reads);
+        writes_data[row] = WriteStringList(writes_entry, profile.writes);
+        volatile_functions_data[row] = WriteStringList(volatile_functions_entry, profile.volatile_functions);
+    }
+
+    if (args.AllConstant()) {
+        result.SetVectorType(VectorType::CONSTANT_VECTOR);
+    }
+}
+
+// Extension scaffolding
+// ---------------------------------------------------
+
+void RegisterSqlAccessProfileFunction(DatabaseInstance &db) {
+    // sql_access_profile classifies a statement or script as read-only / deterministic, e.g. to route
+    // queries to replicas and decide which results can be cached
+    auto return_type = LogicalType::STRUCT({
+        {"read_only", LogicalType::BOOLEAN},
+        {"deterministic", LogicalType::BOOLEAN},
+        {"statement_types", LogicalType::LIST(LogicalType::VARCHAR)},
+        {"reads", LogicalType::LIST(LogicalType::VARCHAR)},
+        {"writes", LogicalType::LIST(LogicalType::VARCHAR)},
+        {"volatile_functions", LogicalType::LIST(LogicalType::VARCHAR)}
+    });
+    ScalarFunction sf("sql_access_profile", {LogicalType::VARCHAR}, return_type, SqlAccessProfileScalarFunction);
+    ExtensionUtil::RegisterFunction(db, sf);
+}
+
+} // namespace duckdb
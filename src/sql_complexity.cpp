@@ -0,0 +1,370 @@
+#include "sql_complexity.hpp"
+#include "parser_tools_limits.hpp"
+#include "duckdb.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include "duckdb/parser/parser.hpp"
+#include "duckdb/parser/parsed_expression_iterator.hpp"
+#include "duckdb/parser/result_modifier.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+#include "duckdb/parser/query_node/select_node.hpp"
+#include "duckdb/parser/query_node/set_operation_node.hpp"
+#include "duckdb/parser/query_node/recursive_cte_node.hpp"
+#include "duckdb/parser/query_node/cte_node.hpp"
+#include "duckdb/parser/expression/conjunction_expression.hpp"
+#include "duckdb/parser/expression/operator_expression.hpp"
+#include "duckdb/parser/expression/subquery_expression.hpp"
+#include "duckdb/parser/tableref/basetableref.hpp"
+#include "duckdb/parser/tableref/expressionlistref.hpp"
+#include "duckdb/parser/tableref/joinref.hpp"
+#include "duckdb/parser/tableref/pivotref.hpp"
+#include "duckdb/parser/tableref/subqueryref.hpp"
+#include "duckdb/parser/tableref/table_function_ref.hpp"
+#include <algorithm>
+#include <unordered_set>
+#include <vector>
+
+namespace duckdb {
+
+class ComplexityWalker {
+public:
+    explicit ComplexityWalker(SqlComplexityResult &result) : result(result) {
+    }
+
+    void VisitQueryNode(const QueryNode &node, idx_t depth) {
+        if (!ExtractionBudget::Tick()) {
+            return;
+        }
+        result.node_count++;
+        result.max_depth = std::max(result.max_depth, depth);
+
+        // a CTE sees the CTEs defined before it, and itself only if it is recursive
+        auto scope_size = cte_scope.size();
+        for (const auto &cte : node.cte_map.map) {
+            result.cte_count++;
+            auto name = StringUtil::Lower(cte.first);
+            bool recursive = cte.second && cte.second->query && cte.second->query->node &&
+                             cte.second->query->node->type == QueryNodeType::RECURSIVE_CTE_NODE;
+            if (recursive) {
+                cte_scope.push_back(name);
+            }
+            if (cte.second && cte.second->query && cte.second->query->node) {
+                VisitQueryNode(*cte.second->query->node, depth + 1);
+            }
+            if (!recursive) {
+                cte_scope.push_back(name);
+            }
+        }
+
+        switch (node.type) {
+            case QueryNodeType::SELECT_NODE: {
+                auto &select_node = (SelectNode &)node;
+                if (select_node.from_table) {
+                    VisitTableRef(*select_node.from_table, depth);
+                }
+                VisitExpressionList(select_node.select_list, depth);
+                VisitPredicate(select_node.where_clause, depth);
+                VisitExpressionList(select_node.groups.group_expressions, depth);
+                VisitPredicate(select_node.having, depth);
+                VisitPredicate(select_node.qualify, depth);
+                break;
+            }
+            case QueryNodeType::SET_OPERATION_NODE: {
+                auto &setop_node = (SetOperationNode &)node;
+                VisitQueryNode(*setop_node.left, depth);
+                VisitQueryNode(*setop_node.right, depth);
+                break;
+            }
+            case QueryNodeType::RECURSIVE_CTE_NODE: {
+                auto &cte_node = (RecursiveCTENode &)node;
+                VisitQueryNode(*cte_node.left, depth);
+                VisitQueryNode(*cte_node.right, depth);
+                break;
+            }
+            case QueryNodeType::CTE_NODE: {
+                // the definition is also in the cte_map of the node, only the body is new
+                auto &cte_node = (CTENode &)node;
+                if (cte_node.child) {
+                    VisitQueryNode(*cte_node.child, depth);
+                }
+                break;
+            }
+            default:
+                break;
+        }
+
+        for (const auto &modifier : node.modifiers) {
+            switch (modifier->type) {
+                case ResultModifierType::ORDER_MODIFIER: {
+                    auto &order_modifier = (OrderModifier &)*modifier;
+                    for (const auto &order : order_modifier.orders) {
+                        VisitExpression(order.expression, depth);
+                    }
+                    break;
+                }
+                case ResultModifierType::LIMIT_MODIFIER: {
+                    auto &limit_modifier = (LimitModifier &)*modifier;
+                    VisitExpression(limit_modifier.limit, depth);
+                    VisitExpression(limit_modifier.offset, depth);
+                    break;
+                }
+                case ResultModifierType::DISTINCT_MODIFIER: {
+                    auto &distinct_modifier = (DistinctModifier &)*modifier;
+                    VisitExpressionList(distinct_modifier.distinct_on_targets, depth);
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+        cte_scope.resize(scope_size);
+    }
+
+    idx_t DistinctTables() const {
+        return tables.size();
+    }
+
+private:
+    void VisitTableRef(const TableRef &ref, idx_t depth) {
+        if (!ExtractionBudget::Tick()) {
+            return;
+        }
+        result.node_count++;
+
+        switch (ref.type) {
+            case TableReferenceType::BASE_TABLE: {
+                auto &base = (BaseTableRef &)ref;
+                if (base.schema_name.empty() && base.catalog_name.empty() && IsCTE(base.table_name)) {
+                    break;
+                }
+                // identifiers are case insensitive, t and main.T are the same table
+                tables.insert(StringUtil::Lower(base.catalog_name) + "." +
+                              StringUtil::Lower(base.schema_name.empty() ? "main" : base.schema_name) + "." +
+                              StringUtil::Lower(base.table_name));
+                break;
+            }
+            case TableReferenceType::JOIN: {
+                auto &join = (JoinRef &)ref;
+                result.join_count++;
+                VisitTableRef(*join.left, depth);
+                VisitTableRef(*join.right, depth);
+                VisitPredicate(join.condition, depth);
+                result.predicate_count += join.using_columns.size();
+                break;
+            }
+            case TableReferenceType::SUBQUERY: {
+                auto &subquery = (SubqueryRef &)ref;
+                result.subquery_count++;
+                if (subquery.subquery && subquery.subquery->node) {
+                    VisitQueryNode(*subquery.subquery->node, depth + 1);
+                }
+                break;
+            }
+            case TableReferenceType::TABLE_FUNCTION: {
+                auto &table_function = (TableFunctionRef &)ref;
+                VisitExpression(table_function.function, depth);
+                break;
+            }
+            case TableReferenceType::EXPRESSION_LIST: {
+                auto &values = (ExpressionListRef &)ref;
+                for (const auto &row : values.values) {
+                    VisitExpressionList(row, depth);
+                }
+                break;
+            }
+            case TableReferenceType::PIVOT: {
+                auto &pivot = (PivotRef &)ref;
+                if (pivot.source) {
+                    VisitTableRef(*pivot.source, depth);
+                }
+                VisitExpressionList(pivot.aggregates, depth);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    void VisitExpression(const ParsedExpression &expr, idx_t depth) {
+        if (!ExtractionBudget::Tick()) {
+            return;
+        }
+        result.node_count++;
+
+        switch (expr.GetExpressionClass()) {
+            case ExpressionClass::SUBQUERY: {
+                auto &subquery = (SubqueryExpression &)expr;
+                result.subquery_count++;
+                if (subquery.subquery && subquery.subquery->node) {
+                    VisitQueryNode(*subquery.subquery->node, depth + 1);
+                }
+                break;
+            }
+            case ExpressionClass::WINDOW:
+                result.window_count++;
+                break;
+            default:
+                break;
+        }
+
+        // the children of a subquery expression are only the left side of IN / ANY comparisons
+        ParsedExpressionIterator::EnumerateChildren(expr, [&](const ParsedExpression &child) {
+            VisitExpression(child, depth);
+        });
+    }
+
+    void VisitExpression(const unique_ptr<ParsedExpression> &expr, idx_t depth) {
+        if (expr) {
+            VisitExpression(*expr, depth);
+        }
+    }
+
+    void VisitExpressionList(const vector<unique_ptr<ParsedExpression>> &expressions, idx_t depth) {
+        for (const auto &expr : expressions) {
+            VisitExpression(expr, depth);
+        }
+    }
+
+    // A filter condition: its atoms are counted as predicates, then it is walked like any expression
+    void VisitPredicate(const unique_ptr<ParsedExpression> &expr, idx_t depth) {
+        if (!expr) {
+            return;
+        }
+        CountPredicates(*expr);
+        VisitExpression(*expr, depth);
+    }
+
+    void CountPredicates(const ParsedExpression &expr) {
+        if (expr.GetExpressionClass() == ExpressionClass::CONJUNCTION) {
+            auto &conjunction = (ConjunctionExpression &)expr;
+            for (const auto &child : conjunction.children) {
+                CountPredicates(*child);
+            }
+            return;
+        }
+        if (expr.GetExpressionType() == ExpressionType::OPERATOR_NOT) {
+            auto &not_expr = (OperatorExpression &)expr;
+            if (!not_expr.children.empty()) {
+                CountPredicates(*not_expr.children[0]);
+                return;
+            }
+        }
+        result.predicate_count++;
+    }
+
+    bool IsCTE(const std::string &name) const {
+        auto lower_name = StringUtil::Lower(name);
+        for (auto &cte : cte_scope) {
+            if (cte == lower_name) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    SqlComplexityResult &result;
+    std::vector<std::string> cte_scope;
+    std::unordered_set<std::string> tables;
+};
+
+bool ComputeSqlComplexity(const std::string &sql, SqlComplexityResult &result) {
+    if (!ExtractionBudget::AllowInput(sql)) {
+        return true;
+    }
+
+    Parser parser;
+
+    try {
+        parser.ParseQuery(sql);
+    } catch (const ParserException &ex) {
+        return false;
+    }
+
+    if (!ExtractionBudget::CheckDeadline()) {
+        return true;
+    }
+
+    ComplexityWalker walker(result);
+    for (auto &stmt : parser.statements) {
+        if (stmt->type == StatementType::SELECT_STATEMENT) {
+            auto &select_stmt = (SelectStatement &)*stmt;
+            if (select_stmt.node) {
+                walker.VisitQueryNode(*select_stmt.node, 1);
+            }
+        }
+    }
+    result.table_count = walker.DistinctTables();
+    return true;
+}
+
+static void SqlComplexityScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    auto &input = args.data[0];
+    auto count = args.size();
+    auto limits = ParserToolsLimits::Get(state.GetContext());
+
+    UnifiedVectorFormat input_data;
+    input.ToUnifiedFormat(count, input_data);
+    auto queries = UnifiedVectorFormat::GetData<string_t>(input_data);
+
+    // Get the fields in the STRUCT
+    auto &entries = StructVector::GetEntries(result);
+    auto node_count_data = FlatVector::GetData<int64_t>(*entries[0]);      // "node_count" field
+    auto max_depth_data = FlatVector::GetData<int32_t>(*entries[1]);       // "max_depth" field
+    auto join_count_data = FlatVector::GetData<int64_t>(*entries[2]);      // "join_count" field
+    auto subquery_count_data = FlatVector::GetData<int64_t>(*entries[3]);  // "subquery_count" field
+    auto cte_count_data = FlatVector::GetData<int64_t>(*entries[4]);       // "cte_count" field
+    auto window_count_data = FlatVector::GetData<int64_t>(*entries[5]);    // "window_count" field
+    auto table_count_data = FlatVector::GetData<int64_t>(*entries[6]);     // "table_count" field
+    auto predicate_count_data = FlatVector::GetData<int64_t>(*entries[7]); // "predicate_count" field
+
+    for (idx_t row = 0; row < count; row++) {
+        auto idx = input_data.sel->get_index(row);
+        if (!input_data.validity.RowIsValid(idx)) {
+            FlatVector::SetNull(result, row, true);
+            continue;
+        }
+
+        SqlComplexityResult complexity;
+        ExtractionBudget budget(limits);
+        bool parsed = ComputeSqlComplexity(queries[idx].GetString(), complexity);
+        if (!parsed || !budget.KeepResult("sql_complexity")) {
+            // NULL rather than all zeros, so unparsable queries are not mistaken for trivial ones
+            FlatVector::SetNull(result, row, true);
+            continue;
+        }
+
+        node_count_data[row] = (int64_t)complexity.node_count;
+        max_depth_data[row] = (int32_t)complexity.max_depth;
+        join_count_data[row] = (int64_t)complexity.join_count;
+        subquery_count_data[row] = (int64_t)complexity.subquery_count;
+        cte_count_data[row] = (int64_t)complexity.cte_count;
+        window_count_data[row] = (int64_t)complexity.window_count;
+        table_count_data[row] = (int64_t)complexity.table_count;
+        predicate_count_data[row] = (int64_t)complexity.predicate_count;
+    }
+
+    if (args.AllConstant()) {
+        result.SetVectorType(VectorType::CONSTANT_VECTOR);
+    }
+}
+
+// Extension scaffolding
+// ---------------------------------------------------
+
+void RegisterSqlComplexityFunction(DatabaseInstance &db) {
+    // sql_complexity returns cheap structural metrics of a query, e.g. to route heavy queries
+    auto return_type = LogicalType::STRUCT({
+        {"node_count", LogicalType::BIGINT},
+        {"max_depth", LogicalType::INTEGER},
+        {"join_count", LogicalType::BIGINT},
+        {"subquery_count", LogicalType::BIGINT},
+        {"cte_count", LogicalType::BIGINT},
+        {"window_count", LogicalType::BIGINT},
+        {"table_count", LogicalType::BIGINT},
+        {"predicate_count", LogicalType::BIGINT}
+    });
+    ScalarFunction sf("sql_complexity", {LogicalType::VARCHAR}, return_type, SqlComplexityScalarFunction);
+    ExtensionUtil::RegisterFunction(db, sf);
+}
+
+} // namespace duckdb
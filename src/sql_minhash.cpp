@@ -0,0 +1,347 @@
+#include "sql_minhash.hpp"
+#include "parse_tables.hpp"
+#include "parse_functions.hpp"
+#include "parse_where.hpp"
+#include "duckdb.hpp"
+#include "duckdb/common/case_insensitive_map.hpp"
+#include "duckdb/parser/parser.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+#include "duckdb/parser/query_node/select_node.hpp"
+#include "duckdb/parser/expression/columnref_expression.hpp"
+#include "duckdb/parser/expression/comparison_expression.hpp"
+#include "duckdb/parser/expression/conjunction_expression.hpp"
+#include "duckdb/parser/tableref/basetableref.hpp"
+#include "duckdb/parser/tableref/joinref.hpp"
+#include "duckdb/parser/tableref/subqueryref.hpp"
+#include "duckdb/main/extension_util.hpp"
+
+namespace duckdb {
+
+static constexpr int32_t MAX_MINHASH_SIZE = 1024;
+
+// Hashes are implemented locally (instead of using duckdb::Hash) so that signatures stay
+// stable across DuckDB versions and can be persisted and compared over time.
+static uint64_t HashFeature(const std::string &feature) {
+    uint64_t hash = 14695981039346656037ULL; // FNV-1a offset basis
+    for (auto c : feature) {
+        hash ^= (uint8_t)c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static uint64_t MixHash(uint64_t x) {
+    // splitmix64 finalizer
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+static void CollectAliases(const TableRef &ref, case_insensitive_map_t<string> &aliases) {
+    switch (ref.type) {
+        case TableReferenceType::BASE_TABLE: {
+            auto &base = (BaseTableRef &)ref;
+            aliases[base.alias.empty() ? base.table_name : base.alias] = base.table_name;
+            break;
+        }
+        case TableReferenceType::JOIN: {
+            auto &join = (JoinRef &)ref;
+            CollectAliases(*join.left, aliases);
+            CollectAliases(*join.right, aliases);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static string ResolveColumn(const ColumnRefExpression &column, const case_insensitive_map_t<string> &aliases) {
+    auto &qualifier = column.GetTableName();
+    auto entry = aliases.find(qualifier);
+    return (entry == aliases.end() ? qualifier : entry->second) + "." + column.GetColumnName();
+}
+
+static void ExtractJoinEdgesFromExpression(const ParsedExpression &expr,
+                                           const case_insensitive_map_t<string> &aliases,
+                                           std::set<std::string> &features) {
+    switch (expr.GetExpressionClass()) {
+        case ExpressionClass::CONJUNCTION: {
+            auto &conj = (ConjunctionExpression &)expr;
+            for (auto &child : conj.children) {
+                ExtractJoinEdgesFromExpression(*child, aliases, features);
+            }
+            break;
+        }
+        case ExpressionClass::COMPARISON: {
+            auto &comp = (ComparisonExpression &)expr;
+            if (comp.type != ExpressionType::COMPARE_EQUAL ||
+                comp.left->GetExpressionClass() != ExpressionClass::COLUMN_REF ||
+                comp.right->GetExpressionClass() != ExpressionClass::COLUMN_REF) {
+                break;
+            }
+            auto &left = (ColumnRefExpression &)*comp.left;
+            auto &right = (ColumnRefExpression &)*comp.right;
+            if (!left.IsQualified() || !right.IsQualified()) {
+                break;
+            }
+            auto left_name = ResolveColumn(left, aliases);
+            auto right_name = ResolveColumn(right, aliases);
+            // edges are undirected: a.x = b.y and b.y = a.x are the same feature
+            if (right_name < left_name) {
+                std::swap(left_name, right_name);
+            }
+            features.insert("j:" + left_name + "=" + right_name);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static void ExtractJoinEdgesFromQueryNode(const QueryNode &node, std::set<std::string> &features);
+
+static void ExtractJoinEdgesFromRef(const TableRef &ref,
+                                    const case_insensitive_map_t<string> &aliases,
+                                    std::set<std::string> &features) {
+    switch (ref.type) {
+        case TableReferenceType::JOIN: {
+            auto &join = (JoinRef &)ref;
+            ExtractJoinEdgesFromRef(*join.left, aliases, features);
+            ExtractJoinEdgesFromRef(*join.right, aliases, features);
+            if (join.condition) {
+                ExtractJoinEdgesFromExpression(*join.condition, aliases, features);
+            }
+            break;
+        }
+        case TableReferenceType::SUBQUERY: {
+            auto &subquery = (SubqueryRef &)ref;
+            if (subquery.subquery && subquery.subquery->node) {
+                ExtractJoinEdgesFromQueryNode(*subquery.subquery->node, features);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static void ExtractJoinEdgesFromQueryNode(const QueryNode &node, std::set<std::string> &features) {
+    if (node.type != QueryNodeType::SELECT_NODE) {
+        return;
+    }
+    auto &select_node = (SelectNode &)node;
+
+    for (const auto &cte : select_node.cte_map.map) {
+        if (cte.second && cte.second->query && cte.second->query->node) {
+            ExtractJoinEdgesFromQueryNode(*cte.second->query->node, features);
+        }
+    }
+
+    if (!select_node.from_table) {
+        return;
+    }
+    case_insensitive_map_t<string> aliases;
+    CollectAliases(*select_node.from_table, aliases);
+    ExtractJoinEdgesFromRef(*select_node.from_table, aliases, features);
+
+    // implicit joins: FROM a, b WHERE a.id = b.id
+    if (select_node.where_clause) {
+        ExtractJoinEdgesFromExpression(*select_node.where_clause, aliases, features);
+    }
+}
+
+void ExtractQueryFeatures(const std::string &sql, std::set<std::string> &features) {
+    Parser parser;
+
+    try {
+        parser.ParseQuery(sql);
+    } catch (const ParserException &ex) {
+        // swallow parser exceptions, an unparsable query has no features
+        return;
+    }
+
+    for (auto &stmt : parser.statements) {
+        if (stmt->type != StatementType::SELECT_STATEMENT) {
+            continue;
+        }
+        auto &select_stmt = (SelectStatement &)*stmt;
+        if (!select_stmt.node) {
+            continue;
+        }
+        auto &node = *select_stmt.node;
+
+        std::vector<TableRefResult> tables;
+        ExtractTablesFromQueryNode(node, tables);
+        for (auto &table : tables) {
+            if (table.context == TableContext::CTE || table.context == TableContext::FromCTE) {
+                continue;
+            }
+            features.insert("t:" + table.schema + "." + table.table);
+        }
+
+        std::vector<FunctionResult> functions;
+        ExtractFunctionsFromQueryNode(node, functions);
+        for (auto &function : functions) {
+            features.insert("f:" + function.function_name);
+        }
+
+        std::vector<DetailedWhereConditionResult> predicates;
+        ExtractDetailedWhereConditionsFromQueryNode(node, predicates);
+        for (auto &predicate : predicates) {
+            features.insert("p:" + predicate.column_name + " " + predicate.operator_type);
+        }
+
+        ExtractJoinEdgesFromQueryNode(node, features);
+    }
+}
+
+static void ComputeMinhash(const std::set<std::string> &features, idx_t k, uint64_t *signature) {
+    for (idx_t i = 0; i < k; i++) {
+        signature[i] = NumericLimits<uint64_t>::Maximum();
+    }
+    for (auto &feature : features) {
+        auto feature_hash = HashFeature(feature);
+        for (idx_t i = 0; i < k; i++) {
+            // each signature slot uses a differently seeded permutation of the feature hash
+            auto permuted = MixHash(feature_hash ^ MixHash(i));
+            if (permuted < signature[i]) {
+                signature[i] = permuted;
+            }
+        }
+    }
+}
+
+static void SqlMinhashScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    BinaryExecutor::Execute<string_t, int32_t, list_entry_t>(args.data[0], args.data[1], result, args.size(),
+    [&result](string_t query, int32_t k) -> list_entry_t {
+        if (k < 1 || k > MAX_MINHASH_SIZE) {
+            throw InvalidInputException("sql_minhash: k must be between 1 and %d, got %d", MAX_MINHASH_SIZE, k);
+        }
+
+        std::set<std::string> features;
+        ExtractQueryFeatures(query.GetString(), features);
+
+        auto current_size = ListVector::GetListSize(result);
+        // an empty feature set has no meaningful signature
+        auto signature_size = features.empty() ? 0 : (idx_t)k;
+        auto new_size = current_size + signature_size;
+
+        // grow list if needed
+        if (ListVector::GetListCapacity(result) < new_size) {
+            ListVector::Reserve(result, new_size);
+        }
+
+        auto signature = FlatVector::GetData<uint64_t>(ListVector::GetEntry(result));
+        if (signature_size > 0) {
+            ComputeMinhash(features, signature_size, signature + current_size);
+        }
+
+        // Update size
+        ListVector::SetListSize(result, new_size);
+
+        return list_entry_t(current_size, signature_size);
+    });
+}
+
+static void SqlMinhashBucketsScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    auto &signature_vector = args.data[0];
+    UnifiedVectorFormat signature_data;
+    ListVector::GetEntry(signature_vector).ToUnifiedFormat(ListVector::GetListSize(signature_vector), signature_data);
+    auto hashes = UnifiedVectorFormat::GetData<uint64_t>(signature_data);
+
+    BinaryExecutor::Execute<list_entry_t, int32_t, list_entry_t>(signature_vector, args.data[1], result, args.size(),
+    [&](list_entry_t signature, int32_t bands) -> list_entry_t {
+        if (bands < 1) {
+            throw InvalidInputException("sql_minhash_buckets: bands must be positive, got %d", bands);
+        }
+        if (signature.length % (idx_t)bands != 0) {
+            throw InvalidInputException("sql_minhash_buckets: signature length %llu is not divisible by %d bands",
+                                        signature.length, bands);
+        }
+        auto rows_per_band = signature.length / bands;
+        auto number_of_buckets = signature.length == 0 ? 0 : (idx_t)bands;
+
+        auto current_size = ListVector::GetListSize(result);
+        auto new_size = current_size + number_of_buckets;
+
+        // grow list if needed
+        if (ListVector::GetListCapacity(result) < new_size) {
+            ListVector::Reserve(result, new_size);
+        }
+
+        // each bucket id hashes the band number together with the band's rows, so two signatures
+        // share a bucket only when an entire band matches
+        auto buckets = FlatVector::GetData<uint64_t>(ListVector::GetEntry(result));
+        for (idx_t band = 0; band < number_of_buckets; band++) {
+            uint64_t bucket = MixHash(band);
+            for (idx_t row = 0; row < rows_per_band; row++) {
+                auto idx = signature_data.sel->get_index(signature.offset + band * rows_per_band + row);
+                bucket = MixHash(bucket ^ hashes[idx]);
+            }
+            buckets[current_size + band] = bucket;
+        }
+
+        // Update size
+        ListVector::SetListSize(result, new_size);
+
+        return list_entry_t(current_size, number_of_buckets);
+    });
+}
+
+static void SqlMinhashSimilarityScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    auto &left_vector = args.data[0];
+    auto &right_vector = args.data[1];
+
+    UnifiedVectorFormat left_data;
+    UnifiedVectorFormat right_data;
+    ListVector::GetEntry(left_vector).ToUnifiedFormat(ListVector::GetListSize(left_vector), left_data);
+    ListVector::GetEntry(right_vector).ToUnifiedFormat(ListVector::GetListSize(right_vector), right_data);
+    auto left_hashes = UnifiedVectorFormat::GetData<uint64_t>(left_data);
+    auto right_hashes = UnifiedVectorFormat::GetData<uint64_t>(right_data);
+
+    BinaryExecutor::Execute<list_entry_t, list_entry_t, double>(left_vector, right_vector, result, args.size(),
+    [&](list_entry_t left, list_entry_t right) -> double {
+        if (left.length != right.length) {
+            throw InvalidInputException("sql_minhash_similarity: signatures have different lengths (%llu and %llu)",
+                                        left.length, right.length);
+        }
+        if (left.length == 0) {
+            return 0.0;
+        }
+        // the fraction of matching slots estimates the Jaccard similarity of the feature sets
+        idx_t matches = 0;
+        for (idx_t i = 0; i < left.length; i++) {
+            auto left_idx = left_data.sel->get_index(left.offset + i);
+            auto right_idx = right_data.sel->get_index(right.offset + i);
+            if (left_hashes[left_idx] == right_hashes[right_idx]) {
+                matches++;
+            }
+        }
+        return (double)matches / (double)left.length;
+    });
+}
+
+// Extension scaffolding
+// ---------------------------------------------------
+
+void RegisterSqlMinhashFunctions(DatabaseInstance &db) {
+    // sql_minhash computes a MinHash signature of k slots over the structural features of a query
+    ScalarFunction minhash("sql_minhash", {LogicalType::VARCHAR, LogicalType::INTEGER},
+                           LogicalType::LIST(LogicalType::UBIGINT), SqlMinhashScalarFunction);
+    ExtensionUtil::RegisterFunction(db, minhash);
+
+    // sql_minhash_buckets splits a signature into LSH bands and returns one bucket id per band
+    // usage: join on unnest(sql_minhash_buckets(signature, bands)) to find candidate near-duplicates
+    ScalarFunction buckets("sql_minhash_buckets", {LogicalType::LIST(LogicalType::UBIGINT), LogicalType::INTEGER},
+                           LogicalType::LIST(LogicalType::UBIGINT), SqlMinhashBucketsScalarFunction);
+    ExtensionUtil::RegisterFunction(db, buckets);
+
+    // sql_minhash_similarity estimates the Jaccard similarity of two signatures
+    ScalarFunction similarity("sql_minhash_similarity",
+                              {LogicalType::LIST(LogicalType::UBIGINT), LogicalType::LIST(LogicalType::UBIGINT)},
+                              LogicalType::DOUBLE, SqlMinhashSimilarityScalarFunction);
+    ExtensionUtil::RegisterFunction(db, similarity);
+}
+
+} // namespace duckdb
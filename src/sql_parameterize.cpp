@@ -0,0 +1,314 @@
+#include "sql_parameterize.hpp"
+#include "duckdb.hpp"
+#include "duckdb/parser/parser.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+#include "duckdb/parser/statement/insert_statement.hpp"
+#include "duckdb/parser/statement/update_statement.hpp"
+#include "duckdb/parser/statement/delete_statement.hpp"
+#include "duckdb/parser/query_node/select_node.hpp"
+#include "duckdb/parser/query_node/set_operation_node.hpp"
+#include "duckdb/parser/query_node/recursive_cte_node.hpp"
+#include "duckdb/parser/query_node/cte_node.hpp"
+#include "duckdb/parser/expression/constant_expression.hpp"
+#include "duckdb/parser/expression/parameter_expression.hpp"
+#include "duckdb/parser/expression/subquery_expression.hpp"
+#include "duckdb/parser/parsed_expression_iterator.hpp"
+#include "duckdb/parser/result_modifier.hpp"
+#include "duckdb/parser/tableref/expressionlistref.hpp"
+#include "duckdb/parser/tableref/joinref.hpp"
+#include "duckdb/parser/tableref/subqueryref.hpp"
+#include "duckdb/main/extension_util.hpp"
+
+namespace duckdb {
+
+static void ParameterizeQueryNode(QueryNode &node, ParameterizedSQLResult &result);
+
+static void ParameterizeExpression(unique_ptr<ParsedExpression> &expr, ParameterizedSQLResult &result) {
+    if (!expr) {
+        return;
+    }
+
+    switch (expr->GetExpressionClass()) {
+        case ExpressionClass::CONSTANT: {
+            auto &constant = (ConstantExpression &)*expr;
+            // NULL literals carry no type information, binding them as parameters would fail
+            if (constant.value.IsNull()) {
+                return;
+            }
+            result.parameters.push_back(ParameterizedValue{
+                constant.value.type().ToString(),
+                constant.value.ToString()
+            });
+
+            auto parameter = make_uniq<ParameterExpression>();
+            parameter->identifier = std::to_string(result.parameters.size());
+            parameter->alias = constant.alias;
+            expr = std::move(parameter);
+            return;
+        }
+        case ExpressionClass::SUBQUERY: {
+            auto &subquery = (SubqueryExpression &)*expr;
+            if (subquery.subquery && subquery.subquery->node) {
+                ParameterizeQueryNode(*subquery.subquery->node, result);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    ParsedExpressionIterator::EnumerateChildren(*expr, [&](unique_ptr<ParsedExpression> &child) {
+        ParameterizeExpression(child, result);
+    });
+}
+
+// Positional references (ORDER BY 1, GROUP BY 2) are integer constants at the top level of the
+// expression; replacing them with a parameter would change the meaning of the query.
+static void ParameterizeNonPositionalExpression(unique_ptr<ParsedExpression> &expr, ParameterizedSQLResult &result) {
+    if (!expr || expr->GetExpressionClass() == ExpressionClass::CONSTANT) {
+        return;
+    }
+    ParameterizeExpression(expr, result);
+}
+
+static void ParameterizeTableRef(TableRef &ref, ParameterizedSQLResult &result) {
+    switch (ref.type) {
+        case TableReferenceType::JOIN: {
+            auto &join = (JoinRef &)ref;
+            ParameterizeTableRef(*join.left, result);
+            ParameterizeTableRef(*join.right, result);
+            ParameterizeExpression(join.condition, result);
+            break;
+        }
+        case TableReferenceType::SUBQUERY: {
+            auto &subquery = (SubqueryRef &)ref;
+            if (subquery.subquery && subquery.subquery->node) {
+                ParameterizeQueryNode(*subquery.subquery->node, result);
+            }
+            break;
+        }
+        case TableReferenceType::EXPRESSION_LIST: {
+            auto &values = (ExpressionListRef &)ref;
+            for (auto &row : values.values) {
+                for (auto &value : row) {
+                    ParameterizeExpression(value, result);
+                }
+            }
+            break;
+        }
+        default:
+            // table function arguments (read_csv('file.csv'), ...) must stay constant
+            break;
+    }
+}
+
+static void ParameterizeModifiers(QueryNode &node, ParameterizedSQLResult &result) {
+    for (auto &modifier : node.modifiers) {
+        switch (modifier->type) {
+            case ResultModifierType::ORDER_MODIFIER: {
+                auto &order_modifier = (OrderModifier &)*modifier;
+                for (auto &order : order_modifier.orders) {
+                    ParameterizeNonPositionalExpression(order.expression, result);
+                }
+                break;
+            }
+            case ResultModifierType::LIMIT_MODIFIER: {
+                auto &limit_modifier = (LimitModifier &)*modifier;
+                ParameterizeExpression(limit_modifier.limit, result);
+                ParameterizeExpression(limit_modifier.offset, result);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+static void ParameterizeQueryNode(QueryNode &node, ParameterizedSQLResult &result) {
+    for (auto &cte : node.cte_map.map) {
+        if (cte.second && cte.second->query && cte.second->query->node) {
+            ParameterizeQueryNode(*cte.second->query->node, result);
+        }
+    }
+
+    switch (node.type) {
+        case QueryNodeType::SELECT_NODE: {
+            auto &select_node = (SelectNode &)node;
+            for (auto &expr : select_node.select_list) {
+                ParameterizeExpression(expr, result);
+            }
+            if (select_node.from_table) {
+                ParameterizeTableRef(*select_node.from_table, result);
+            }
+            ParameterizeExpression(select_node.where_clause, result);
+            for (auto &group : select_node.groups.group_expressions) {
+                ParameterizeNonPositionalExpression(group, result);
+            }
+            ParameterizeExpression(select_node.having, result);
+            ParameterizeExpression(select_node.qualify, result);
+            break;
+        }
+        case QueryNodeType::SET_OPERATION_NODE: {
+            auto &setop_node = (SetOperationNode &)node;
+            ParameterizeQueryNode(*setop_node.left, result);
+            ParameterizeQueryNode(*setop_node.right, result);
+            break;
+        }
+        case QueryNodeType::RECURSIVE_CTE_NODE: {
+            auto &cte_node = (RecursiveCTENode &)node;
+            ParameterizeQueryNode(*cte_node.left, result);
+            ParameterizeQueryNode(*cte_node.right, result);
+            break;
+        }
+        case QueryNodeType::CTE_NODE: {
+            // the definition is also in the cte_map of the node, only the body is new
+            auto &cte_node = (CTENode &)node;
+            if (cte_node.child) {
+                ParameterizeQueryNode(*cte_node.child, result);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    // positional references and LIMIT are handled the same way for every kind of node
+    ParameterizeModifiers(node, result);
+}
+
+static bool ParameterizeStatement(SQLStatement &stmt, ParameterizedSQLResult &result) {
+    switch (stmt.type) {
+        case StatementType::SELECT_STATEMENT: {
+            auto &select_stmt = (SelectStatement &)stmt;
+            if (select_stmt.node) {
+                ParameterizeQueryNode(*select_stmt.node, result);
+            }
+            return true;
+        }
+        case StatementType::INSERT_STATEMENT: {
+            auto &insert_stmt = (InsertStatement &)stmt;
+            if (insert_stmt.select_statement && insert_stmt.select_statement->node) {
+                ParameterizeQueryNode(*insert_stmt.select_statement->node, result);
+            }
+            return true;
+        }
+        case StatementType::UPDATE_STATEMENT: {
+            auto &update_stmt = (UpdateStatement &)stmt;
+            if (update_stmt.from_table) {
+                ParameterizeTableRef(*update_stmt.from_table, result);
+            }
+            if (update_stmt.set_info) {
+                for (auto &expr : update_stmt.set_info->expressions) {
+                    ParameterizeExpression(expr, result);
+                }
+                ParameterizeExpression(update_stmt.set_info->condition, result);
+            }
+            return true;
+        }
+        case StatementType::DELETE_STATEMENT: {
+            auto &delete_stmt = (DeleteStatement &)stmt;
+            for (auto &using_clause : delete_stmt.using_clauses) {
+                ParameterizeTableRef(*using_clause, result);
+            }
+            ParameterizeExpression(delete_stmt.condition, result);
+            return true;
+        }
+        default:
+            // other statements (DDL, PRAGMA, ...) are passed through unchanged
+            return false;
+    }
+}
+
+bool ParameterizeSQL(const std::string &sql, ParameterizedSQLResult &result) {
+    Parser parser;
+
+    try {
+        parser.ParseQuery(sql);
+    } catch (const ParserException &ex) {
+        return false;
+    }
+
+    // parameters are numbered across the whole script so every statement can share one parameter list
+    for (auto &stmt : parser.statements) {
+        ParameterizeStatement(*stmt, result);
+        if (!result.sql.empty()) {
+            result.sql += "; ";
+        }
+        result.sql += stmt->ToString();
+    }
+    return true;
+}
+
+static void SqlParameterizeScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    auto count = args.size();
+
+    UnifiedVectorFormat input_data;
+    args.data[0].ToUnifiedFormat(count, input_data);
+    auto inputs = UnifiedVectorFormat::GetData<string_t>(input_data);
+
+    // Get the fields in the STRUCT
+    auto &entries = StructVector::GetEntries(result);
+    auto &sql_entry = *entries[0];        // "sql" field
+    auto &parameters_entry = *entries[1]; // "parameters" field
+
+    auto sql_data = FlatVector::GetData<string_t>(sql_entry);
+    auto parameters_data = FlatVector::GetData<list_entry_t>(parameters_entry);
+
+    for (idx_t row = 0; row < count; row++) {
+        auto input_idx = input_data.sel->get_index(row);
+        ParameterizedSQLResult parameterized;
+        if (!input_data.validity.RowIsValid(input_idx) ||
+            !ParameterizeSQL(inputs[input_idx].GetString(), parameterized)) {
+            FlatVector::SetNull(result, row, true);
+            continue;
+        }
+
+        sql_data[row] = StringVector::AddStringOrBlob(sql_entry, parameterized.sql);
+
+        auto current_size = ListVector::GetListSize(parameters_entry);
+        auto number_of_parameters = parameterized.parameters.size();
+        auto new_size = current_size + number_of_parameters;
+
+        // Grow list vector if needed
+        if (ListVector::GetListCapacity(parameters_entry) < new_size) {
+            ListVector::Reserve(parameters_entry, new_size);
+        }
+
+        auto &parameter_vector = ListVector::GetEntry(parameters_entry);
+        auto &parameter_entries = StructVector::GetEntries(parameter_vector);
+        auto &type_entry = *parameter_entries[0];  // "type" field
+        auto &value_entry = *parameter_entries[1]; // "value" field
+
+        auto type_data = FlatVector::GetData<string_t>(type_entry);
+        auto value_data = FlatVector::GetData<string_t>(value_entry);
+
+        for (size_t i = 0; i < number_of_parameters; i++) {
+            const auto &parameter = parameterized.parameters[i];
+            auto idx = current_size + i;
+
+            type_data[idx] = StringVector::AddStringOrBlob(type_entry, parameter.type);
+            value_data[idx] = StringVector::AddStringOrBlob(value_entry, parameter.value);
+        }
+
+        ListVector::SetListSize(parameters_entry, new_size);
+        parameters_data[row] = list_entry_t(current_size, number_of_parameters);
+    }
+}
+
+// Extension scaffolding
+// ---------------------------------------------------
+
+void RegisterSqlParameterizeFunction(DatabaseInstance &db) {
+    // sql_parameterize returns the SQL with literals replaced by $n along with the extracted values
+    auto return_type = LogicalType::STRUCT({
+        {"sql", LogicalType::VARCHAR},
+        {"parameters", LogicalType::LIST(LogicalType::STRUCT({
+            {"type", LogicalType::VARCHAR},
+            {"value", LogicalType::VARCHAR}
+        }))}
+    });
+    ScalarFunction sf("sql_parameterize", {LogicalType::VARCHAR}, return_type, SqlParameterizeScalarFunction);
+    ExtensionUtil::RegisterFunction(db, sf);
+}
+
+} // namespace duckdb
@@ -0,0 +1,425 @@
+#include "sql_rewrite_tables.hpp"
+#include "parser_tools_limits.hpp"
+#include "sql_scanner.hpp"
+#include "duckdb.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include "duckdb/parser/parser.hpp"
+#include "duckdb/parser/parsed_expression_iterator.hpp"
+#include "duckdb/parser/expression/subquery_expression.hpp"
+#include "duckdb/parser/query_node/select_node.hpp"
+#include "duckdb/parser/query_node/set_operation_node.hpp"
+#include "duckdb/parser/query_node/recursive_cte_node.hpp"
+#include "duckdb/parser/query_node/cte_node.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+#include "duckdb/parser/statement/insert_statement.hpp"
+#include "duckdb/parser/statement/update_statement.hpp"
+#include "duckdb/parser/statement/delete_statement.hpp"
+#include "duckdb/parser/tableref/basetableref.hpp"
+#include "duckdb/parser/tableref/expressionlistref.hpp"
+#include "duckdb/parser/tableref/joinref.hpp"
+#include "duckdb/parser/tableref/pivotref.hpp"
+#include "duckdb/parser/tableref/subqueryref.hpp"
+#include "duckdb/parser/tableref/table_function_ref.hpp"
+
+namespace duckdb {
+
+// Rewrite map
+// ---------------------------------------------------
+
+static QualifiedName ParseTableName(const std::string &name) {
+    QualifiedName result;
+    try {
+        result = QualifiedName::Parse(name);
+    } catch (const ParserException &ex) {
+        throw InvalidInputException("sql_rewrite_tables: invalid table name \"%s\"", name);
+    }
+    if (result.name.empty()) {
+        throw InvalidInputException("sql_rewrite_tables: invalid table name \"%s\"", name);
+    }
+    return result;
+}
+
+void TableRewriteMap::Add(const std::string &from, const std::string &to) {
+    Entry entry {ParseTableName(from), ParseTableName(to)};
+    by_name[StringUtil::Lower(entry.from.name)].push_back(std::move(entry));
+}
+
+const QualifiedName *TableRewriteMap::Find(const BaseTableRef &ref) const {
+    auto entries = by_name.find(StringUtil::Lower(ref.table_name));
+    if (entries == by_name.end()) {
+        return nullptr;
+    }
+    auto schema = ref.schema_name.empty() ? std::string("main") : ref.schema_name;
+
+    const QualifiedName *best = nullptr;
+    int best_parts = -1;
+    for (auto &entry : entries->second) {
+        if (!entry.from.catalog.empty() && !StringUtil::CIEquals(entry.from.catalog, ref.catalog_name)) {
+            continue;
+        }
+        if (!entry.from.schema.empty() && !StringUtil::CIEquals(entry.from.schema, schema)) {
+            continue;
+        }
+        int parts = (entry.from.catalog.empty() ? 0 : 1) + (entry.from.schema.empty() ? 0 : 1);
+        if (parts > best_parts) {
+            best = &entry.to;
+            best_parts = parts;
+        }
+    }
+    return best;
+}
+
+bool TableRewriteMap::MayMatch(const std::string &sql) const {
+    SqlScanner scanner(sql);
+    SqlToken token;
+    while (scanner.Next(token)) {
+        if (token.type != SqlTokenType::Identifier && token.type != SqlTokenType::QuotedIdentifier) {
+            continue;
+        }
+        if (by_name.find(StringUtil::Lower(scanner.IdentifierName(token))) != by_name.end()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Rewriting
+// ---------------------------------------------------
+
+class TableRewriter {
+public:
+    explicit TableRewriter(const TableRewriteMap &map) : map(map) {
+    }
+
+    // Returns false if the statement type is passed through unchanged
+    bool RewriteStatement(SQLStatement &stmt) {
+        auto scope_size = cte_scope.size();
+        switch (stmt.type) {
+            case StatementType::SELECT_STATEMENT: {
+                auto &select_stmt = (SelectStatement &)stmt;
+                RewriteQueryNode(select_stmt.node);
+                break;
+            }
+            case StatementType::INSERT_STATEMENT: {
+                // the target of a write is never redirected, only what the statement reads
+                auto &insert_stmt = (InsertStatement &)stmt;
+                RewriteCTEMap(insert_stmt.cte_map);
+                if (insert_stmt.select_statement) {
+                    RewriteQueryNode(insert_stmt.select_statement->node);
+                }
+                break;
+            }
+            case StatementType::UPDATE_STATEMENT: {
+                auto &update_stmt = (UpdateStatement &)stmt;
+                RewriteCTEMap(update_stmt.cte_map);
+                RewriteTableRef(update_stmt.from_table);
+                if (update_stmt.set_info) {
+                    for (auto &expr : update_stmt.set_info->expressions) {
+                        RewriteExpression(expr);
+                    }
+                    RewriteExpression(update_stmt.set_info->condition);
+                }
+                break;
+            }
+            case StatementType::DELETE_STATEMENT: {
+                auto &delete_stmt = (DeleteStatement &)stmt;
+                RewriteCTEMap(delete_stmt.cte_map);
+                for (auto &using_clause : delete_stmt.using_clauses) {
+                    RewriteTableRef(using_clause);
+                }
+                RewriteExpression(delete_stmt.condition);
+                break;
+            }
+            default:
+                return false;
+        }
+        cte_scope.resize(scope_size);
+        return true;
+    }
+
+    idx_t rewritten = 0;
+
+private:
+    // A CTE sees the CTEs defined before it, and itself only if it is recursive. The names stay in
+    // scope until the caller restores the scope size.
+    void RewriteCTEMap(CommonTableExpressionMap &cte_map) {
+        for (auto &cte : cte_map.map) {
+            auto name = StringUtil::Lower(cte.first);
+            bool recursive = cte.second && cte.second->query && cte.second->query->node &&
+                             cte.second->query->node->type == QueryNodeType::RECURSIVE_CTE_NODE;
+            if (recursive) {
+                cte_scope.push_back(name);
+            }
+            if (cte.second && cte.second->query) {
+                RewriteQueryNode(cte.second->query->node);
+            }
+            if (!recursive) {
+                cte_scope.push_back(name);
+            }
+        }
+    }
+
+    void RewriteQueryNode(unique_ptr<QueryNode> &node) {
+        if (!node || !ExtractionBudget::Tick()) {
+            return;
+        }
+        auto scope_size = cte_scope.size();
+        RewriteCTEMap(node->cte_map);
+
+        switch (node->type) {
+            case QueryNodeType::SELECT_NODE: {
+                auto &select_node = (SelectNode &)*node;
+                RewriteTableRef(select_node.from_table);
+                for (auto &expr : select_node.select_list) {
+                    RewriteExpression(expr);
+                }
+                RewriteExpression(select_node.where_clause);
+                for (auto &expr : select_node.groups.group_expressions) {
+                    RewriteExpression(expr);
+                }
+                RewriteExpression(select_node.having);
+                RewriteExpression(select_node.qualify);
+                break;
+            }
+            case QueryNodeType::SET_OPERATION_NODE: {
+                auto &setop_node = (SetOperationNode &)*node;
+                RewriteQueryNode(setop_node.left);
+                RewriteQueryNode(setop_node.right);
+                break;
+            }
+            case QueryNodeType::RECURSIVE_CTE_NODE: {
+                auto &cte_node = (RecursiveCTENode &)*node;
+                RewriteQueryNode(cte_node.left);
+                RewriteQueryNode(cte_node.right);
+                break;
+            }
+            case QueryNodeType::CTE_NODE: {
+                // the definition is also in the cte_map of the node, rewriting it twice could chain
+                // mappings (a -> b, b -> c)
+                auto &cte_node = (CTENode &)*node;
+                RewriteQueryNode(cte_node.child);
+                break;
+            }
+            default:
+                break;
+        }
+
+        ParsedExpressionIterator::EnumerateQueryNodeModifiers(*node, [&](unique_ptr<ParsedExpression> &child) {
+            RewriteExpression(child);
+        });
+        cte_scope.resize(scope_size);
+    }
+
+    void RewriteTableRef(unique_ptr<TableRef> &ref) {
+        if (!ref || !ExtractionBudget::Tick()) {
+            return;
+        }
+        switch (ref->type) {
+            case TableReferenceType::BASE_TABLE:
+                RewriteBaseTable((BaseTableRef &)*ref);
+                break;
+            case TableReferenceType::JOIN: {
+                auto &join = (JoinRef &)*ref;
+                RewriteTableRef(join.left);
+                RewriteTableRef(join.right);
+                RewriteExpression(join.condition);
+                break;
+            }
+            case TableReferenceType::SUBQUERY: {
+                auto &subquery = (SubqueryRef &)*ref;
+                if (subquery.subquery) {
+                    RewriteQueryNode(subquery.subquery->node);
+                }
+                break;
+            }
+            case TableReferenceType::TABLE_FUNCTION: {
+                auto &table_function = (TableFunctionRef &)*ref;
+                RewriteExpression(table_function.function);
+                break;
+            }
+            case TableReferenceType::EXPRESSION_LIST: {
+                auto &values = (ExpressionListRef &)*ref;
+                for (auto &row : values.values) {
+                    for (auto &value : row) {
+                        RewriteExpression(value);
+                    }
+                }
+                break;
+            }
+            case TableReferenceType::PIVOT: {
+                auto &pivot = (PivotRef &)*ref;
+                RewriteTableRef(pivot.source);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    void RewriteBaseTable(BaseTableRef &base) {
+        if (base.catalog_name.empty() && base.schema_name.empty() && IsCTE(base.table_name)) {
+            return;
+        }
+        auto target = map.Find(base);
+        if (!target) {
+            return;
+        }
+        // keep column references qualified with the old name (orders.id) working
+        if (base.alias.empty()) {
+            base.alias = base.table_name;
+        }
+        base.catalog_name = target->catalog;
+        base.schema_name = target->schema;
+        base.table_name = target->name;
+        rewritten++;
+    }
+
+    void RewriteExpression(unique_ptr<ParsedExpression> &expr) {
+        if (!expr || !ExtractionBudget::Tick()) {
+            return;
+        }
+        if (expr->GetExpressionClass() == ExpressionClass::SUBQUERY) {
+            auto &subquery = (SubqueryExpression &)*expr;
+            if (subquery.subquery) {
+                RewriteQueryNode(subquery.subquery->node);
+            }
+        }
+        ParsedExpressionIterator::EnumerateChildren(*expr, [&](unique_ptr<ParsedExpression> &child) {
+            RewriteExpression(child);
+        });
+    }
+
+    bool IsCTE(const std::string &name) const {
+        auto lower_name = StringUtil::Lower(name);
+        for (auto &cte : cte_scope) {
+            if (cte == lower_name) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const TableRewriteMap &map;
+    std::vector<std::string> cte_scope;
+};
+
+bool RewriteTablesInSQL(const std::string &sql, const TableRewriteMap &map, std::string &result) {
+    // most queries of a workload reference none of the mapped tables, they are never parsed
+    if (map.Empty() || !ExtractionBudget::AllowInput(sql) || !map.MayMatch(sql)) {
+        return false;
+    }
+
+    Parser parser;
+
+    try {
+        parser.ParseQuery(sql);
+    } catch (const ParserException &ex) {
+        return false;
+    }
+
+    if (!ExtractionBudget::CheckDeadline()) {
+        return false;
+    }
+
+    TableRewriter rewriter(map);
+    for (auto &stmt : parser.statements) {
+        rewriter.RewriteStatement(*stmt);
+    }
+    if (rewriter.rewritten == 0) {
+        return false;
+    }
+
+    result.clear();
+    for (auto &stmt : parser.statements) {
+        if (!result.empty()) {
+            result += "; ";
+        }
+        result += stmt->ToString();
+    }
+    return true;
+}
+
+static void BuildRewriteMap(const Value &mapping, TableRewriteMap &map) {
+    for (auto &entry : MapValue::GetChildren(mapping)) {
+        auto &key_value = StructValue::GetChildren(entry);
+        if (key_value[0].IsNull() || key_value[1].IsNull()) {
+            continue;
+        }
+        map.Add(StringValue::Get(key_value[0]), StringValue::Get(key_value[1]));
+    }
+}
+
+static void SqlRewriteTablesScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    auto &input = args.data[0];
+    auto &mapping = args.data[1];
+    auto count = args.size();
+    auto limits = ParserToolsLimits::Get(state.GetContext());
+
+    UnifiedVectorFormat input_data;
+    input.ToUnifiedFormat(count, input_data);
+    auto queries = UnifiedVectorFormat::GetData<string_t>(input_data);
+
+    // the mapping is almost always a constant, it is then converted only once per chunk
+    bool constant_mapping = mapping.GetVectorType() == VectorType::CONSTANT_VECTOR;
+    bool constant_mapping_null = false;
+    TableRewriteMap constant_map;
+    if (constant_mapping) {
+        auto mapping_value = mapping.GetValue(0);
+        constant_mapping_null = mapping_value.IsNull();
+        if (!constant_mapping_null) {
+            BuildRewriteMap(mapping_value, constant_map);
+        }
+    }
+
+    auto result_data = FlatVector::GetData<string_t>(result);
+    for (idx_t row = 0; row < count; row++) {
+        auto idx = input_data.sel->get_index(row);
+        if (!input_data.validity.RowIsValid(idx) || constant_mapping_null) {
+            FlatVector::SetNull(result, row, true);
+            continue;
+        }
+
+        TableRewriteMap row_map;
+        if (!constant_mapping) {
+            auto mapping_value = mapping.GetValue(row);
+            if (mapping_value.IsNull()) {
+                FlatVector::SetNull(result, row, true);
+                continue;
+            }
+            BuildRewriteMap(mapping_value, row_map);
+        }
+        auto &map = constant_mapping ? constant_map : row_map;
+
+        std::string rewritten;
+        ExtractionBudget budget(limits);
+        bool changed = RewriteTablesInSQL(queries[idx].GetString(), map, rewritten);
+        if (!budget.KeepResult("sql_rewrite_tables")) {
+            FlatVector::SetNull(result, row, true);
+            continue;
+        }
+        // a partially rewritten query would silently mix copies and originals
+        if (changed && !budget.Exceeded()) {
+            result_data[row] = StringVector::AddString(result, rewritten);
+        } else {
+            result_data[row] = StringVector::AddString(result, queries[idx]);
+        }
+    }
+
+    if (args.AllConstant()) {
+        result.SetVectorType(VectorType::CONSTANT_VECTOR);
+    }
+}
+
+// Extension scaffolding
+// ---------------------------------------------------
+
+void RegisterSqlRewriteTablesFunction(DatabaseInstance &db) {
+    // sql_rewrite_tables redirects table references, e.g. to pre-aggregated or locally cached copies
+    ScalarFunction sf("sql_rewrite_tables",
+                      {LogicalType::VARCHAR, LogicalType::MAP(LogicalType::VARCHAR, LogicalType::VARCHAR)},
+                      LogicalType::VARCHAR, SqlRewriteTablesScalarFunction);
+    ExtensionUtil::RegisterFunction(db, sf);
+}
+
+} // namespace duckdb
@@ -0,0 +1,488 @@
+#include "sql_scanner.hpp"
+#include "duckdb.hpp"
+#include "duckdb/common/string_util.hpp"
+#include <cctype>
+#include <cstring>
+
+namespace duckdb {
+
+// Scanner
+// ---------------------------------------------------
+
+static bool IsIdentifierStart(char c) {
+    return std::isalpha((unsigned char)c) || c == '_' || (unsigned char)c >= 0x80;
+}
+
+static bool IsIdentifierChar(char c) {
+    return std::isalnum((unsigned char)c) || c == '_' || c == '$' || (unsigned char)c >= 0x80;
+}
+
+void SqlScanner::SkipWhitespaceAndComments() {
+    auto size = sql.size();
+    while (position < size) {
+        auto c = sql[position];
+        if (std::isspace((unsigned char)c)) {
+            position++;
+        } else if (c == '-' && position + 1 < size && sql[position + 1] == '-') {
+            while (position < size && sql[position] != '\n') {
+                position++;
+            }
+        } else if (c == '/' && position + 1 < size && sql[position + 1] == '*') {
+            // block comments nest in postgres syntax
+            idx_t depth = 0;
+            while (position < size) {
+                if (sql[position] == '/' && position + 1 < size && sql[position + 1] == '*') {
+                    depth++;
+                    position += 2;
+                } else if (sql[position] == '*' && position + 1 < size && sql[position + 1] == '/') {
+                    depth--;
+                    position += 2;
+                    if (depth == 0) {
+                        break;
+                    }
+                } else {
+                    position++;
+                }
+            }
+        } else {
+            return;
+        }
+    }
+}
+
+void SqlScanner::ScanQuoted(char quote, bool backslash_escapes) {
+    // position is on the opening quote; a doubled quote is an escaped quote
+    auto size = sql.size();
+    position++;
+    while (position < size) {
+        auto c = sql[position];
+        if (backslash_escapes && c == '\\') {
+            position += 2;
+        } else if (c == quote) {
+            if (position + 1 < size && sql[position + 1] == quote) {
+                position += 2;
+            } else {
+                position++;
+                return;
+            }
+        } else {
+            position++;
+        }
+    }
+    position = size;
+}
+
+bool SqlScanner::Next(SqlToken &token) {
+    SkipWhitespaceAndComments();
+    auto size = sql.size();
+    if (position >= size) {
+        return false;
+    }
+
+    token.start = position;
+    auto c = sql[position];
+    if (c == '\'') {
+        token.type = SqlTokenType::String;
+        ScanQuoted('\'', false);
+    } else if (c == '"') {
+        token.type = SqlTokenType::QuotedIdentifier;
+        ScanQuoted('"', false);
+    } else if (IsIdentifierStart(c)) {
+        // E'...', X'...' and B'...' are string literals with a prefix
+        if (position + 1 < size && sql[position + 1] == '\'' && std::strchr("eExXbB", c)) {
+            token.type = SqlTokenType::String;
+            position++;
+            ScanQuoted('\'', c == 'e' || c == 'E');
+        } else {
+            token.type = SqlTokenType::Identifier;
+            while (position < size && IsIdentifierChar(sql[position])) {
+                position++;
+            }
+        }
+    } else if (std::isdigit((unsigned char)c) ||
+               (c == '.' && position + 1 < size && std::isdigit((unsigned char)sql[position + 1]))) {
+        token.type = SqlTokenType::Number;
+        while (position < size) {
+            auto n = sql[position];
+            if (std::isalnum((unsigned char)n) || n == '.' || n == '_') {
+                position++;
+            } else if ((n == '+' || n == '-') && (sql[position - 1] == 'e' || sql[position - 1] == 'E')) {
+                position++;
+            } else {
+                break;
+            }
+        }
+    } else if (c == '$') {
+        // $1 is a parameter, $tag$ ... $tag$ is a dollar-quoted string
+        auto tag_end = position + 1;
+        while (tag_end < size && IsIdentifierChar(sql[tag_end]) && sql[tag_end] != '$') {
+            tag_end++;
+        }
+        if (tag_end < size && sql[tag_end] == '$' &&
+            (tag_end == position + 1 || !std::isdigit((unsigned char)sql[position + 1]))) {
+            auto tag_length = tag_end - position + 1;
+            auto close = sql.find(sql.c_str() + position, tag_end + 1, tag_length);
+            token.type = SqlTokenType::String;
+            position = close == std::string::npos ? size : close + tag_length;
+        } else {
+            token.type = SqlTokenType::Parameter;
+            position = tag_end;
+        }
+    } else if (c == '?') {
+        token.type = SqlTokenType::Parameter;
+        position++;
+    } else if (c == '(') {
+        token.type = SqlTokenType::LeftParen;
+        position++;
+    } else if (c == ')') {
+        token.type = SqlTokenType::RightParen;
+        position++;
+    } else if (c == ',') {
+        token.type = SqlTokenType::Comma;
+        position++;
+    } else if (c == ';') {
+        token.type = SqlTokenType::Semicolon;
+        position++;
+    } else {
+        // operators are not interpreted, "::" is kept together so a cast is a single token
+        token.type = SqlTokenType::Operator;
+        position += (c == ':' && position + 1 < size && sql[position + 1] == ':') ? 2 : 1;
+    }
+    token.length = position - token.start;
+    return true;
+}
+
+bool StatementCursor::Next(std::string &statement) {
+    SqlToken token;
+    idx_t start = scanner.Position();
+    bool has_tokens = false;
+    while (scanner.Next(token)) {
+        if (token.type != SqlTokenType::Semicolon) {
+            has_tokens = true;
+            continue;
+        }
+        if (has_tokens) {
+            statement = sql.substr(start, token.start - start);
+            return true;
+        }
+        start = scanner.Position();
+    }
+    if (has_tokens) {
+        statement = sql.substr(start);
+        return true;
+    }
+    return false;
+}
+
+bool StatementCursor::Next(idx_t &start, idx_t &end) {
+    SqlToken token;
+    bool has_tokens = false;
+    while (scanner.Next(token)) {
+        if (token.type != SqlTokenType::Semicolon) {
+            if (!has_tokens) {
+                start = token.start;
+                has_tokens = true;
+            }
+            end = token.start + token.length;
+            continue;
+        }
+        if (has_tokens) {
+            return true;
+        }
+    }
+    return has_tokens;
+}
+
+bool SqlScanner::IsKeyword(const SqlToken &token, const char *keyword) const {
+    if (token.type != SqlTokenType::Identifier || token.length != std::strlen(keyword)) {
+        return false;
+    }
+    for (idx_t i = 0; i < token.length; i++) {
+        if (std::tolower((unsigned char)sql[token.start + i]) != keyword[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SqlScanner::IsSymbol(const SqlToken &token, char symbol) const {
+    return token.type == SqlTokenType::Operator && token.length == 1 && sql[token.start] == symbol;
+}
+
+std::string SqlScanner::IdentifierName(const SqlToken &token) const {
+    if (token.type != SqlTokenType::QuotedIdentifier) {
+        return sql.substr(token.start, token.length);
+    }
+    auto quoted = sql.substr(token.start + 1, token.length >= 2 ? token.length - 2 : 0);
+    return StringUtil::Replace(quoted, "\"\"", "\"");
+}
+
+// Literal lists
+// ---------------------------------------------------
+
+struct ParenthesizedList {
+    idx_t first_item_end = 0; // offset just past the first item
+    idx_t close = 0;          // offset of the closing parenthesis
+    idx_t items = 0;
+    idx_t literals = 0;
+    bool literal_only = true;
+};
+
+static bool IsLiteralToken(const SqlScanner &scanner, const SqlToken &token) {
+    switch (token.type) {
+        case SqlTokenType::String:
+        case SqlTokenType::Number:
+            return true;
+        case SqlTokenType::Identifier:
+            return scanner.IsKeyword(token, "null") || scanner.IsKeyword(token, "true") ||
+                   scanner.IsKeyword(token, "false");
+        default:
+            return false;
+    }
+}
+
+// Reads a parenthesized list, the opening parenthesis has already been consumed. An item is a
+// literal if it is a single literal token, optionally preceded by a sign.
+static bool ScanParenthesizedList(SqlScanner &scanner, ParenthesizedList &list) {
+    SqlToken token;
+    idx_t depth = 1;
+    idx_t item_tokens = 0;
+    bool item_literal = true;
+    bool item_signed = false;
+    auto finish_item = [&]() {
+        if (item_tokens == 0 || item_signed) {
+            list.literal_only = false;
+        } else if (item_literal) {
+            list.literals++;
+        } else {
+            list.literal_only = false;
+        }
+        list.items++;
+        item_tokens = 0;
+        item_literal = true;
+        item_signed = false;
+    };
+
+    while (scanner.Next(token)) {
+        if (token.type == SqlTokenType::LeftParen) {
+            depth++;
+            item_tokens++;
+            item_literal = false;
+        } else if (token.type == SqlTokenType::RightParen) {
+            if (--depth == 0) {
+                if (list.items == 0) {
+                    list.first_item_end = token.start;
+                }
+                finish_item();
+                list.close = token.start;
+                return true;
+            }
+            item_tokens++;
+        } else if (token.type == SqlTokenType::Comma && depth == 1) {
+            if (list.items == 0) {
+                list.first_item_end = token.start;
+            }
+            finish_item();
+        } else if (token.type == SqlTokenType::Semicolon) {
+            return false;
+        } else {
+            if (item_tokens == 0 && (scanner.IsSymbol(token, '-') || scanner.IsSymbol(token, '+'))) {
+                item_signed = true;
+            } else if (item_tokens == 0 || (item_signed && item_tokens == 1 && token.type == SqlTokenType::Number)) {
+                item_literal = item_literal && IsLiteralToken(scanner, token);
+                item_signed = false;
+            } else {
+                item_literal = false;
+            }
+            item_tokens++;
+        }
+    }
+    return false;
+}
+
+// Peeks for ", (" following a VALUES row, consuming both tokens if found
+static bool NextValuesRow(SqlScanner &scanner) {
+    auto saved = scanner.Position();
+    SqlToken token;
+    if (scanner.Next(token) && token.type == SqlTokenType::Comma && scanner.Next(token) &&
+        token.type == SqlTokenType::LeftParen) {
+        return true;
+    }
+    scanner.Reset(saved);
+    return false;
+}
+
+bool CompactLiteralLists(const std::string &sql, std::string &compacted) {
+    SqlScanner scanner(sql);
+    SqlToken token;
+    std::string output;
+    idx_t copied = 0;
+    bool changed = false;
+
+    // drops sql[from, to) from the output
+    auto skip = [&](idx_t from, idx_t to) {
+        if (!changed) {
+            output.reserve(sql.size() / 4);
+            changed = true;
+        }
+        output.append(sql, copied, from - copied);
+        copied = to;
+    };
+
+    while (scanner.Next(token)) {
+        if (scanner.IsKeyword(token, "values")) {
+            SqlToken open;
+            if (!scanner.Next(open) || open.type != SqlTokenType::LeftParen) {
+                continue;
+            }
+            ParenthesizedList first_row;
+            if (!ScanParenthesizedList(scanner, first_row)) {
+                break;
+            }
+            // the first row is always kept so the statement still has the same shape, later rows are
+            // dropped when they hold nothing but literals
+            auto row_end = first_row.close + 1;
+            while (NextValuesRow(scanner)) {
+                ParenthesizedList row;
+                if (!ScanParenthesizedList(scanner, row)) {
+                    break;
+                }
+                if (row.literal_only) {
+                    skip(row_end, row.close + 1);
+                }
+                row_end = row.close + 1;
+            }
+        } else if (scanner.IsKeyword(token, "in")) {
+            auto saved = scanner.Position();
+            SqlToken open;
+            if (!scanner.Next(open) || open.type != SqlTokenType::LeftParen) {
+                scanner.Reset(saved);
+                continue;
+            }
+            ParenthesizedList list;
+            if (!ScanParenthesizedList(scanner, list)) {
+                break;
+            }
+            if (list.literal_only && list.items > 1) {
+                skip(list.first_item_end, list.close);
+            } else if (!list.literal_only) {
+                // the list may hold a subquery, scan its contents as well
+                scanner.Reset(open.start + 1);
+            }
+        }
+    }
+
+    if (!changed) {
+        return false;
+    }
+    output.append(sql, copied, std::string::npos);
+    compacted = std::move(output);
+    return true;
+}
+
+// INSERT ... VALUES
+// ---------------------------------------------------
+
+// Skips to the token after the next top-level semicolon
+static void SkipStatement(SqlScanner &scanner) {
+    SqlToken token;
+    idx_t depth = 0;
+    while (scanner.Next(token)) {
+        if (token.type == SqlTokenType::LeftParen) {
+            depth++;
+        } else if (token.type == SqlTokenType::RightParen && depth > 0) {
+            depth--;
+        } else if (token.type == SqlTokenType::Semicolon && depth == 0) {
+            return;
+        }
+    }
+}
+
+static bool IsName(const SqlToken &token) {
+    return token.type == SqlTokenType::Identifier || token.type == SqlTokenType::QuotedIdentifier;
+}
+
+// Parses the statement after the INSERT keyword, returns false if it is not an INSERT ... VALUES
+static bool ScanInsertValues(SqlScanner &scanner, InsertValuesResult &result) {
+    SqlToken token;
+    if (!scanner.Next(token)) {
+        return false;
+    }
+    // INSERT OR REPLACE / INSERT OR IGNORE
+    if (scanner.IsKeyword(token, "or")) {
+        if (!scanner.Next(token) || !scanner.Next(token)) {
+            return false;
+        }
+    }
+    if (!scanner.IsKeyword(token, "into") || !scanner.Next(token) || !IsName(token)) {
+        return false;
+    }
+
+    // [catalog.][schema.]table
+    std::vector<std::string> parts {scanner.IdentifierName(token)};
+    bool have_token = scanner.Next(token);
+    while (have_token && scanner.IsSymbol(token, '.')) {
+        if (!scanner.Next(token) || !IsName(token)) {
+            return false;
+        }
+        parts.push_back(scanner.IdentifierName(token));
+        have_token = scanner.Next(token);
+    }
+    result.table = parts.back();
+    result.schema = parts.size() >= 2 ? parts[parts.size() - 2] : "main";
+
+    // optional alias
+    if (have_token && scanner.IsKeyword(token, "as")) {
+        if (!scanner.Next(token) || !scanner.Next(token)) {
+            return false;
+        }
+        have_token = true;
+    }
+
+    // optional column list
+    if (have_token && token.type == SqlTokenType::LeftParen) {
+        while (scanner.Next(token) && token.type != SqlTokenType::RightParen) {
+            if (IsName(token)) {
+                result.columns.push_back(scanner.IdentifierName(token));
+            } else if (token.type != SqlTokenType::Comma) {
+                return false;
+            }
+        }
+        have_token = scanner.Next(token);
+    }
+
+    if (!have_token || !scanner.IsKeyword(token, "values")) {
+        return false;
+    }
+    if (!scanner.Next(token) || token.type != SqlTokenType::LeftParen) {
+        return false;
+    }
+    do {
+        ParenthesizedList row;
+        if (!ScanParenthesizedList(scanner, row)) {
+            return false;
+        }
+        result.row_count++;
+        result.literal_count += row.literals;
+    } while (NextValuesRow(scanner));
+    return true;
+}
+
+void ExtractInsertValuesFromSQL(const std::string &sql, std::vector<InsertValuesResult> &results) {
+    SqlScanner scanner(sql);
+    SqlToken token;
+    while (scanner.Next(token)) {
+        if (token.type == SqlTokenType::Semicolon) {
+            continue;
+        }
+        if (scanner.IsKeyword(token, "insert")) {
+            InsertValuesResult result;
+            if (ScanInsertValues(scanner, result)) {
+                results.push_back(std::move(result));
+            }
+        }
+        SkipStatement(scanner);
+    }
+}
+
+} // namespace duckdb
@@ -0,0 +1,152 @@
+#include "parse_tables.hpp"
+#include "parser_tools_limits.hpp"
+#include "sql_scanner.hpp"
+#include "duckdb.hpp"
+#include "duckdb/parser/parser.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+#include "duckdb/parser/query_node/select_node.hpp"
+#include "duckdb/parser/tableref/basetableref.hpp"
+#include "duckdb/parser/tableref/joinref.hpp"
+#include "duckdb/parser/tableref/subqueryref.hpp"
+
+namespace duckdb {
+
+const char *ToString(TableContext context) {
+    switch (context) {
+        case TableContext::From: return "from";
+        case TableContext::JoinLeft: return "join_left";
+        case TableContext::JoinRight: return "join_right";
+        case TableContext::FromCTE: return "from_cte";
+        case TableContext::CTE: return "cte";
+        case TableContext::Subquery: return "subquery";
+        default: return "unknown";
+    }
+}
+
+const TableContext FromString(const char *context) {
+    if (strcmp(context, "from") == 0) return TableContext::From;
+    if (strcmp(context, "join_left") == 0) return TableContext::JoinLeft;
+    if (strcmp(context, "join_right") == 0) return TableContext::JoinRight;
+    if (strcmp(context, "from_cte") == 0) return TableContext::FromCTE;
+    if (strcmp(context, "cte") == 0) return TableContext::CTE;
+    if (strcmp(context, "subquery") == 0) return TableContext::Subquery;
+    throw InternalException("Unknown table context: %s", context);
+}
+
+static void ExtractTablesFromRef(
+    const duckdb::TableRef &ref,
+    std::vector<TableRefResult> &results,
+    const TableContext context = TableContext::From,
+    bool is_top_level = false,
+    const duckdb::CommonTableExpressionMap *cte_map = nullptr
+) {
+    using namespace duckdb;
+
+    if (!ExtractionBudget::Tick()) {
+        return;
+    }
+
+    switch (ref.type) {
+        case TableReferenceType::BASE_TABLE: {
+            auto &base = (BaseTableRef &)ref;
+            TableContext context_label = context;
+
+            if (cte_map && cte_map->map.find(base.table_name) != cte_map->map.end()) {
+                context_label = TableContext::FromCTE;
+            } else if (is_top_level) {
+                context_label = TableContext::From;
+            }
+
+            results.push_back(TableRefResult{
+                base.schema_name.empty() ? "main" : base.schema_name,
+                base.table_name,
+                context_label,
+                base.catalog_name,
+                base.schema_name
+            });
+            break;
+        }
+        case TableReferenceType::JOIN: {
+            auto &join = (JoinRef &)ref;
+            ExtractTablesFromRef(*join.left, results, TableContext::JoinLeft, is_top_level, cte_map);
+            ExtractTablesFromRef(*join.right, results, TableContext::JoinRight, false, cte_map);
+            break;
+        }
+        case TableReferenceType::SUBQUERY: {
+            auto &subquery = (SubqueryRef &)ref;
+            if (subquery.subquery && subquery.subquery->node) {
+                ExtractTablesFromQueryNode(*subquery.subquery->node, results, TableContext::Subquery, cte_map);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+
+void ExtractTablesFromQueryNode(
+    const duckdb::QueryNode &node,
+    std::vector<TableRefResult> &results,
+    const TableContext context,
+    const duckdb::CommonTableExpressionMap *cte_map
+) {
+    using namespace duckdb;
+
+    if (!ExtractionBudget::Tick()) {
+        return;
+    }
+
+    if (node.type == QueryNodeType::SELECT_NODE) {
+        auto &select_node = (SelectNode &)node;
+
+        // Emit CTE definitions
+        for (const auto &entry : select_node.cte_map.map) {
+            results.push_back(TableRefResult{
+                "", entry.first, TableContext::CTE
+            });
+
+            if (entry.second && entry.second->query && entry.second->query->node) {
+                ExtractTablesFromQueryNode(*entry.second->query->node, results, TableContext::From, &select_node.cte_map);
+            }
+        }
+
+        if (select_node.from_table) {
+            ExtractTablesFromRef(*select_node.from_table, results, context, true, &select_node.cte_map);
+        }
+    }
+}
+
+void ExtractTablesFromSQL(const std::string &sql, std::vector<TableRefResult> &results) {
+    if (!ExtractionBudget::AllowInput(sql)) {
+        return;
+    }
+
+    // bulk INSERT ... VALUES and long IN lists are compacted first, their literals reference nothing
+    std::string compacted;
+    bool use_compacted = sql.size() >= LITERAL_FAST_PATH_MIN_BYTES && CompactLiteralLists(sql, compacted);
+
+    Parser parser;
+
+    try {
+        parser.ParseQuery(use_compacted ? compacted : sql);
+    } catch (const ParserException &ex) {
+        // swallow parser exceptions to make this function more robust. is_parsable can be used if needed
+        return; 
+    }
+
+    if (!ExtractionBudget::CheckDeadline()) {
+        return;
+    }
+
+    for (auto &stmt : parser.statements) {
+        if (stmt->type == StatementType::SELECT_STATEMENT) {
+            auto &select_stmt = (SelectStatement &)*stmt;
+            if (select_stmt.node) {
+                ExtractTablesFromQueryNode(*select_stmt.node, results);
+            }
+        }
+    }
+}
+
+} // namespace duckdb
@@ -0,0 +1,513 @@
+#include "tolerant_extractor.hpp"
+#include "parser_tools_limits.hpp"
+#include "sql_scanner.hpp"
+#include "duckdb.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/parser/parser.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+#include <algorithm>
+#include <unordered_set>
+
+namespace duckdb {
+
+// Prefixes parsed per unparsable statement, each attempt costs a parse
+static constexpr idx_t MAX_PREFIX_ATTEMPTS = 8;
+
+static bool IsOneOf(const SqlScanner &scanner, const SqlToken &token, const char *const *keywords) {
+    for (auto keyword = keywords; *keyword; keyword++) {
+        if (scanner.IsKeyword(token, *keyword)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool IsName(const SqlToken &token) {
+    return token.type == SqlTokenType::Identifier || token.type == SqlTokenType::QuotedIdentifier;
+}
+
+static bool Peek(SqlScanner &scanner, SqlToken &token) {
+    auto position = scanner.Position();
+    auto found = scanner.Next(token);
+    scanner.Reset(position);
+    return found;
+}
+
+// Reads the rest of a dotted name whose first part was just read. Stops before anything that does
+// not continue the name, returns false if the name is cut off after a dot.
+static bool ReadQualifiedName(SqlScanner &scanner, std::vector<std::string> &parts) {
+    while (true) {
+        auto name_end = scanner.Position();
+        SqlToken token;
+        if (!scanner.Next(token) || !scanner.IsSymbol(token, '.')) {
+            scanner.Reset(name_end);
+            return true;
+        }
+        if (!scanner.Next(token) || !IsName(token)) {
+            return false;
+        }
+        parts.push_back(scanner.IdentifierName(token));
+    }
+}
+
+static bool StartsQuery(const SqlScanner &scanner, const SqlToken &token) {
+    return token.type == SqlTokenType::LeftParen || scanner.IsKeyword(token, "select") ||
+           scanner.IsKeyword(token, "with") || scanner.IsKeyword(token, "from");
+}
+
+// Statements
+// ---------------------------------------------------
+
+// Keywords that start a clause, the text before them can be a complete statement
+static const char *const CLAUSE_KEYWORDS[] = {
+    "where", "group", "having", "window", "qualify", "order", "limit", "offset", "union", "except", "intersect",
+    "join", "left", "right", "inner", "full", "cross", "natural", "positional", "asof", "anti", "semi", nullptr};
+
+static std::vector<std::string> SplitStatements(const std::string &sql) {
+    std::vector<std::string> statements;
+    StatementCursor cursor(sql);
+    std::string statement;
+    while (cursor.Next(statement)) {
+        statements.push_back(statement);
+    }
+    return statements;
+}
+
+// Only queries are extracted from, like the regular extractors do
+static bool IsQuery(const std::string &statement) {
+    SqlScanner scanner(statement);
+    SqlToken token;
+    return scanner.Next(token) && StartsQuery(scanner, token);
+}
+
+// Offsets at which a statement can be cut back to a shorter one that may parse, longest first
+static std::vector<idx_t> PrefixCandidates(const std::string &statement) {
+    std::vector<idx_t> candidates;
+    SqlScanner scanner(statement);
+    SqlToken token;
+    idx_t depth = 0;
+    while (scanner.Next(token)) {
+        if (token.type == SqlTokenType::LeftParen) {
+            depth++;
+        } else if (token.type == SqlTokenType::RightParen) {
+            depth = depth > 0 ? depth - 1 : 0;
+        } else if (depth == 0 && token.start > 0 &&
+                   (token.type == SqlTokenType::Comma || IsOneOf(scanner, token, CLAUSE_KEYWORDS))) {
+            candidates.push_back(token.start);
+        }
+    }
+    std::reverse(candidates.begin(), candidates.end());
+    return candidates;
+}
+
+template <class RESULT>
+static bool ParseAndExtract(const std::string &sql, std::vector<RESULT> &results,
+                            void (*extract)(const QueryNode &, std::vector<RESULT> &)) {
+    Parser parser;
+    try {
+        parser.ParseQuery(sql);
+    } catch (const ParserException &ex) {
+        return false;
+    }
+
+    for (auto &stmt : parser.statements) {
+        if (stmt->type == StatementType::SELECT_STATEMENT) {
+            auto &select_stmt = (SelectStatement &)*stmt;
+            if (select_stmt.node) {
+                extract(*select_stmt.node, results);
+            }
+        }
+    }
+    return true;
+}
+
+template <class RESULT>
+static void ExtractTolerant(const std::string &sql, std::vector<RESULT> &results, std::vector<bool> &exact,
+                            void (*extract)(const QueryNode &, std::vector<RESULT> &),
+                            void (*scan)(const std::string &, idx_t, std::vector<RESULT> &)) {
+    if (!ExtractionBudget::AllowInput(sql)) {
+        return;
+    }
+
+    // bulk INSERT ... VALUES and long IN lists are compacted first, their literals reference nothing
+    std::string compacted;
+    bool use_compacted = sql.size() >= LITERAL_FAST_PATH_MIN_BYTES && CompactLiteralLists(sql, compacted);
+    if (ParseAndExtract(use_compacted ? compacted : sql, results, extract)) {
+        exact.resize(results.size(), true);
+        return;
+    }
+
+    auto statements = SplitStatements(sql);
+    for (auto &statement : statements) {
+        if (!ExtractionBudget::CheckDeadline()) {
+            return;
+        }
+        if (statements.size() > 1 && ParseAndExtract(statement, results, extract)) {
+            exact.resize(results.size(), true);
+            continue;
+        }
+        if (!IsQuery(statement)) {
+            continue;
+        }
+
+        idx_t cut = 0;
+        idx_t attempts = 0;
+        for (auto candidate : PrefixCandidates(statement)) {
+            if (attempts++ == MAX_PREFIX_ATTEMPTS || !ExtractionBudget::CheckDeadline()) {
+                break;
+            }
+            if (ParseAndExtract(statement.substr(0, candidate), results, extract)) {
+                cut = candidate;
+                break;
+            }
+        }
+        scan(statement, cut, results);
+        exact.resize(results.size(), false);
+    }
+}
+
+// Table scan
+// ---------------------------------------------------
+
+// Words after a table name that are not its alias
+static const char *const NOT_ALIAS_KEYWORDS[] = {
+    "where", "group", "having", "window", "qualify", "order", "limit", "offset", "union", "except", "intersect",
+    "join", "left", "right", "inner", "outer", "full", "cross", "natural", "positional", "asof", "anti", "semi",
+    "on", "using", "tablesample", "pivot", "unpivot", "returning", "set", "values", "select", nullptr};
+
+enum class ScanParenKind {
+    Expression,
+    Query,
+    CTE // the body of a CTE definition
+};
+
+/**
+ * Finds FROM / JOIN targets in the token stream of a query. Parenthesized expressions are told
+ * apart from subqueries so that e.g. EXTRACT(year FROM ts) is not taken for a table.
+ */
+class TableTokenScanner {
+public:
+    TableTokenScanner(const std::string &statement, idx_t from, std::vector<TableRefResult> &results)
+        : scanner(statement), from(from), results(results) {
+    }
+
+    void Scan() {
+        SqlToken token;
+        bool cte_body = false;
+        while (scanner.Next(token)) {
+            if (!ExtractionBudget::Tick()) {
+                return;
+            }
+            switch (token.type) {
+                case SqlTokenType::LeftParen: {
+                    SqlToken next;
+                    if (cte_body) {
+                        parens.push_back(ScanParenKind::CTE);
+                    } else if (Peek(scanner, next) && StartsQuery(scanner, next) &&
+                               next.type != SqlTokenType::LeftParen) {
+                        parens.push_back(ScanParenKind::Query);
+                    } else {
+                        parens.push_back(ScanParenKind::Expression);
+                    }
+                    cte_body = false;
+                    break;
+                }
+                case SqlTokenType::RightParen:
+                    if (!parens.empty()) {
+                        parens.pop_back();
+                    }
+                    break;
+                case SqlTokenType::Identifier:
+                case SqlTokenType::QuotedIdentifier:
+                    if (!parens.empty() && parens.back() == ScanParenKind::Expression) {
+                        break;
+                    }
+                    if (scanner.IsKeyword(token, "from")) {
+                        ReadTableList(TableContext::From);
+                    } else if (scanner.IsKeyword(token, "join")) {
+                        ReadTableList(TableContext::JoinRight);
+                    } else if (IsCTEDefinition()) {
+                        auto name = scanner.IdentifierName(token);
+                        cte_names.insert(StringUtil::Lower(name));
+                        if (token.start >= from) {
+                            results.push_back(TableRefResult{"", name, TableContext::CTE, "", ""});
+                        }
+                        cte_body = true;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+private:
+    // name AS (, name AS MATERIALIZED ( or name AS NOT MATERIALIZED (
+    bool IsCTEDefinition() {
+        auto position = scanner.Position();
+        SqlToken token;
+        bool result = scanner.Next(token) && scanner.IsKeyword(token, "as") && scanner.Next(token);
+        if (result && scanner.IsKeyword(token, "not")) {
+            result = scanner.Next(token);
+        }
+        if (result && scanner.IsKeyword(token, "materialized")) {
+            result = scanner.Next(token);
+        }
+        result = result && token.type == SqlTokenType::LeftParen;
+        scanner.Reset(position);
+        return result;
+    }
+
+    void ReadTableList(TableContext context) {
+        while (true) {
+            auto position = scanner.Position();
+            SqlToken first;
+            if (!scanner.Next(first)) {
+                return;
+            }
+            if (scanner.IsKeyword(first, "lateral")) {
+                continue;
+            }
+            if (!IsName(first)) {
+                // a subquery or VALUES list, read by Scan
+                scanner.Reset(position);
+                return;
+            }
+            std::vector<std::string> parts {scanner.IdentifierName(first)};
+            if (!ReadQualifiedName(scanner, parts)) {
+                return;
+            }
+            SqlToken next;
+            if (Peek(scanner, next) && next.type == SqlTokenType::LeftParen) {
+                // a table function
+                return;
+            }
+            AddTable(parts, first.start, context);
+
+            // the alias
+            if (Peek(scanner, next) && scanner.IsKeyword(next, "as")) {
+                scanner.Next(next);
+                scanner.Next(next);
+            } else if (Peek(scanner, next) && IsName(next) && !IsOneOf(scanner, next, NOT_ALIAS_KEYWORDS)) {
+                scanner.Next(next);
+            }
+            if (context != TableContext::From || !Peek(scanner, next) || next.type != SqlTokenType::Comma) {
+                return;
+            }
+            scanner.Next(next);
+        }
+    }
+
+    void AddTable(const std::vector<std::string> &parts, idx_t start, TableContext context) {
+        if (start < from) {
+            return;
+        }
+        auto &table = parts.back();
+        auto schema_name = parts.size() >= 2 ? parts[parts.size() - 2] : "";
+        auto catalog_name = parts.size() >= 3 ? parts[parts.size() - 3] : "";
+        if (parts.size() == 1 && cte_names.count(StringUtil::Lower(table))) {
+            context = TableContext::FromCTE;
+        } else if (!parens.empty() && parens.back() == ScanParenKind::Query) {
+            context = TableContext::Subquery;
+        }
+        results.push_back(TableRefResult{schema_name.empty() ? "main" : schema_name, table, context, catalog_name,
+                                         schema_name});
+    }
+
+    SqlScanner scanner;
+    idx_t from;
+    std::vector<TableRefResult> &results;
+    std::vector<ScanParenKind> parens;
+    std::unordered_set<std::string> cte_names;
+};
+
+static void ScanTables(const std::string &statement, idx_t from, std::vector<TableRefResult> &results) {
+    TableTokenScanner scanner(statement, from, results);
+    scanner.Scan();
+}
+
+static void ExtractTablesFromNode(const QueryNode &node, std::vector<TableRefResult> &results) {
+    ExtractTablesFromQueryNode(node, results);
+}
+
+void ExtractTablesFromSQLTolerant(const std::string &sql, std::vector<TableRefResult> &results,
+                                  std::vector<bool> &exact) {
+    ExtractTolerant<TableRefResult>(sql, results, exact, ExtractTablesFromNode, ScanTables);
+}
+
+// Function scan
+// ---------------------------------------------------
+
+// Words that are followed by a parenthesis without being a function call
+static const char *const NOT_FUNCTION_KEYWORDS[] = {
+    "in", "exists", "values", "as", "over", "filter", "within", "any", "all", "some", "using", "on", "and", "or",
+    "not", "select", "from", "where", "join", "into", "table", "cast", "try_cast", "case", "when", "then", "else",
+    "interval", "distinct", "window", "partition", "by", "rollup", "cube", "sets", "lateral", "with", "recursive",
+    "materialized", "is", "between", "like", "ilike", "union", "except", "intersect", "limit", "offset", "qualify",
+    "group", "having", "order", "array", "columns", "exclude", "replace", "rename", "tablesample", "sample",
+    "pivot", "unpivot", "returning", "set", "coalesce", nullptr};
+
+enum class CallParenKind {
+    Expression,
+    Query,
+    Call // the arguments of a call, or the specification of OVER, FILTER and WITHIN GROUP
+};
+
+struct CallParen {
+    CallParenKind kind;
+    std::string outer_clause; // restored when a subquery ends
+};
+
+/**
+ * Finds function calls in the token stream of a query, with the clause they are in. Calls inside
+ * the arguments of another call are nested, calls in the FROM clause are table functions and are
+ * skipped like the regular extractor does.
+ */
+class FunctionTokenScanner {
+public:
+    FunctionTokenScanner(const std::string &statement, idx_t from, std::vector<FunctionResult> &results)
+        : statement(statement), scanner(statement), from(from), results(results) {
+    }
+
+    void Scan() {
+        SqlToken token;
+        SqlToken previous;
+        bool has_previous = false;
+        bool call_follows = false;
+        while (scanner.Next(token)) {
+            if (!ExtractionBudget::Tick()) {
+                return;
+            }
+            bool is_call = call_follows;
+            call_follows = false;
+            switch (token.type) {
+                case SqlTokenType::LeftParen: {
+                    SqlToken next;
+                    CallParen paren {CallParenKind::Expression, clause};
+                    if (is_call) {
+                        paren.kind = CallParenKind::Call;
+                    } else if (Peek(scanner, next) && StartsQuery(scanner, next) &&
+                               next.type != SqlTokenType::LeftParen) {
+                        paren.kind = CallParenKind::Query;
+                        clause = "";
+                    }
+                    parens.push_back(paren);
+                    break;
+                }
+                case SqlTokenType::RightParen:
+                    if (!parens.empty()) {
+                        if (parens.back().kind == CallParenKind::Query) {
+                            clause = parens.back().outer_clause;
+                        }
+                        parens.pop_back();
+                    }
+                    break;
+                case SqlTokenType::Identifier:
+                case SqlTokenType::QuotedIdentifier:
+                    if (scanner.IsKeyword(token, "over") || scanner.IsKeyword(token, "filter") ||
+                        (scanner.IsKeyword(token, "group") && has_previous && scanner.IsKeyword(previous, "within"))) {
+                        call_follows = true;
+                    } else if (!Nested() && UpdateClause(token)) {
+                        break;
+                    } else if (!(has_previous && PrecedesNonCall(previous))) {
+                        call_follows = ReadCall(token);
+                    }
+                    break;
+                default:
+                    break;
+            }
+            previous = token;
+            has_previous = true;
+        }
+    }
+
+private:
+    bool Nested() const {
+        for (auto it = parens.rbegin(); it != parens.rend(); ++it) {
+            if (it->kind == CallParenKind::Call) {
+                return true;
+            }
+            if (it->kind == CallParenKind::Query) {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    // Clause keywords of the current query, returns false if the token is none
+    bool UpdateClause(const SqlToken &token) {
+        SqlToken next;
+        if (scanner.IsKeyword(token, "select")) {
+            clause = "select";
+        } else if (scanner.IsKeyword(token, "where")) {
+            clause = "where";
+        } else if (scanner.IsKeyword(token, "having")) {
+            clause = "having";
+        } else if (scanner.IsKeyword(token, "on")) {
+            clause = "join";
+        } else if (scanner.IsKeyword(token, "group") && Peek(scanner, next) && scanner.IsKeyword(next, "by")) {
+            clause = "group_by";
+        } else if (scanner.IsKeyword(token, "order") && Peek(scanner, next) && scanner.IsKeyword(next, "by")) {
+            clause = "order_by";
+        } else if (IsOneOf(scanner, token, CLAUSE_KEYWORDS) || scanner.IsKeyword(token, "from") ||
+                   scanner.IsKeyword(token, "using") || scanner.IsKeyword(token, "values")) {
+            // no functions are reported from these
+            clause = "";
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    // Table functions, casts to types with parameters (DECIMAL(18, 3)) and star modifiers (* REPLACE (...))
+    bool PrecedesNonCall(const SqlToken &previous) const {
+        if (scanner.IsKeyword(previous, "from") || scanner.IsKeyword(previous, "join") ||
+            scanner.IsKeyword(previous, "as") || scanner.IsKeyword(previous, "into") ||
+            scanner.IsKeyword(previous, "table") || scanner.IsSymbol(previous, '*')) {
+            return true;
+        }
+        return previous.type == SqlTokenType::Operator && previous.length == 2 &&
+               statement.compare(previous.start, 2, "::") == 0;
+    }
+
+    // Records the call if the name is followed by a parenthesis, returns whether it was
+    bool ReadCall(const SqlToken &first) {
+        if (IsOneOf(scanner, first, NOT_FUNCTION_KEYWORDS)) {
+            return false;
+        }
+        auto name_end = scanner.Position();
+        std::vector<std::string> parts {scanner.IdentifierName(first)};
+        SqlToken next;
+        if (!ReadQualifiedName(scanner, parts) || !Peek(scanner, next) || next.type != SqlTokenType::LeftParen) {
+            scanner.Reset(name_end);
+            return false;
+        }
+        if (first.start >= from && !clause.empty()) {
+            auto schema_name = parts.size() >= 2 ? parts[parts.size() - 2] : "";
+            auto catalog_name = parts.size() >= 3 ? parts[parts.size() - 3] : "";
+            results.push_back(FunctionResult{StringUtil::Lower(parts.back()),
+                                             schema_name.empty() ? "main" : schema_name,
+                                             Nested() ? "nested" : clause, catalog_name, schema_name});
+        }
+        return true;
+    }
+
+    const std::string &statement;
+    SqlScanner scanner;
+    idx_t from;
+    std::vector<FunctionResult> &results;
+    std::vector<CallParen> parens;
+    std::string clause;
+};
+
+static void ScanFunctions(const std::string &statement, idx_t from, std::vector<FunctionResult> &results) {
+    FunctionTokenScanner scanner(statement, from, results);
+    scanner.Scan();
+}
+
+void ExtractFunctionsFromSQLTolerant(const std::string &sql, std::vector<FunctionResult> &results,
+                                     std::vector<bool> &exact) {
+    ExtractTolerant<FunctionResult>(sql, results, exact, ExtractFunctionsFromQueryNode, ScanFunctions);
+}
+
+} // namespace duckdb
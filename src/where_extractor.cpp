@@ -0,0 +1,329 @@
+#include "parse_where.hpp"
+#include "from_scope.hpp"
+#include "parser_tools_limits.hpp"
+#include "duckdb.hpp"
+#include "duckdb/parser/parser.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+#include "duckdb/parser/query_node/select_node.hpp"
+#include "duckdb/parser/expression/columnref_expression.hpp"
+#include "duckdb/parser/expression/comparison_expression.hpp"
+#include "duckdb/parser/expression/conjunction_expression.hpp"
+#include "duckdb/parser/expression/constant_expression.hpp"
+#include "duckdb/parser/expression/function_expression.hpp"
+#include "duckdb/parser/expression/operator_expression.hpp"
+#include "duckdb/parser/expression/star_expression.hpp"
+#include "duckdb/parser/expression/subquery_expression.hpp"
+#include "duckdb/parser/expression/window_expression.hpp"
+#include "duckdb/parser/expression/case_expression.hpp"
+#include "duckdb/parser/expression/cast_expression.hpp"
+#include "duckdb/parser/expression/between_expression.hpp"
+#include "duckdb/parser/expression/lambda_expression.hpp"
+#include "duckdb/parser/expression/positional_reference_expression.hpp"
+#include "duckdb/parser/expression/parameter_expression.hpp"
+#include "duckdb/parser/tableref/basetableref.hpp"
+
+namespace duckdb {
+
+static string ExpressionToString(const ParsedExpression &expr) {
+    return expr.ToString();
+}
+
+static void ExtractWhereConditionsFromExpression(
+    const ParsedExpression &expr,
+    vector<WhereConditionResult> &results,
+    const string &context,
+    const FromScope &scope
+) {
+    if (expr.type == ExpressionType::INVALID) return;
+    if (!ExtractionBudget::Tick()) return;
+
+    switch (expr.GetExpressionClass()) {
+        case ExpressionClass::CONJUNCTION: {
+            auto &conj = (ConjunctionExpression &)expr;
+            for (auto &child : conj.children) {
+                ExtractWhereConditionsFromExpression(*child, results, context, scope);
+            }
+            break;
+        }
+        case ExpressionClass::COMPARISON: {
+            auto &comp = (ComparisonExpression &)expr;
+            results.push_back(WhereConditionResult{
+                ExpressionToString(comp),
+                scope.Attribute(expr),
+                context
+            });
+            break;
+        }
+        case ExpressionClass::OPERATOR: {
+            auto &op = (OperatorExpression &)expr;
+            results.push_back(WhereConditionResult{
+                ExpressionToString(op),
+                scope.Attribute(expr),
+                context
+            });
+            break;
+        }
+        case ExpressionClass::FUNCTION: {
+            auto &func = (FunctionExpression &)expr;
+            results.push_back(WhereConditionResult{
+                ExpressionToString(func),
+                scope.Attribute(expr),
+                context
+            });
+            break;
+        }
+        case ExpressionClass::BETWEEN: {
+            auto &between = (BetweenExpression &)expr;
+            results.push_back(WhereConditionResult{
+                ExpressionToString(between),
+                scope.Attribute(expr),
+                context
+            });
+            break;
+        }
+        case ExpressionClass::CASE: {
+            auto &case_expr = (CaseExpression &)expr;
+            results.push_back(WhereConditionResult{
+                ExpressionToString(case_expr),
+                scope.Attribute(expr),
+                context
+            });
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void ExtractWhereConditionsFromQueryNode(
+    const QueryNode &node,
+    vector<WhereConditionResult> &results
+) {
+    if (node.type == QueryNodeType::SELECT_NODE) {
+        auto &select_node = (SelectNode &)node;
+
+        // Conditions are attributed to tables through the aliases of the FROM clause
+        FromScope scope(select_node, {});
+
+        // Extract WHERE conditions
+        if (select_node.where_clause) {
+            ExtractWhereConditionsFromExpression(*select_node.where_clause, results, "WHERE", scope);
+        }
+
+        // Extract HAVING conditions
+        if (select_node.having) {
+            ExtractWhereConditionsFromExpression(*select_node.having, results, "HAVING", scope);
+        }
+    }
+}
+
+void ExtractWhereConditionsFromSQL(const string &sql, vector<WhereConditionResult> &results) {
+    if (!ExtractionBudget::AllowInput(sql)) {
+        return;
+    }
+
+    Parser parser;
+
+    try {
+        parser.ParseQuery(sql);
+    } catch (const ParserException &ex) {
+        return;
+    }
+
+    if (!ExtractionBudget::CheckDeadline()) {
+        return;
+    }
+
+    for (auto &stmt : parser.statements) {
+        if (stmt->type == StatementType::SELECT_STATEMENT) {
+            auto &select_stmt = (SelectStatement &)*stmt;
+            if (select_stmt.node) {
+                ExtractWhereConditionsFromQueryNode(*select_stmt.node, results);
+            }
+        }
+    }
+}
+
+static string DetailedExpressionTypeToOperator(ExpressionType type) {
+    switch (type) {
+        case ExpressionType::COMPARE_EQUAL:
+            return "=";
+        case ExpressionType::COMPARE_NOTEQUAL:
+            return "!=";
+        case ExpressionType::COMPARE_LESSTHAN:
+            return "<";
+        case ExpressionType::COMPARE_GREATERTHAN:
+            return ">";
+        case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+            return "<=";
+        case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+            return ">=";
+        case ExpressionType::COMPARE_DISTINCT_FROM:
+            return "IS DISTINCT FROM";
+        case ExpressionType::COMPARE_NOT_DISTINCT_FROM:
+            return "IS NOT DISTINCT FROM";
+        default:
+            return "UNKNOWN";
+    }
+}
+
+static void ExtractDetailedWhereConditionsFromExpression(
+    const ParsedExpression &expr,
+    vector<DetailedWhereConditionResult> &results,
+    const string &context,
+    const FromScope &scope
+) {
+    if (expr.type == ExpressionType::INVALID) return;
+    if (!ExtractionBudget::Tick()) return;
+
+    switch (expr.GetExpressionClass()) {
+        case ExpressionClass::CONJUNCTION: {
+            auto &conj = (ConjunctionExpression &)expr;
+            for (auto &child : conj.children) {
+                ExtractDetailedWhereConditionsFromExpression(*child, results, context, scope);
+            }
+            break;
+        }
+        case ExpressionClass::COMPARISON: {
+            auto &comp = (ComparisonExpression &)expr;
+            DetailedWhereConditionResult result;
+            result.context = context;
+            result.table_name = scope.Attribute(comp);
+            
+            // Extract column name
+            if (comp.left->GetExpressionClass() == ExpressionClass::COLUMN_REF) {
+                auto &col_ref = (ColumnRefExpression &)*comp.left;
+                result.column_name = col_ref.GetColumnName();
+            }
+            
+            // Extract operator
+            result.operator_type = DetailedExpressionTypeToOperator(comp.type);
+            
+            // Extract value
+            if (comp.right->GetExpressionClass() == ExpressionClass::CONSTANT) {
+                auto &const_expr = (ConstantExpression &)*comp.right;
+                result.value = const_expr.value.ToString();
+                result.is_constant = true;
+            } else {
+                result.value = comp.right->ToString();
+            }
+            
+            results.push_back(result);
+            break;
+        }
+        case ExpressionClass::BETWEEN: {
+            auto &between = (BetweenExpression &)expr;
+            DetailedWhereConditionResult result;
+            result.context = context;
+            result.table_name = scope.Attribute(between);
+            
+            // Extract column name
+            if (between.input->GetExpressionClass() == ExpressionClass::COLUMN_REF) {
+                auto &col_ref = (ColumnRefExpression &)*between.input;
+                result.column_name = col_ref.GetColumnName();
+            }
+            
+            // For BETWEEN, we'll create two conditions: >= lower AND <= upper
+            result.operator_type = ">=";
+            if (between.lower->GetExpressionClass() == ExpressionClass::CONSTANT) {
+                auto &const_expr = (ConstantExpression &)*between.lower;
+                result.value = const_expr.value.ToString();
+                result.is_constant = true;
+            } else {
+                result.value = between.lower->ToString();
+            }
+            results.push_back(result);
+            
+            // Add the upper bound condition
+            DetailedWhereConditionResult upper_result = result;
+            upper_result.operator_type = "<=";
+            if (between.upper->GetExpressionClass() == ExpressionClass::CONSTANT) {
+                auto &const_expr = (ConstantExpression &)*between.upper;
+                upper_result.value = const_expr.value.ToString();
+                upper_result.is_constant = true;
+            } else {
+                upper_result.value = between.upper->ToString();
+                upper_result.is_constant = false;
+            }
+            results.push_back(upper_result);
+            break;
+        }
+        case ExpressionClass::OPERATOR: {
+            auto &op = (OperatorExpression &)expr;
+            if (op.children.size() >= 2) {
+                DetailedWhereConditionResult result;
+                result.context = context;
+                result.table_name = scope.Attribute(op);
+                
+                // Extract column name
+                if (op.children[0]->GetExpressionClass() == ExpressionClass::COLUMN_REF) {
+                    auto &col_ref = (ColumnRefExpression &)*op.children[0];
+                    result.column_name = col_ref.GetColumnName();
+                }
+                
+                // Extract operator
+                result.operator_type = DetailedExpressionTypeToOperator(op.type);
+                
+                // Extract value
+                if (op.children[1]->GetExpressionClass() == ExpressionClass::CONSTANT) {
+                    auto &const_expr = (ConstantExpression &)*op.children[1];
+                    result.value = const_expr.value.ToString();
+                    result.is_constant = true;
+                } else {
+                    result.value = op.children[1]->ToString();
+                }
+                
+                results.push_back(result);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void ExtractDetailedWhereConditionsFromQueryNode(
+    const QueryNode &node,
+    vector<DetailedWhereConditionResult> &results
+) {
+    if (node.type == QueryNodeType::SELECT_NODE) {
+        auto &select_node = (SelectNode &)node;
+        FromScope scope(select_node, {});
+
+        if (select_node.where_clause) {
+            ExtractDetailedWhereConditionsFromExpression(*select_node.where_clause, results, "WHERE", scope);
+        }
+        if (select_node.having) {
+            ExtractDetailedWhereConditionsFromExpression(*select_node.having, results, "HAVING", scope);
+        }
+    }
+}
+
+void ExtractDetailedWhereConditionsFromSQL(const string &sql, vector<DetailedWhereConditionResult> &results) {
+    if (!ExtractionBudget::AllowInput(sql)) {
+        return;
+    }
+
+    Parser parser;
+
+    try {
+        parser.ParseQuery(sql);
+    } catch (const ParserException &ex) {
+        return;
+    }
+
+    if (!ExtractionBudget::CheckDeadline()) {
+        return;
+    }
+
+    for (auto &stmt : parser.statements) {
+        if (stmt->type == StatementType::SELECT_STATEMENT) {
+            auto &select_stmt = (SelectStatement &)*stmt;
+            if (select_stmt.node) {
+                ExtractDetailedWhereConditionsFromQueryNode(*select_stmt.node, results);
+            }
+        }
+    }
+}
+
+} // namespace duckdb